@@ -2048,6 +2048,7 @@ public static class bgfx
 			public uint32 minResourceCbSize;
 			public uint32 transientVbSize;
 			public uint32 transientIbSize;
+			public uint8 numFrames;
 		}
 	
 		public RendererType type;
@@ -2101,6 +2102,14 @@ public static class bgfx
 		public VertexBufferHandle handle;
 	}
 	
+	[CRepr]
+	public struct TopologySortScratch
+	{
+		public void* data;
+		public uint32 size;
+		public uint32 num;
+	}
+	
 	[CRepr]
 	public struct TextureInfo
 	{
@@ -2165,6 +2174,7 @@ public static class bgfx
 		public int64 cpuTimeFrame;
 		public int64 cpuTimeBegin;
 		public int64 cpuTimeEnd;
+		public int64 cpuTimeSort;
 		public int64 cpuTimerFreq;
 		public int64 gpuTimeBegin;
 		public int64 gpuTimeEnd;
@@ -2190,6 +2200,12 @@ public static class bgfx
 		public int64 rtMemoryUsed;
 		public int transientVbUsed;
 		public int transientIbUsed;
+		public int64 dynamicVbUsed;
+		public int64 dynamicVbPeak;
+		public int64 dynamicIbUsed;
+		public int64 dynamicIbPeak;
+		public float dynamicVbFragmentation;
+		public float dynamicIbFragmentation;
 		public uint32[5] numPrims;
 		public int64 gpuMemoryMax;
 		public int64 gpuMemoryUsed;
@@ -2271,6 +2287,12 @@ public static class bgfx
 	    public bool Valid => idx != uint16.MaxValue;
 	}
 	
+	[CRepr]
+	public struct UniformGroupHandle {
+	    public uint16 idx;
+	    public bool Valid => idx != uint16.MaxValue;
+	}
+	
 	[CRepr]
 	public struct UniformHandle {
 	    public uint16 idx;
@@ -2447,6 +2469,40 @@ public static class bgfx
 	[LinkName("bgfx_topology_sort_tri_list")]
 	public static extern void topology_sort_tri_list(TopologySort _sort, void* _dst, uint32 _dstSize, float _dir, float _pos, void* _vertices, uint32 _stride, void* _indices, uint32 _numIndices, bool _index32);
 	
+	/// <summary>
+	/// Sort indices, reusing caller owned scratch memory between calls.
+	/// @remarks
+	///   Keys are computed in previous call's triangle order. When camera
+	///   moved only slightly they are nearly sorted, and are sorted
+	///   incrementally with insertion sort. If too many triangles move, it
+	///   falls back to radix sort.
+	/// </summary>
+	///
+	/// <param name="_sort">Sort order, see `TopologySort::Enum`.</param>
+	/// <param name="_dst">Destination index buffer.</param>
+	/// <param name="_dstSize">Destination index buffer in bytes.</param>
+	/// <param name="_dir">Direction (vector must be normalized).</param>
+	/// <param name="_pos">Position.</param>
+	/// <param name="_vertices">Pointer to first vertex represented as float x, y, z.</param>
+	/// <param name="_stride">Vertex stride.</param>
+	/// <param name="_indices">Source indices, must be the same between calls for previous order to be meaningful.</param>
+	/// <param name="_numIndices">Number of input indices.</param>
+	/// <param name="_index32">Set to `true` if input indices are 32-bit.</param>
+	/// <param name="_scratch">Scratch memory. If it's too small, temporary memory is allocated, and previous order is discarded.</param>
+	///
+	[LinkName("bgfx_topology_sort_tri_list_scratch")]
+	public static extern void topology_sort_tri_list_scratch(TopologySort _sort, void* _dst, uint32 _dstSize, float _dir, float _pos, void* _vertices, uint32 _stride, void* _indices, uint32 _numIndices, bool _index32, TopologySortScratch* _scratch);
+	
+	/// <summary>
+	/// Returns scratch memory size in bytes required to sort `_numIndices`
+	///   indices with `bgfx::topologySortTriList`.
+	/// </summary>
+	///
+	/// <param name="_numIndices">Number of input indices.</param>
+	///
+	[LinkName("bgfx_topology_sort_tri_list_scratch_size")]
+	public static extern uint32 topology_sort_tri_list_scratch_size(uint32 _numIndices);
+	
 	/// <summary>
 	/// Returns supported backend API renderers.
 	/// </summary>
@@ -2916,6 +2972,19 @@ public static class bgfx
 	[LinkName("bgfx_create_shader")]
 	public static extern ShaderHandle create_shader(Memory* _mem);
 	
+	/// <summary>
+	/// Create shader from memory buffer, selecting variant by key when buffer
+	/// contains shader variants.
+	/// @remarks
+	///   `createShader(_mem)` with shader variants binary selects variant 0.
+	/// </summary>
+	///
+	/// <param name="_mem">Shader binary, or shader variants binary built by shaderc from source with `$variant <name> [count]` declarations.</param>
+	/// <param name="_variantKey">Variant key. Axis values are packed as bit fields in declaration order, starting from least significant bit, each axis taking as many bits as its largest value needs. Bits of axes not declared by shader are ignored. Ignored for regular shader binary.</param>
+	///
+	[LinkName("bgfx_create_shader_variant")]
+	public static extern ShaderHandle create_shader_variant(Memory* _mem, uint32 _variantKey);
+	
 	/// <summary>
 	/// Returns the number of uniforms and uniform handles used inside a shader.
 	/// @remarks
@@ -2972,6 +3041,20 @@ public static class bgfx
 	[LinkName("bgfx_create_compute_program")]
 	public static extern ProgramHandle create_compute_program(ShaderHandle _csh, bool _destroyShaders);
 	
+	/// <summary>
+	/// Create program with vertex and fragment shader variants selected by key.
+	/// @remarks
+	///   Shaders and programs are deduplicated, creating program with the same
+	///   key again returns the same handle. Destroy it once per create call.
+	/// </summary>
+	///
+	/// <param name="_vsMem">Vertex shader binary, or shader variants binary.</param>
+	/// <param name="_fsMem">Fragment shader binary, or shader variants binary.</param>
+	/// <param name="_variantKey">Variant key, applied to both shaders. See `createShader(const Memory*, uint32_t)`. Axes used by both shaders must be declared first, and in the same order.</param>
+	///
+	[LinkName("bgfx_create_program_variant")]
+	public static extern ProgramHandle create_program_variant(Memory* _vsMem, Memory* _fsMem, uint32 _variantKey);
+	
 	/// <summary>
 	/// Destroy program.
 	/// </summary>
@@ -2981,6 +3064,21 @@ public static class bgfx
 	[LinkName("bgfx_destroy_program")]
 	public static extern void destroy_program(ProgramHandle _handle);
 	
+	/// <summary>
+	/// Returns true when program is done compiling and linking. Draw and compute calls
+	/// using program which is not ready are skipped by renderer.
+	/// @remarks
+	///   Only OpenGL renderer built with `BGFX_CONFIG_RENDERER_OPENGL_ASYNC_PROGRAM`
+	///   creates programs asynchronously, other renderers report program ready once
+	///   it's created on render thread. Result is delayed by number of frames in flight.
+	///   Program that failed to link never becomes ready.
+	/// </summary>
+	///
+	/// <param name="_handle">Program handle.</param>
+	///
+	[LinkName("bgfx_is_program_ready")]
+	public static extern bool is_program_ready(ProgramHandle _handle);
+	
 	/// <summary>
 	/// Validate texture parameters.
 	/// </summary>
@@ -3333,6 +3431,36 @@ public static class bgfx
 	[LinkName("bgfx_destroy_uniform")]
 	public static extern void destroy_uniform(UniformHandle _handle);
 	
+	/// <summary>
+	/// Create uniform group. Uniform group holds values of `UniformSet::Group`
+	/// uniforms, which persist across frames and are sent to renderer only
+	/// when group is updated.
+	/// </summary>
+	///
+	[LinkName("bgfx_create_uniform_group")]
+	public static extern UniformGroupHandle create_uniform_group();
+	
+	/// <summary>
+	/// Update value of uniform stored in uniform group.
+	/// </summary>
+	///
+	/// <param name="_handle">Uniform group handle.</param>
+	/// <param name="_uniform">Uniform, created with `UniformSet::Group` frequency.</param>
+	/// <param name="_value">Pointer to uniform data.</param>
+	/// <param name="_num">Number of elements. Passing `UINT16_MAX` will use the _num passed on uniform creation.</param>
+	///
+	[LinkName("bgfx_update_uniform_group")]
+	public static extern void update_uniform_group(UniformGroupHandle _handle, UniformHandle _uniform, void* _value, uint16 _num);
+	
+	/// <summary>
+	/// Destroy uniform group.
+	/// </summary>
+	///
+	/// <param name="_handle">Uniform group handle.</param>
+	///
+	[LinkName("bgfx_destroy_uniform_group")]
+	public static extern void destroy_uniform_group(UniformGroupHandle _handle);
+	
 	/// <summary>
 	/// Create occlusion query.
 	/// </summary>
@@ -3572,6 +3700,17 @@ public static class bgfx
 	[LinkName("bgfx_encoder_set_state")]
 	public static extern void encoder_set_state(Encoder* _this, uint64 _state, uint32 _rgba);
 	
+	/// <summary>
+	/// Set uniform group for draw primitive. Values of `UniformSet::Group`
+	/// uniforms stored in group are applied when group changes between
+	/// draw calls.
+	/// </summary>
+	///
+	/// <param name="_handle">Uniform group handle.</param>
+	///
+	[LinkName("bgfx_encoder_set_group")]
+	public static extern void encoder_set_group(Encoder* _this, UniformGroupHandle _handle);
+	
 	/// <summary>
 	/// Set condition for rendering.
 	/// </summary>
@@ -3811,6 +3950,51 @@ public static class bgfx
 	[LinkName("bgfx_encoder_set_instance_count")]
 	public static extern void encoder_set_instance_count(Encoder* _this, uint32 _numInstances);
 	
+	/// <summary>
+	/// Allocate transient index buffer from encoder's transient page.
+	/// @remarks
+	///   Unlike `bgfx::allocTransientIndexBuffer` this doesn't take API lock.
+	///   Encoder reserves large pages from frame's transient index buffer,
+	///   and returns unused part of page at `bgfx::end`.
+	/// </summary>
+	///
+	/// <param name="_tib">TransientIndexBuffer structure is filled and is valid for the duration of frame, and it can be reused for multiple draw calls.</param>
+	/// <param name="_num">Number of indices to allocate.</param>
+	/// <param name="_index32">Set to `true` if input indices will be 32-bit.</param>
+	///
+	[LinkName("bgfx_encoder_alloc_transient_index_buffer")]
+	public static extern void encoder_alloc_transient_index_buffer(Encoder* _this, TransientIndexBuffer* _tib, uint32 _num, bool _index32);
+	
+	/// <summary>
+	/// Allocate transient vertex buffer from encoder's transient page.
+	/// @remarks
+	///   Unlike `bgfx::allocTransientVertexBuffer` this doesn't take API lock,
+	///   except first time vertex layout is used by encoder in frame.
+	/// </summary>
+	///
+	/// <param name="_tvb">TransientVertexBuffer structure is filled and is valid for the duration of frame, and it can be reused for multiple draw calls.</param>
+	/// <param name="_num">Number of vertices to allocate.</param>
+	/// <param name="_layout">Vertex layout.</param>
+	///
+	[LinkName("bgfx_encoder_alloc_transient_vertex_buffer")]
+	public static extern void encoder_alloc_transient_vertex_buffer(Encoder* _this, TransientVertexBuffer* _tvb, uint32 _num, VertexLayout* _layout);
+	
+	/// <summary>
+	/// Check for required space and allocate transient vertex and index
+	/// buffers from encoder's transient pages. If both space requirements
+	/// are satisfied function returns true.
+	/// </summary>
+	///
+	/// <param name="_tvb">TransientVertexBuffer structure is filled and is valid for the duration of frame.</param>
+	/// <param name="_layout">Vertex layout.</param>
+	/// <param name="_numVertices">Number of vertices to allocate.</param>
+	/// <param name="_tib">TransientIndexBuffer structure is filled and is valid for the duration of frame.</param>
+	/// <param name="_numIndices">Number of indices to allocate.</param>
+	/// <param name="_index32">Set to `true` if input indices will be 32-bit.</param>
+	///
+	[LinkName("bgfx_encoder_alloc_transient_buffers")]
+	public static extern bool encoder_alloc_transient_buffers(Encoder* _this, TransientVertexBuffer* _tvb, VertexLayout* _layout, uint32 _numVertices, TransientIndexBuffer* _tib, uint32 _numIndices, bool _index32);
+	
 	/// <summary>
 	/// Set texture stage for draw primitive.
 	/// </summary>
@@ -4120,6 +4304,17 @@ public static class bgfx
 	[LinkName("bgfx_set_state")]
 	public static extern void set_state(uint64 _state, uint32 _rgba);
 	
+	/// <summary>
+	/// Set uniform group for draw primitive. Values of `UniformSet::Group`
+	/// uniforms stored in group are applied when group changes between
+	/// draw calls.
+	/// </summary>
+	///
+	/// <param name="_handle">Uniform group handle.</param>
+	///
+	[LinkName("bgfx_set_group")]
+	public static extern void set_group(UniformGroupHandle _handle);
+	
 	/// <summary>
 	/// Set condition for rendering.
 	/// </summary>
@@ -2025,6 +2025,7 @@ public static partial class bgfx
 			public uint minResourceCbSize;
 			public uint transientVbSize;
 			public uint transientIbSize;
+			public byte numFrames;
 		}
 	
 		public RendererType type;
@@ -2074,6 +2075,13 @@ public static partial class bgfx
 		public VertexBufferHandle handle;
 	}
 	
+	public unsafe struct TopologySortScratch
+	{
+		public void* data;
+		public uint size;
+		public uint num;
+	}
+	
 	public unsafe struct TextureInfo
 	{
 		public TextureFormat format;
@@ -2131,6 +2139,7 @@ public static partial class bgfx
 		public long cpuTimeFrame;
 		public long cpuTimeBegin;
 		public long cpuTimeEnd;
+		public long cpuTimeSort;
 		public long cpuTimerFreq;
 		public long gpuTimeBegin;
 		public long gpuTimeEnd;
@@ -2156,6 +2165,12 @@ public static partial class bgfx
 		public long rtMemoryUsed;
 		public int transientVbUsed;
 		public int transientIbUsed;
+		public long dynamicVbUsed;
+		public long dynamicVbPeak;
+		public long dynamicIbUsed;
+		public long dynamicIbPeak;
+		public float dynamicVbFragmentation;
+		public float dynamicIbFragmentation;
 		public fixed uint numPrims[5];
 		public long gpuMemoryMax;
 		public long gpuMemoryUsed;
@@ -2226,6 +2241,11 @@ public static partial class bgfx
 	    public bool Valid => idx != UInt16.MaxValue;
 	}
 	
+	public struct UniformGroupHandle {
+	    public ushort idx;
+	    public bool Valid => idx != UInt16.MaxValue;
+	}
+	
 	public struct UniformHandle {
 	    public ushort idx;
 	    public bool Valid => idx != UInt16.MaxValue;
@@ -2400,6 +2420,40 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_topology_sort_tri_list", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void topology_sort_tri_list(TopologySort _sort, void* _dst, uint _dstSize, float _dir, float _pos, void* _vertices, uint _stride, void* _indices, uint _numIndices, bool _index32);
 	
+	/// <summary>
+	/// Sort indices, reusing caller owned scratch memory between calls.
+	/// @remarks
+	///   Keys are computed in previous call's triangle order. When camera
+	///   moved only slightly they are nearly sorted, and are sorted
+	///   incrementally with insertion sort. If too many triangles move, it
+	///   falls back to radix sort.
+	/// </summary>
+	///
+	/// <param name="_sort">Sort order, see `TopologySort::Enum`.</param>
+	/// <param name="_dst">Destination index buffer.</param>
+	/// <param name="_dstSize">Destination index buffer in bytes.</param>
+	/// <param name="_dir">Direction (vector must be normalized).</param>
+	/// <param name="_pos">Position.</param>
+	/// <param name="_vertices">Pointer to first vertex represented as float x, y, z.</param>
+	/// <param name="_stride">Vertex stride.</param>
+	/// <param name="_indices">Source indices, must be the same between calls for previous order to be meaningful.</param>
+	/// <param name="_numIndices">Number of input indices.</param>
+	/// <param name="_index32">Set to `true` if input indices are 32-bit.</param>
+	/// <param name="_scratch">Scratch memory. If it's too small, temporary memory is allocated, and previous order is discarded.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_topology_sort_tri_list_scratch", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void topology_sort_tri_list_scratch(TopologySort _sort, void* _dst, uint _dstSize, float _dir, float _pos, void* _vertices, uint _stride, void* _indices, uint _numIndices, bool _index32, TopologySortScratch* _scratch);
+	
+	/// <summary>
+	/// Returns scratch memory size in bytes required to sort `_numIndices`
+	///   indices with `bgfx::topologySortTriList`.
+	/// </summary>
+	///
+	/// <param name="_numIndices">Number of input indices.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_topology_sort_tri_list_scratch_size", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe uint topology_sort_tri_list_scratch_size(uint _numIndices);
+	
 	/// <summary>
 	/// Returns supported backend API renderers.
 	/// </summary>
@@ -2871,6 +2925,19 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_create_shader", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe ShaderHandle create_shader(Memory* _mem);
 	
+	/// <summary>
+	/// Create shader from memory buffer, selecting variant by key when buffer
+	/// contains shader variants.
+	/// @remarks
+	///   `createShader(_mem)` with shader variants binary selects variant 0.
+	/// </summary>
+	///
+	/// <param name="_mem">Shader binary, or shader variants binary built by shaderc from source with `$variant <name> [count]` declarations.</param>
+	/// <param name="_variantKey">Variant key. Axis values are packed as bit fields in declaration order, starting from least significant bit, each axis taking as many bits as its largest value needs. Bits of axes not declared by shader are ignored. Ignored for regular shader binary.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_create_shader_variant", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe ShaderHandle create_shader_variant(Memory* _mem, uint _variantKey);
+	
 	/// <summary>
 	/// Returns the number of uniforms and uniform handles used inside a shader.
 	/// @remarks
@@ -2927,6 +2994,20 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_create_compute_program", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe ProgramHandle create_compute_program(ShaderHandle _csh, bool _destroyShaders);
 	
+	/// <summary>
+	/// Create program with vertex and fragment shader variants selected by key.
+	/// @remarks
+	///   Shaders and programs are deduplicated, creating program with the same
+	///   key again returns the same handle. Destroy it once per create call.
+	/// </summary>
+	///
+	/// <param name="_vsMem">Vertex shader binary, or shader variants binary.</param>
+	/// <param name="_fsMem">Fragment shader binary, or shader variants binary.</param>
+	/// <param name="_variantKey">Variant key, applied to both shaders. See `createShader(const Memory*, uint32_t)`. Axes used by both shaders must be declared first, and in the same order.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_create_program_variant", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe ProgramHandle create_program_variant(Memory* _vsMem, Memory* _fsMem, uint _variantKey);
+	
 	/// <summary>
 	/// Destroy program.
 	/// </summary>
@@ -2936,6 +3017,22 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_destroy_program", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void destroy_program(ProgramHandle _handle);
 	
+	/// <summary>
+	/// Returns true when program is done compiling and linking. Draw and compute calls
+	/// using program which is not ready are skipped by renderer.
+	/// @remarks
+	///   Only OpenGL renderer built with `BGFX_CONFIG_RENDERER_OPENGL_ASYNC_PROGRAM`
+	///   creates programs asynchronously, other renderers report program ready once
+	///   it's created on render thread. Result is delayed by number of frames in flight.
+	///   Program that failed to link never becomes ready.
+	/// </summary>
+	///
+	/// <param name="_handle">Program handle.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_is_program_ready", CallingConvention = CallingConvention.Cdecl)]
+	[return: MarshalAs(UnmanagedType.I1)]
+	public static extern unsafe bool is_program_ready(ProgramHandle _handle);
+	
 	/// <summary>
 	/// Validate texture parameters.
 	/// </summary>
@@ -3290,6 +3387,36 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_destroy_uniform", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void destroy_uniform(UniformHandle _handle);
 	
+	/// <summary>
+	/// Create uniform group. Uniform group holds values of `UniformSet::Group`
+	/// uniforms, which persist across frames and are sent to renderer only
+	/// when group is updated.
+	/// </summary>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_create_uniform_group", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe UniformGroupHandle create_uniform_group();
+	
+	/// <summary>
+	/// Update value of uniform stored in uniform group.
+	/// </summary>
+	///
+	/// <param name="_handle">Uniform group handle.</param>
+	/// <param name="_uniform">Uniform, created with `UniformSet::Group` frequency.</param>
+	/// <param name="_value">Pointer to uniform data.</param>
+	/// <param name="_num">Number of elements. Passing `UINT16_MAX` will use the _num passed on uniform creation.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_update_uniform_group", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void update_uniform_group(UniformGroupHandle _handle, UniformHandle _uniform, void* _value, ushort _num);
+	
+	/// <summary>
+	/// Destroy uniform group.
+	/// </summary>
+	///
+	/// <param name="_handle">Uniform group handle.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_destroy_uniform_group", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void destroy_uniform_group(UniformGroupHandle _handle);
+	
 	/// <summary>
 	/// Create occlusion query.
 	/// </summary>
@@ -3529,6 +3656,17 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_encoder_set_state", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void encoder_set_state(Encoder* _this, ulong _state, uint _rgba);
 	
+	/// <summary>
+	/// Set uniform group for draw primitive. Values of `UniformSet::Group`
+	/// uniforms stored in group are applied when group changes between
+	/// draw calls.
+	/// </summary>
+	///
+	/// <param name="_handle">Uniform group handle.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_set_group", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_set_group(Encoder* _this, UniformGroupHandle _handle);
+	
 	/// <summary>
 	/// Set condition for rendering.
 	/// </summary>
@@ -3768,6 +3906,52 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_encoder_set_instance_count", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void encoder_set_instance_count(Encoder* _this, uint _numInstances);
 	
+	/// <summary>
+	/// Allocate transient index buffer from encoder's transient page.
+	/// @remarks
+	///   Unlike `bgfx::allocTransientIndexBuffer` this doesn't take API lock.
+	///   Encoder reserves large pages from frame's transient index buffer,
+	///   and returns unused part of page at `bgfx::end`.
+	/// </summary>
+	///
+	/// <param name="_tib">TransientIndexBuffer structure is filled and is valid for the duration of frame, and it can be reused for multiple draw calls.</param>
+	/// <param name="_num">Number of indices to allocate.</param>
+	/// <param name="_index32">Set to `true` if input indices will be 32-bit.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_alloc_transient_index_buffer", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_alloc_transient_index_buffer(Encoder* _this, TransientIndexBuffer* _tib, uint _num, bool _index32);
+	
+	/// <summary>
+	/// Allocate transient vertex buffer from encoder's transient page.
+	/// @remarks
+	///   Unlike `bgfx::allocTransientVertexBuffer` this doesn't take API lock,
+	///   except first time vertex layout is used by encoder in frame.
+	/// </summary>
+	///
+	/// <param name="_tvb">TransientVertexBuffer structure is filled and is valid for the duration of frame, and it can be reused for multiple draw calls.</param>
+	/// <param name="_num">Number of vertices to allocate.</param>
+	/// <param name="_layout">Vertex layout.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_alloc_transient_vertex_buffer", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_alloc_transient_vertex_buffer(Encoder* _this, TransientVertexBuffer* _tvb, uint _num, VertexLayout* _layout);
+	
+	/// <summary>
+	/// Check for required space and allocate transient vertex and index
+	/// buffers from encoder's transient pages. If both space requirements
+	/// are satisfied function returns true.
+	/// </summary>
+	///
+	/// <param name="_tvb">TransientVertexBuffer structure is filled and is valid for the duration of frame.</param>
+	/// <param name="_layout">Vertex layout.</param>
+	/// <param name="_numVertices">Number of vertices to allocate.</param>
+	/// <param name="_tib">TransientIndexBuffer structure is filled and is valid for the duration of frame.</param>
+	/// <param name="_numIndices">Number of indices to allocate.</param>
+	/// <param name="_index32">Set to `true` if input indices will be 32-bit.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_alloc_transient_buffers", CallingConvention = CallingConvention.Cdecl)]
+	[return: MarshalAs(UnmanagedType.I1)]
+	public static extern unsafe bool encoder_alloc_transient_buffers(Encoder* _this, TransientVertexBuffer* _tvb, VertexLayout* _layout, uint _numVertices, TransientIndexBuffer* _tib, uint _numIndices, bool _index32);
+	
 	/// <summary>
 	/// Set texture stage for draw primitive.
 	/// </summary>
@@ -4077,6 +4261,17 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_set_state", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void set_state(ulong _state, uint _rgba);
 	
+	/// <summary>
+	/// Set uniform group for draw primitive. Values of `UniformSet::Group`
+	/// uniforms stored in group are applied when group changes between
+	/// draw calls.
+	/// </summary>
+	///
+	/// <param name="_handle">Uniform group handle.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_set_group", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void set_group(UniformGroupHandle _handle);
+	
 	/// <summary>
 	/// Set condition for rendering.
 	/// </summary>
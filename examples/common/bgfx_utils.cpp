@@ -13,9 +13,12 @@ namespace stl = tinystl;
 #include <bgfx/bgfx.h>
 #include <bx/commandline.h>
 #include <bx/endian.h>
+#include <bx/cpu.h>
 #include <bx/math.h>
+#include <bx/mutex.h>
 #include <bx/readerwriter.h>
 #include <bx/string.h>
+#include <bx/thread.h>
 #include "entry/entry.h"
 #include <meshoptimizer/src/meshoptimizer.h>
 
@@ -96,7 +99,7 @@ static void* loadMem(bx::FileReaderI* _reader, bx::AllocatorI* _allocator, const
 	return NULL;
 }
 
-static bgfx::ShaderHandle loadShader(bx::FileReaderI* _reader, const char* _name)
+static const bgfx::Memory* loadShaderMem(bx::FileReaderI* _reader, const char* _name)
 {
 	char filePath[512];
 
@@ -125,7 +128,12 @@ static bgfx::ShaderHandle loadShader(bx::FileReaderI* _reader, const char* _name
 	bx::strCat(filePath, BX_COUNTOF(filePath), _name);
 	bx::strCat(filePath, BX_COUNTOF(filePath), ".bin");
 
-	bgfx::ShaderHandle handle = bgfx::createShader(loadMem(_reader, filePath) );
+	return loadMem(_reader, filePath);
+}
+
+static bgfx::ShaderHandle loadShader(bx::FileReaderI* _reader, const char* _name)
+{
+	bgfx::ShaderHandle handle = bgfx::createShader(loadShaderMem(_reader, _name) );
 	bgfx::setName(handle, _name);
 
 	return handle;
@@ -153,6 +161,17 @@ bgfx::ProgramHandle loadProgram(const char* _vsName, const char* _fsName)
 	return loadProgram(entry::getFileReader(), _vsName, _fsName);
 }
 
+bgfx::ProgramHandle loadProgram(const char* _vsName, const char* _fsName, uint32_t _variantKey)
+{
+	bx::FileReaderI* reader = entry::getFileReader();
+
+	return bgfx::createProgram(
+		  loadShaderMem(reader, _vsName)
+		, NULL != _fsName ? loadShaderMem(reader, _fsName) : NULL
+		, _variantKey
+		);
+}
+
 static void imageReleaseCb(void* _ptr, void* _userData)
 {
 	BX_UNUSED(_ptr);
@@ -369,7 +388,12 @@ void Group::reset()
 	m_vertices = NULL;
 	m_numIndices = 0;
 	m_indices = NULL;
+	m_indices32 = NULL;
 	m_prims.clear();
+	m_meshlets.clear();
+	m_meshletVertices.clear();
+	m_meshletTriangles.clear();
+	m_lods.clear();
 }
 
 namespace bgfx
@@ -377,75 +401,231 @@ namespace bgfx
 	int32_t read(bx::ReaderI* _reader, bgfx::VertexLayout& _layout, bx::Error* _err = NULL);
 }
 
-void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
+static void readNumVertices(bx::ReaderI* _reader, bool _index32, uint32_t& _numVertices)
+{
+	if (_index32)
+	{
+		bx::read(_reader, _numVertices);
+	}
+	else
+	{
+		uint16_t numVertices;
+		bx::read(_reader, numVertices);
+		_numVertices = numVertices;
+	}
+}
+
+/// Whole mesh file image. Vertex and index buffer chunks are referenced straight from the
+/// image with bgfx::makeRef, every reference holds one ref count, and the image is freed once
+/// the last one is released by bgfx.
+struct MeshFile
+{
+	uint8_t* m_data;
+	uint32_t m_size;
+	int32_t  m_refCount;
+};
+
+static MeshFile* meshFileCreate(uint32_t _size)
+{
+	bx::AllocatorI* allocator = entry::getAllocator();
+	MeshFile* file = (MeshFile*)BX_ALIGNED_ALLOC(allocator, sizeof(MeshFile) + _size, 16);
+	file->m_data     = (uint8_t*)file + sizeof(MeshFile);
+	file->m_size     = _size;
+	file->m_refCount = 1;
+	return file;
+}
+
+static void meshFileRelease(MeshFile* _file)
+{
+	if (1 == bx::atomicFetchAndAdd<int32_t>(&_file->m_refCount, -1) )
+	{
+		BX_ALIGNED_FREE(entry::getAllocator(), _file, 16);
+	}
+}
+
+static void meshFileReleaseCb(void* _ptr, void* _userData)
+{
+	BX_UNUSED(_ptr);
+	meshFileRelease( (MeshFile*)_userData);
+}
+
+static const bgfx::Memory* meshFileRef(MeshFile* _file, const uint8_t* _data, uint32_t _size)
+{
+	bx::atomicFetchAndAdd<int32_t>(&_file->m_refCount, 1);
+	return bgfx::makeRef(_data, _size, meshFileReleaseCb, _file);
+}
+
+static bool meshFileContains(const MeshFile* _file, const void* _ptr)
+{
+	return NULL != _file
+		&& _ptr >= _file->m_data
+		&& _ptr <  _file->m_data + _file->m_size
+		;
+}
+
+static MeshFile* meshFileLoad(bx::FileReaderI* _reader, const char* _filePath)
+{
+	if (!bx::open(_reader, _filePath) )
+	{
+		return NULL;
+	}
+
+	const uint32_t size = (uint32_t)bx::getSize(_reader);
+	MeshFile* file = meshFileCreate(size);
+	bx::read(_reader, file->m_data, size);
+	bx::close(_reader);
+
+	return file;
+}
+
+/// Returns pointer to the next _size bytes of the file image and skips over them, or NULL if
+/// the file is truncated.
+static const uint8_t* meshFileData(bx::MemoryReader* _reader, const MeshFile* _file, uint32_t _size)
+{
+	if (bx::getRemain(_reader) < int64_t(_size) )
+	{
+		return NULL;
+	}
+
+	const uint8_t* data = _file->m_data + bx::seek(_reader);
+	bx::skip(_reader, _size);
+	return data;
+}
+
+/// Destroys group buffers and frees ram copies that don't point into file image. Buffers
+/// created by reference release their file image reference once bgfx is done with them.
+static void meshGroupDestroy(const MeshFile* _file, const Group& _group)
+{
+	bx::AllocatorI* allocator = entry::getAllocator();
+
+	if (bgfx::isValid(_group.m_vbh) )
+	{
+		bgfx::destroy(_group.m_vbh);
+	}
+
+	if (bgfx::isValid(_group.m_ibh) )
+	{
+		bgfx::destroy(_group.m_ibh);
+	}
+
+	for (uint32_t ii = 0, num = uint32_t(_group.m_lods.size() ); ii < num; ++ii)
+	{
+		bgfx::destroy(_group.m_lods[ii].m_ibh);
+	}
+
+	// Uncompressed ram copies point into file image.
+	if (NULL != _group.m_vertices
+	&&  !meshFileContains(_file, _group.m_vertices) )
+	{
+		BX_FREE(allocator, _group.m_vertices);
+	}
+
+	if (NULL != _group.m_indices
+	&&  !meshFileContains(_file, _group.m_indices) )
+	{
+		BX_FREE(allocator, _group.m_indices);
+	}
+
+	if (NULL != _group.m_indices32
+	&&  !meshFileContains(_file, _group.m_indices32) )
+	{
+		BX_FREE(allocator, _group.m_indices32);
+	}
+}
+
+typedef void (*MeshGroupFn)(void* _userData, const bgfx::VertexLayout& _layout, const Group& _group);
+
+static void meshParse(MeshFile* _file, bool _ramcopy, MeshGroupFn _fn, void* _userData)
 {
 	constexpr uint32_t kChunkVertexBuffer           = BX_MAKEFOURCC('V', 'B', ' ', 0x1);
 	constexpr uint32_t kChunkVertexBufferCompressed = BX_MAKEFOURCC('V', 'B', 'C', 0x0);
 	constexpr uint32_t kChunkIndexBuffer            = BX_MAKEFOURCC('I', 'B', ' ', 0x0);
 	constexpr uint32_t kChunkIndexBufferCompressed  = BX_MAKEFOURCC('I', 'B', 'C', 0x1);
 	constexpr uint32_t kChunkPrimitive              = BX_MAKEFOURCC('P', 'R', 'I', 0x0);
+	constexpr uint32_t kChunkMeshlet                = BX_MAKEFOURCC('M', 'L', 'T', 0x0);
+	constexpr uint32_t kChunkLod                    = BX_MAKEFOURCC('L', 'O', 'D', 0x0);
+
+	constexpr uint32_t kChunkVertexBuffer32           = BX_MAKEFOURCC('V', 'B', ' ', 0x2);
+	constexpr uint32_t kChunkVertexBufferCompressed32 = BX_MAKEFOURCC('V', 'B', 'C', 0x1);
+	constexpr uint32_t kChunkIndexBuffer32            = BX_MAKEFOURCC('I', 'B', ' ', 0x1);
+	constexpr uint32_t kChunkIndexBufferCompressed32  = BX_MAKEFOURCC('I', 'B', 'C', 0x2);
 
 	using namespace bx;
 	using namespace bgfx;
 
+	bx::MemoryReader reader(_file->m_data, _file->m_size);
+
+	VertexLayout layout;
 	Group group;
 
+	// Meshlet chunk precedes primitive chunk, per primitive ranges are applied once
+	// primitives are read.
+	stl::vector<uint32_t> meshletRanges;
+
 	bx::AllocatorI* allocator = entry::getAllocator();
 
 	uint32_t chunk;
 	bx::Error err;
-	while (4 == bx::read(_reader, chunk, &err)
+	while (4 == bx::read(&reader, chunk, &err)
 	   &&  err.isOk() )
 	{
 		switch (chunk)
 		{
 			case kChunkVertexBuffer:
+			case kChunkVertexBuffer32:
 			{
-				read(_reader, group.m_sphere);
-				read(_reader, group.m_aabb);
-				read(_reader, group.m_obb);
+				read(&reader, group.m_sphere);
+				read(&reader, group.m_aabb);
+				read(&reader, group.m_obb);
 
-				read(_reader, m_layout);
+				read(&reader, layout);
 
-				uint16_t stride = m_layout.getStride();
+				uint16_t stride = layout.getStride();
 
-				read(_reader, group.m_numVertices);
-				const bgfx::Memory* mem = bgfx::alloc(group.m_numVertices*stride);
-				read(_reader, mem->data, mem->size);
+				readNumVertices(&reader, kChunkVertexBuffer32 == chunk, group.m_numVertices);
+
+				const uint32_t size = group.m_numVertices*stride;
+				const uint8_t* data = meshFileData(&reader, _file, size);
+				if (NULL == data)
+				{
+					meshGroupDestroy(_file, group);
+					return;
+				}
 
 				if (_ramcopy)
 				{
-					group.m_vertices = (uint8_t*)BX_ALLOC(allocator, group.m_numVertices*stride);
-					bx::memCopy(group.m_vertices, mem->data, mem->size);
+					group.m_vertices = const_cast<uint8_t*>(data);
 				}
 
-				group.m_vbh = bgfx::createVertexBuffer(mem, m_layout);
+				group.m_vbh = bgfx::createVertexBuffer(meshFileRef(_file, data, size), layout);
 			}
 				break;
 
 			case kChunkVertexBufferCompressed:
+			case kChunkVertexBufferCompressed32:
 			{
-				read(_reader, group.m_sphere);
-				read(_reader, group.m_aabb);
-				read(_reader, group.m_obb);
-
-				read(_reader, m_layout);
+				read(&reader, group.m_sphere);
+				read(&reader, group.m_aabb);
+				read(&reader, group.m_obb);
 
-				uint16_t stride = m_layout.getStride();
+				read(&reader, layout);
 
-				read(_reader, group.m_numVertices);
+				uint16_t stride = layout.getStride();
 
-				const bgfx::Memory* mem = bgfx::alloc(group.m_numVertices*stride);
+				readNumVertices(&reader, kChunkVertexBufferCompressed32 == chunk, group.m_numVertices);
 
 				uint32_t compressedSize;
-				bx::read(_reader, compressedSize);
-
-				void* compressedVertices = BX_ALLOC(allocator, compressedSize);
-				bx::read(_reader, compressedVertices, compressedSize);
+				bx::read(&reader, compressedSize);
 
-				meshopt_decodeVertexBuffer(mem->data, group.m_numVertices, stride, (uint8_t*)compressedVertices, compressedSize);
+				const uint8_t* compressedVertices = meshFileData(&reader, _file, compressedSize);
+				if (NULL == compressedVertices)
+				{
+					meshGroupDestroy(_file, group);
+					return;
+				}
 
-				BX_FREE(allocator, compressedVertices);
+				const bgfx::Memory* mem = bgfx::alloc(group.m_numVertices*stride);
+				meshopt_decodeVertexBuffer(mem->data, group.m_numVertices, stride, compressedVertices, compressedSize);
 
 				if (_ramcopy)
 				{
@@ -453,129 +633,426 @@ void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
 					bx::memCopy(group.m_vertices, mem->data, mem->size);
 				}
 
-				group.m_vbh = bgfx::createVertexBuffer(mem, m_layout);
+				group.m_vbh = bgfx::createVertexBuffer(mem, layout);
 			}
 				break;
 
 			case kChunkIndexBuffer:
+			case kChunkIndexBuffer32:
 			{
-				read(_reader, group.m_numIndices);
-				const bgfx::Memory* mem = bgfx::alloc(group.m_numIndices*2);
-				read(_reader, mem->data, mem->size);
+				const bool     index32   = kChunkIndexBuffer32 == chunk;
+				const uint32_t indexSize = index32 ? 4 : 2;
+
+				read(&reader, group.m_numIndices);
+
+				const uint32_t size = group.m_numIndices*indexSize;
+				const uint8_t* data = meshFileData(&reader, _file, size);
+				if (NULL == data)
+				{
+					meshGroupDestroy(_file, group);
+					return;
+				}
 
 				if (_ramcopy)
 				{
-					group.m_indices = (uint16_t*)BX_ALLOC(allocator, group.m_numIndices*2);
-					bx::memCopy(group.m_indices, mem->data, mem->size);
+					if (index32)
+					{
+						group.m_indices32 = (uint32_t*)const_cast<uint8_t*>(data);
+					}
+					else
+					{
+						group.m_indices = (uint16_t*)const_cast<uint8_t*>(data);
+					}
 				}
 
-				group.m_ibh = bgfx::createIndexBuffer(mem);
+				group.m_ibh = bgfx::createIndexBuffer(meshFileRef(_file, data, size), index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE);
 			}
 				break;
 
 			case kChunkIndexBufferCompressed:
+			case kChunkIndexBufferCompressed32:
 			{
-				bx::read(_reader, group.m_numIndices);
+				const bool     index32   = kChunkIndexBufferCompressed32 == chunk;
+				const uint32_t indexSize = index32 ? 4 : 2;
 
-				const bgfx::Memory* mem = bgfx::alloc(group.m_numIndices*2);
+				bx::read(&reader, group.m_numIndices);
 
 				uint32_t compressedSize;
-				bx::read(_reader, compressedSize);
+				bx::read(&reader, compressedSize);
 
-				void* compressedIndices = BX_ALLOC(allocator, compressedSize);
+				const uint8_t* compressedIndices = meshFileData(&reader, _file, compressedSize);
+				if (NULL == compressedIndices)
+				{
+					meshGroupDestroy(_file, group);
+					return;
+				}
 
-				bx::read(_reader, compressedIndices, compressedSize);
+				const bgfx::Memory* mem = bgfx::alloc(group.m_numIndices*indexSize);
+				meshopt_decodeIndexBuffer(mem->data, group.m_numIndices, indexSize, compressedIndices, compressedSize);
 
-				meshopt_decodeIndexBuffer(mem->data, group.m_numIndices, 2, (uint8_t*)compressedIndices, compressedSize);
+				if (_ramcopy)
+				{
+					void* indices = BX_ALLOC(allocator, mem->size);
+					bx::memCopy(indices, mem->data, mem->size);
+
+					if (index32)
+					{
+						group.m_indices32 = (uint32_t*)indices;
+					}
+					else
+					{
+						group.m_indices = (uint16_t*)indices;
+					}
+				}
 
-				BX_FREE(allocator, compressedIndices);
+				group.m_ibh = bgfx::createIndexBuffer(mem, index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE);
+			}
+				break;
 
-				if (_ramcopy)
+			case kChunkMeshlet:
+			{
+				uint16_t numPrims;
+				read(&reader, numPrims);
+
+				meshletRanges.resize(numPrims*2);
+				read(&reader, meshletRanges.data(), numPrims*2*uint32_t(sizeof(uint32_t) ) );
+
+				uint32_t num;
+				read(&reader, num);
+
+				group.m_meshlets.resize(num);
+				for (uint32_t ii = 0; ii < num; ++ii)
 				{
-					group.m_indices = (uint16_t*)BX_ALLOC(allocator, group.m_numIndices*2);
-					bx::memCopy(group.m_indices, mem->data, mem->size);
+					Meshlet& meshlet = group.m_meshlets[ii];
+					read(&reader, meshlet.m_vertexOffset);
+					read(&reader, meshlet.m_triangleOffset);
+					read(&reader, meshlet.m_numVertices);
+					read(&reader, meshlet.m_numTriangles);
+					read(&reader, meshlet.m_sphere);
+					read(&reader, meshlet.m_coneApex);
+					read(&reader, meshlet.m_coneAxis);
+					read(&reader, meshlet.m_coneCutoff);
 				}
 
-				group.m_ibh = bgfx::createIndexBuffer(mem);
+				read(&reader, num);
+				group.m_meshletVertices.resize(num);
+				read(&reader, group.m_meshletVertices.data(), num*uint32_t(sizeof(uint32_t) ) );
+
+				read(&reader, num);
+				group.m_meshletTriangles.resize(num);
+				read(&reader, group.m_meshletTriangles.data(), num);
+			}
+				break;
+
+			case kChunkLod:
+			{
+				uint8_t numLods;
+				read(&reader, numLods);
+
+				uint8_t index32;
+				read(&reader, index32);
+
+				uint16_t numPrims;
+				read(&reader, numPrims);
+
+				const uint32_t indexSize = 0 != index32 ? 4 : 2;
+
+				group.m_lods.resize(numLods);
+				for (uint32_t ii = 0; ii < numLods; ++ii)
+				{
+					MeshLod& lod = group.m_lods[ii];
+					read(&reader, lod.m_error);
+					read(&reader, lod.m_numIndices);
+
+					lod.m_primRanges.resize(numPrims*2);
+					read(&reader, lod.m_primRanges.data(), numPrims*2*uint32_t(sizeof(uint32_t) ) );
+
+					const uint32_t size = lod.m_numIndices*indexSize;
+					const uint8_t* data = meshFileData(&reader, _file, size);
+					if (NULL == data)
+					{
+						// Only LODs read so far have index buffer.
+						group.m_lods.resize(ii);
+						meshGroupDestroy(_file, group);
+						return;
+					}
+
+					lod.m_ibh = bgfx::createIndexBuffer(meshFileRef(_file, data, size), 0 != index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE);
+				}
 			}
 				break;
 
 			case kChunkPrimitive:
 			{
 				uint16_t len;
-				read(_reader, len);
+				read(&reader, len);
 
 				stl::string material;
 				material.resize(len);
-				read(_reader, const_cast<char*>(material.c_str() ), len);
+				read(&reader, const_cast<char*>(material.c_str() ), len);
 
 				uint16_t num;
-				read(_reader, num);
+				read(&reader, num);
 
 				for (uint32_t ii = 0; ii < num; ++ii)
 				{
-					read(_reader, len);
+					read(&reader, len);
 
 					stl::string name;
 					name.resize(len);
-					read(_reader, const_cast<char*>(name.c_str() ), len);
+					read(&reader, const_cast<char*>(name.c_str() ), len);
 
 					Primitive prim;
-					read(_reader, prim.m_startIndex);
-					read(_reader, prim.m_numIndices);
-					read(_reader, prim.m_startVertex);
-					read(_reader, prim.m_numVertices);
-					read(_reader, prim.m_sphere);
-					read(_reader, prim.m_aabb);
-					read(_reader, prim.m_obb);
+					read(&reader, prim.m_startIndex);
+					read(&reader, prim.m_numIndices);
+					read(&reader, prim.m_startVertex);
+					read(&reader, prim.m_numVertices);
+					read(&reader, prim.m_sphere);
+					read(&reader, prim.m_aabb);
+					read(&reader, prim.m_obb);
+
+					prim.m_startMeshlet = ii*2 < meshletRanges.size() ? meshletRanges[ii*2+0] : 0;
+					prim.m_numMeshlets  = ii*2 < meshletRanges.size() ? meshletRanges[ii*2+1] : 0;
 
 					group.m_prims.push_back(prim);
 				}
 
-				m_groups.push_back(group);
+				_fn(_userData, layout, group);
 				group.reset();
+				meshletRanges.clear();
 			}
 				break;
 
 			default:
-				DBG("%08x at %d", chunk, bx::skip(_reader, 0) );
+				DBG("%08x at %d", chunk, bx::skip(&reader, 0) );
 				break;
 		}
 	}
+
+	// File ended before primitive chunk completed group.
+	meshGroupDestroy(_file, group);
 }
 
-void Mesh::unload()
+static void meshAddGroup(void* _userData, const bgfx::VertexLayout& _layout, const Group& _group)
 {
-	bx::AllocatorI* allocator = entry::getAllocator();
+	Mesh* mesh = (Mesh*)_userData;
+	mesh->m_layout = _layout;
+	mesh->m_groups.push_back(_group);
+}
 
-	for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+/// Background mesh loader. Worker thread reads file image and creates groups, main thread
+/// publishes groups created so far into mesh with meshLoadAsyncUpdate.
+struct MeshLoader
+{
+	bx::Thread         m_thread;
+	bx::Mutex          m_mutex;
+	stl::string        m_filePath;
+	bool               m_ramcopy;
+	bgfx::VertexLayout m_layout;
+	GroupArray         m_groups;
+	MeshFile*          m_file;
+	bool               m_done;
+};
+
+static void meshLoaderAddGroup(void* _userData, const bgfx::VertexLayout& _layout, const Group& _group)
+{
+	MeshLoader* loader = (MeshLoader*)_userData;
+
+	bx::MutexScope scope(loader->m_mutex);
+	loader->m_layout = _layout;
+	loader->m_groups.push_back(_group);
+}
+
+static int32_t meshLoaderThread(bx::Thread* _self, void* _userData)
+{
+	BX_UNUSED(_self);
+
+	MeshLoader* loader = (MeshLoader*)_userData;
+
+	bx::FileReaderI* reader = entry::createFileReader();
+	MeshFile* file = meshFileLoad(reader, loader->m_filePath.c_str() );
+	entry::destroyFileReader(reader);
+
+	if (NULL != file)
 	{
-		const Group& group = *it;
-		bgfx::destroy(group.m_vbh);
+		meshParse(file, loader->m_ramcopy, meshLoaderAddGroup, loader);
 
-		if (bgfx::isValid(group.m_ibh) )
+		if (!loader->m_ramcopy)
 		{
-			bgfx::destroy(group.m_ibh);
+			meshFileRelease(file);
+			file = NULL;
 		}
+	}
+
+	bx::MutexScope scope(loader->m_mutex);
+	loader->m_file = file;
+	loader->m_done = true;
+
+	return 0;
+}
+
+static bool meshLoaderUpdate(Mesh* _mesh, bool _wait)
+{
+	MeshLoader* loader = _mesh->m_loader;
+	if (NULL == loader)
+	{
+		return true;
+	}
+
+	if (_wait
+	&&  loader->m_thread.isRunning() )
+	{
+		loader->m_thread.shutdown();
+	}
 
-		if (NULL != group.m_vertices)
+	bool done;
+
+	{
+		bx::MutexScope scope(loader->m_mutex);
+
+		if (!loader->m_groups.empty() )
 		{
-			BX_FREE(allocator, group.m_vertices);
+			_mesh->m_layout = loader->m_layout;
+			_mesh->m_groups.insert(_mesh->m_groups.end(), loader->m_groups.begin(), loader->m_groups.end() );
+			loader->m_groups.clear();
 		}
 
-		if (NULL != group.m_indices)
+		done = loader->m_done;
+	}
+
+	if (done)
+	{
+		if (loader->m_thread.isRunning() )
 		{
-			BX_FREE(allocator, group.m_indices);
+			loader->m_thread.shutdown();
 		}
+
+		_mesh->m_file   = loader->m_file;
+		_mesh->m_loader = NULL;
+		delete loader;
+	}
+
+	return done;
+}
+
+Mesh::Mesh()
+	: m_file(NULL)
+	, m_loader(NULL)
+{
+}
+
+void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
+{
+	// Loading into mesh that's already loaded replaces its content.
+	if (NULL != m_file
+	||  NULL != m_loader
+	||  !m_groups.empty() )
+	{
+		unload();
+	}
+
+	const int64_t remain = bx::getRemain(_reader);
+	if (0 >= remain)
+	{
+		return;
+	}
+
+	MeshFile* file = meshFileCreate(uint32_t(remain) );
+	bx::read(_reader, file->m_data, file->m_size);
+
+	meshParse(file, _ramcopy, meshAddGroup, this);
+
+	if (_ramcopy)
+	{
+		m_file = file;
+	}
+	else
+	{
+		meshFileRelease(file);
+	}
+}
+
+void Mesh::unload()
+{
+	meshLoaderUpdate(this, true);
+
+	for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+	{
+		meshGroupDestroy(m_file, *it);
 	}
 	m_groups.clear();
+
+	if (NULL != m_file)
+	{
+		meshFileRelease(m_file);
+		m_file = NULL;
+	}
 }
 
-void Mesh::submit(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state) const
+/// Largest scale of matrix basis, bounding sphere radius in world space is radius*scale.
+static float mtxMaxScale(const float* _mtx)
+{
+	const bx::Vec3 axisX = bx::load<bx::Vec3>(&_mtx[0]);
+	const bx::Vec3 axisY = bx::load<bx::Vec3>(&_mtx[4]);
+	const bx::Vec3 axisZ = bx::load<bx::Vec3>(&_mtx[8]);
+	return bx::sqrt(bx::max(bx::dot(axisX, axisX), bx::max(bx::dot(axisY, axisY), bx::dot(axisZ, axisZ) ) ) );
+}
+
+/// Bounding sphere transformed by _mtx, radius is scaled by largest scale of matrix basis.
+static Sphere sphereTransform(const Sphere& _sphere, const float* _mtx)
+{
+	Sphere result;
+	result.center = bx::mul(_sphere.center, _mtx);
+	result.radius = _sphere.radius*mtxMaxScale(_mtx);
+	return result;
+}
+
+/// Returns true if bounding sphere transformed by _mtx is at least partially inside frustum.
+static bool sphereVisible(const bx::Plane* _planes, const Sphere& _sphere, const float* _mtx)
+{
+	const Sphere sphere = sphereTransform(_sphere, _mtx);
+
+	uint32_t visible;
+	cullSpheres(&visible, _planes, 6, &sphere, 1);
+
+	return 0 != visible;
+}
+
+static uint32_t meshSelectLod(const Group& _group, const float* _mtx, const MeshLodSelect& _lod)
+{
+	if (_group.m_lods.empty() )
+	{
+		return 0;
+	}
+
+	const float    scale    = mtxMaxScale(_mtx);
+	const bx::Vec3 center   = bx::mul(_group.m_sphere.center, _mtx);
+	const float    distance = bx::max(0.0f, bx::length(bx::sub(center, _lod.m_eye) ) - _group.m_sphere.radius*scale);
+
+	// Compare error*scale*pixelsPerUnit/distance against max error without dividing, so
+	// that camera inside of bounding sphere always selects full resolution.
+	const float pixelsPerError = scale*_lod.m_pixelsPerUnit;
+	const float maxError       = _lod.m_maxPixelError*distance;
+
+	uint32_t lod = 0;
+	for (uint32_t ii = 0, num = uint32_t(_group.m_lods.size() ); ii < num; ++ii)
+	{
+		if (_group.m_lods[ii].m_error*pixelsPerError > maxError)
+		{
+			break;
+		}
+
+		lod = ii+1;
+	}
+
+	return lod;
+}
+
+static uint64_t meshState(uint64_t _state)
 {
 	if (BGFX_STATE_MASK == _state)
 	{
-		_state = 0
+		return 0
 			| BGFX_STATE_WRITE_RGB
 			| BGFX_STATE_WRITE_A
 			| BGFX_STATE_WRITE_Z
@@ -585,17 +1062,209 @@ void Mesh::submit(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _
 			;
 	}
 
+	return _state;
+}
+
+static void submitGroups(const GroupArray& _groups, bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state, const MeshLodSelect* _lod, const float* _viewProj)
+{
+	bx::Plane planes[6];
+	if (NULL != _viewProj)
+	{
+		buildFrustumPlanes(planes, _viewProj);
+	}
+
+	// Find last visible group first, so that state is discarded with its draw call.
+	uint32_t numGroups = uint32_t(_groups.size() );
+	while (0 < numGroups
+	&&     NULL != _viewProj
+	&&     !sphereVisible(planes, _groups[numGroups-1].m_sphere, _mtx) )
+	{
+		--numGroups;
+	}
+
+	if (0 == numGroups)
+	{
+		return;
+	}
+
 	bgfx::setTransform(_mtx);
-	bgfx::setState(_state);
+	bgfx::setState(meshState(_state) );
+
+	for (uint32_t ii = 0; ii < numGroups; ++ii)
+	{
+		const Group& group = _groups[ii];
+		const bool   last  = ii == numGroups-1;
+
+		if (!last
+		&&  NULL != _viewProj
+		&&  !sphereVisible(planes, group.m_sphere, _mtx) )
+		{
+			continue;
+		}
+
+		const uint32_t lod = NULL != _lod ? meshSelectLod(group, _mtx, *_lod) : 0;
+
+		bgfx::setIndexBuffer(0 == lod ? group.m_ibh : group.m_lods[lod-1].m_ibh);
+		bgfx::setVertexBuffer(0, group.m_vbh);
+		bgfx::submit(_id, _program, 0, last ? (BGFX_DISCARD_INDEX_BUFFER | BGFX_DISCARD_VERTEX_STREAMS | BGFX_DISCARD_STATE) : BGFX_DISCARD_NONE);
+	}
+}
+
+void Mesh::submit(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state) const
+{
+	submitGroups(m_groups, _id, _program, _mtx, _state, NULL, NULL);
+}
+
+void Mesh::submit(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state, const MeshLodSelect& _lod) const
+{
+	submitGroups(m_groups, _id, _program, _mtx, _state, &_lod, NULL);
+}
+
+void Mesh::submitCulled(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, const float* _viewProj, uint64_t _state) const
+{
+	submitGroups(m_groups, _id, _program, _mtx, _state, NULL, _viewProj);
+}
+
+struct InstanceCullScratch
+{
+	stl::vector<Sphere>   m_spheres;
+	stl::vector<uint32_t> m_visible;
+};
+
+/// Culls instances against group bounds, and copies transforms of visible instances into
+/// transient instance data buffer. Returns number of visible instances.
+static uint32_t cullInstances(bgfx::InstanceDataBuffer& _outIdb, const bx::Plane* _planes, const Group& _group, const float* _mtx, uint32_t _numInstances, InstanceCullScratch& _scratch)
+{
+	constexpr uint16_t kStride = 64;
+
+	if (0 == _numInstances)
+	{
+		return 0;
+	}
+
+	const uint32_t numWords = (_numInstances+31)/32;
+	_scratch.m_spheres.resize(_numInstances);
+	_scratch.m_visible.resize(numWords);
+
+	for (uint32_t ii = 0; ii < _numInstances; ++ii)
+	{
+		_scratch.m_spheres[ii] = sphereTransform(_group.m_sphere, &_mtx[ii*16]);
+	}
+
+	cullSpheres(_scratch.m_visible.data(), _planes, 6, _scratch.m_spheres.data(), _numInstances);
+
+	uint32_t numVisible = 0;
+	for (uint32_t ii = 0; ii < numWords; ++ii)
+	{
+		numVisible += bx::uint32_cntbits(_scratch.m_visible[ii]);
+	}
+
+	// Transient instance data is shared by all draw calls in frame, splitting into more
+	// draw calls wouldn't fit more instances.
+	const uint32_t num = bgfx::getAvailInstanceDataBuffer(numVisible, kStride);
+	BX_WARN(num == numVisible
+		, "Transient instance data buffer is full, %d of %d visible instances are not drawn."
+		, numVisible - num
+		, numVisible
+		);
+
+	if (0 == num)
+	{
+		return 0;
+	}
+
+	bgfx::allocInstanceDataBuffer(&_outIdb, num, kStride);
+
+	for (uint32_t ii = 0, idx = 0; idx < num; ++ii)
+	{
+		if (0 != (_scratch.m_visible[ii/32] & (1u << (ii%32) ) ) )
+		{
+			bx::memCopy(&_outIdb.data[idx*kStride], &_mtx[ii*16], kStride);
+			++idx;
+		}
+	}
+
+	return num;
+}
 
+uint32_t Mesh::submitInstanced(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint16_t _numInstances, const float* _viewProj, uint64_t _state) const
+{
+	bx::Plane planes[6];
+	buildFrustumPlanes(planes, _viewProj);
+
+	InstanceCullScratch scratch;
+
+	uint32_t numDrawn = 0;
 	for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
 	{
 		const Group& group = *it;
 
+		bgfx::InstanceDataBuffer idb;
+		const uint32_t num = cullInstances(idb, planes, group, _mtx, _numInstances, scratch);
+		if (0 == num)
+		{
+			continue;
+		}
+
+		bgfx::setInstanceDataBuffer(&idb);
 		bgfx::setIndexBuffer(group.m_ibh);
 		bgfx::setVertexBuffer(0, group.m_vbh);
-		bgfx::submit(_id, _program, 0, (it == itEnd-1) ? (BGFX_DISCARD_INDEX_BUFFER | BGFX_DISCARD_VERTEX_STREAMS | BGFX_DISCARD_STATE) : BGFX_DISCARD_NONE);
+		bgfx::setState(meshState(_state) );
+		bgfx::submit(_id, _program);
+
+		numDrawn += num;
 	}
+
+	return numDrawn;
+}
+
+uint32_t Mesh::submitInstanced(const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint16_t _numInstances, const float* _viewProj) const
+{
+	bx::Plane planes[6];
+	buildFrustumPlanes(planes, _viewProj);
+
+	InstanceCullScratch scratch;
+
+	// Instances are culled once per group, and the same instance data buffer is used by
+	// all passes.
+	uint32_t numDrawn = 0;
+	for (GroupArray::const_iterator it = m_groups.begin(), itEnd = m_groups.end(); it != itEnd; ++it)
+	{
+		const Group& group = *it;
+
+		bgfx::InstanceDataBuffer idb;
+		const uint32_t num = cullInstances(idb, planes, group, _mtx, _numInstances, scratch);
+		if (0 == num)
+		{
+			continue;
+		}
+
+		for (uint32_t pass = 0; pass < _numPasses; ++pass)
+		{
+			const MeshState& state = *_state[pass];
+
+			for (uint8_t tex = 0; tex < state.m_numTextures; ++tex)
+			{
+				const MeshState::Texture& texture = state.m_textures[tex];
+				bgfx::setTexture(
+					  texture.m_stage
+					, texture.m_sampler
+					, texture.m_texture
+					, texture.m_flags
+					);
+			}
+
+			bgfx::setInstanceDataBuffer(&idb);
+			bgfx::setIndexBuffer(group.m_ibh);
+			bgfx::setVertexBuffer(0, group.m_vbh);
+			bgfx::setState(state.m_state);
+			bgfx::submit(state.m_viewId, state.m_program);
+		}
+
+		numDrawn += num;
+	}
+
+	return numDrawn;
 }
 
 void Mesh::submit(const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint16_t _numMatrices) const
@@ -645,15 +1314,50 @@ Mesh* meshLoad(bx::ReaderSeekerI* _reader, bool _ramcopy)
 
 Mesh* meshLoad(const char* _filePath, bool _ramcopy)
 {
-	bx::FileReaderI* reader = entry::getFileReader();
-	if (bx::open(reader, _filePath) )
+	MeshFile* file = meshFileLoad(entry::getFileReader(), _filePath);
+	if (NULL == file)
 	{
-		Mesh* mesh = meshLoad(reader, _ramcopy);
-		bx::close(reader);
-		return mesh;
+		return NULL;
 	}
 
-	return NULL;
+	Mesh* mesh = new Mesh;
+	meshParse(file, _ramcopy, meshAddGroup, mesh);
+
+	if (_ramcopy)
+	{
+		mesh->m_file = file;
+	}
+	else
+	{
+		meshFileRelease(file);
+	}
+
+	return mesh;
+}
+
+Mesh* meshLoadAsync(const char* _filePath, bool _ramcopy)
+{
+	MeshLoader* loader = new MeshLoader;
+	loader->m_filePath = _filePath;
+	loader->m_ramcopy  = _ramcopy;
+	loader->m_file     = NULL;
+	loader->m_done     = false;
+
+	Mesh* mesh = new Mesh;
+	mesh->m_loader = loader;
+
+	if (!loader->m_thread.init(meshLoaderThread, loader, 0, "meshLoad") )
+	{
+		// Load synchronously, mesh is complete on first meshLoadAsyncUpdate.
+		meshLoaderThread(NULL, loader);
+	}
+
+	return mesh;
+}
+
+bool meshLoadAsyncUpdate(Mesh* _mesh)
+{
+	return meshLoaderUpdate(_mesh, false);
 }
 
 void meshUnload(Mesh* _mesh)
@@ -678,6 +1382,16 @@ void meshSubmit(const Mesh* _mesh, bgfx::ViewId _id, bgfx::ProgramHandle _progra
 	_mesh->submit(_id, _program, _mtx, _state);
 }
 
+void meshSubmit(const Mesh* _mesh, bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, const MeshLodSelect& _lod, uint64_t _state)
+{
+	_mesh->submit(_id, _program, _mtx, _state, _lod);
+}
+
+float meshLodPixelsPerUnit(const float* _proj, uint16_t _height)
+{
+	return 0.5f*float(_height)*_proj[5];
+}
+
 void meshSubmit(const Mesh* _mesh, const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint16_t _numMatrices)
 {
 	_mesh->submit(_state, _numPasses, _mtx, _numMatrices);
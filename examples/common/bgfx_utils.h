@@ -28,6 +28,9 @@ bgfx::ShaderHandle loadShader(const char* _name);
 ///
 bgfx::ProgramHandle loadProgram(const char* _vsName, const char* _fsName);
 
+/// Loads program from shaders compiled with `$variant` declarations, selecting variant by key.
+bgfx::ProgramHandle loadProgram(const char* _vsName, const char* _fsName, uint32_t _variantKey);
+
 ///
 bgfx::TextureHandle loadTexture(const char* _name, uint64_t _flags = BGFX_TEXTURE_NONE|BGFX_SAMPLER_NONE, uint8_t _skip = 0, bgfx::TextureInfo* _info = NULL, bimg::Orientation::Enum* _orientation = NULL);
 
@@ -90,6 +93,8 @@ struct Primitive
 	uint32_t m_numIndices;
 	uint32_t m_startVertex;
 	uint32_t m_numVertices;
+	uint32_t m_startMeshlet;
+	uint32_t m_numMeshlets;
 	
 	Sphere m_sphere;
 	Aabb m_aabb;
@@ -98,6 +103,42 @@ struct Primitive
 
 typedef stl::vector<Primitive> PrimitiveArray;
 
+/// Cluster of up to 64 vertices and 124 triangles, built by geometryc --meshlets.
+struct Meshlet
+{
+	uint32_t m_vertexOffset;   //!< Offset into Group::m_meshletVertices.
+	uint32_t m_triangleOffset; //!< Offset into Group::m_meshletTriangles.
+	uint32_t m_numVertices;
+	uint32_t m_numTriangles;
+
+	Sphere   m_sphere;
+	bx::Vec3 m_coneApex;
+	bx::Vec3 m_coneAxis;
+	float    m_coneCutoff;     //!< Cosine of normal cone half angle.
+};
+
+typedef stl::vector<Meshlet> MeshletArray;
+
+/// Simplified index buffer, built by geometryc --lods.
+struct MeshLod
+{
+	float m_error;                        //!< Simplification error in object space units.
+	uint32_t m_numIndices;
+	bgfx::IndexBufferHandle m_ibh;
+	stl::vector<uint32_t> m_primRanges;   //!< Start index and number of indices per primitive.
+};
+
+typedef stl::vector<MeshLod> MeshLodArray;
+
+/// LOD selection for Mesh::submit. Coarsest LOD whose simplification error projects to no
+/// more than m_maxPixelError pixels is used.
+struct MeshLodSelect
+{
+	bx::Vec3 m_eye;           //!< Camera position in world space.
+	float m_pixelsPerUnit;    //!< Pixels per world unit at distance 1, see meshLodPixelsPerUnit.
+	float m_maxPixelError;
+};
+
 struct Group
 {
 	Group();
@@ -105,31 +146,63 @@ struct Group
 	
 	bgfx::VertexBufferHandle m_vbh;
 	bgfx::IndexBufferHandle m_ibh;
-	uint16_t m_numVertices;
+	uint32_t m_numVertices;
 	uint8_t* m_vertices;
 	uint32_t m_numIndices;
 	uint16_t* m_indices;
+	uint32_t* m_indices32;
 	Sphere m_sphere;
 	Aabb m_aabb;
 	Obb m_obb;
 	PrimitiveArray m_prims;
+	MeshletArray m_meshlets;
+	stl::vector<uint32_t> m_meshletVertices;
+	stl::vector<uint8_t> m_meshletTriangles;
+	MeshLodArray m_lods;
 };
 typedef stl::vector<Group> GroupArray;
 
+struct MeshFile;
+struct MeshLoader;
+
 struct Mesh
 {
+	Mesh();
 	void load(bx::ReaderSeekerI* _reader, bool _ramcopy);
 	void unload();
 	void submit(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state) const;
+	void submit(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state, const MeshLodSelect& _lod) const;
+
+	/// Submits only groups whose bounding sphere overlaps view frustum.
+	void submitCulled(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, const float* _viewProj, uint64_t _state = BGFX_STATE_MASK) const;
+
+	/// Culls _numInstances transforms (4x4 matrices in _mtx) per group, and submits one
+	/// instanced draw call per group with visible instance transforms in instance data
+	/// (i_data0-3). Returns number of instances drawn, summed over groups.
+	uint32_t submitInstanced(bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint16_t _numInstances, const float* _viewProj, uint64_t _state = BGFX_STATE_MASK) const;
+
+	/// Same as above, visible instances are culled once per group and drawn in every pass.
+	uint32_t submitInstanced(const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint16_t _numInstances, const float* _viewProj) const;
 	void submit(const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint16_t _numMatrices) const;
 
 	bgfx::VertexLayout m_layout;
 	GroupArray m_groups;
+	MeshFile* m_file;     //!< File image kept alive by ram copy, NULL otherwise.
+	MeshLoader* m_loader; //!< Pending async load, NULL once loaded.
 };
 
-///
+/// Reads whole file once and creates uncompressed vertex/index buffers by reference into
+/// file image, compressed buffers are decoded straight into bgfx memory.
 Mesh* meshLoad(const char* _filePath, bool _ramcopy = false);
 
+/// Loads mesh on worker thread. Returned mesh has no groups until they are published by
+/// meshLoadAsyncUpdate.
+Mesh* meshLoadAsync(const char* _filePath, bool _ramcopy = false);
+
+/// Publishes groups loaded so far by meshLoadAsync into mesh. Returns true once mesh is
+/// fully loaded.
+bool meshLoadAsyncUpdate(Mesh* _mesh);
+
 ///
 void meshUnload(Mesh* _mesh);
 
@@ -142,6 +215,12 @@ void meshStateDestroy(MeshState* _meshState);
 ///
 void meshSubmit(const Mesh* _mesh, bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, uint64_t _state = BGFX_STATE_MASK);
 
+/// Submits mesh with per group LOD selected from projected simplification error.
+void meshSubmit(const Mesh* _mesh, bgfx::ViewId _id, bgfx::ProgramHandle _program, const float* _mtx, const MeshLodSelect& _lod, uint64_t _state = BGFX_STATE_MASK);
+
+/// Returns MeshLodSelect::m_pixelsPerUnit for projection matrix and viewport height.
+float meshLodPixelsPerUnit(const float* _proj, uint16_t _height);
+
 ///
 void meshSubmit(const Mesh* _mesh, const MeshState*const* _state, uint8_t _numPasses, const float* _mtx, uint16_t _numMatrices = 1);
 
@@ -5,6 +5,8 @@
 
 #include <bx/rng.h>
 #include <bx/math.h>
+#include <bx/simd_t.h>
+#include <bx/thread.h>
 #include "bounds.h"
 
 using namespace bx;
@@ -1074,6 +1076,242 @@ Vec3 intersectPlanes(const Plane& _pa, const Plane& _pb, const Plane& _pc)
 	return result;
 }
 
+// Planes are splatted once per batch, normal xyz, distance, and abs normal xyz for AABB
+// projected extents.
+constexpr uint32_t kCullMaxPlanes  = 16;
+constexpr uint32_t kCullMaxThreads = 16;
+
+struct CullPlanes
+{
+	simd128_t normalX[kCullMaxPlanes];
+	simd128_t normalY[kCullMaxPlanes];
+	simd128_t normalZ[kCullMaxPlanes];
+	simd128_t dist[kCullMaxPlanes];
+	simd128_t absNormalX[kCullMaxPlanes];
+	simd128_t absNormalY[kCullMaxPlanes];
+	simd128_t absNormalZ[kCullMaxPlanes];
+	uint32_t  num;
+};
+
+struct CullJob
+{
+	uint32_t*         outVisible;
+	const CullPlanes* planes;
+	const Sphere*     spheres;
+	const Aabb*       aabbs;
+	uint32_t          num;
+	uint32_t          begin;
+	uint32_t          end;
+};
+
+static void cullPlanesLoad(CullPlanes& _outPlanes, const Plane* _planes, uint32_t _numPlanes)
+{
+	BX_ASSERT(_numPlanes <= kCullMaxPlanes, "Too many planes %d (max %d).", _numPlanes, kCullMaxPlanes);
+	_outPlanes.num = min(_numPlanes, kCullMaxPlanes);
+
+	for (uint32_t ii = 0; ii < _outPlanes.num; ++ii)
+	{
+		const Plane& plane = _planes[ii];
+		_outPlanes.normalX[ii]    = simd_splat<simd128_t>(plane.normal.x);
+		_outPlanes.normalY[ii]    = simd_splat<simd128_t>(plane.normal.y);
+		_outPlanes.normalZ[ii]    = simd_splat<simd128_t>(plane.normal.z);
+		_outPlanes.dist[ii]       = simd_splat<simd128_t>(plane.dist);
+		_outPlanes.absNormalX[ii] = simd_splat<simd128_t>(abs(plane.normal.x) );
+		_outPlanes.absNormalY[ii] = simd_splat<simd128_t>(abs(plane.normal.y) );
+		_outPlanes.absNormalZ[ii] = simd_splat<simd128_t>(abs(plane.normal.z) );
+	}
+}
+
+// Tests 4 shapes starting at _idx, past the end shapes are replaced by the last one and
+// their bits are masked off by caller.
+static uint32_t cullSpheres4(const CullPlanes& _planes, const Sphere* _spheres, uint32_t _idx, uint32_t _num)
+{
+	const Sphere& s0 = _spheres[_idx];
+	const Sphere& s1 = _spheres[min(_idx+1, _num-1)];
+	const Sphere& s2 = _spheres[min(_idx+2, _num-1)];
+	const Sphere& s3 = _spheres[min(_idx+3, _num-1)];
+
+	const simd128_t centerX   = simd_ld<simd128_t>(s0.center.x, s1.center.x, s2.center.x, s3.center.x);
+	const simd128_t centerY   = simd_ld<simd128_t>(s0.center.y, s1.center.y, s2.center.y, s3.center.y);
+	const simd128_t centerZ   = simd_ld<simd128_t>(s0.center.z, s1.center.z, s2.center.z, s3.center.z);
+	const simd128_t negRadius = simd_ld<simd128_t>(-s0.radius, -s1.radius, -s2.radius, -s3.radius);
+
+	simd128_t outside = simd_zero<simd128_t>();
+
+	for (uint32_t ii = 0; ii < _planes.num; ++ii)
+	{
+		const simd128_t dist = simd_madd(_planes.normalX[ii], centerX
+			, simd_madd(_planes.normalY[ii], centerY
+			, simd_madd(_planes.normalZ[ii], centerZ, _planes.dist[ii]) ) );
+		outside = simd_or(outside, simd_cmplt(dist, negRadius) );
+	}
+
+	return ~simd_signbitsmask(outside) & 0xf;
+}
+
+static uint32_t cullAabbs4(const CullPlanes& _planes, const Aabb* _aabbs, uint32_t _idx, uint32_t _num)
+{
+	const Aabb& a0 = _aabbs[_idx];
+	const Aabb& a1 = _aabbs[min(_idx+1, _num-1)];
+	const Aabb& a2 = _aabbs[min(_idx+2, _num-1)];
+	const Aabb& a3 = _aabbs[min(_idx+3, _num-1)];
+
+	const simd128_t half = simd_splat<simd128_t>(0.5f);
+
+	const simd128_t minX = simd_ld<simd128_t>(a0.min.x, a1.min.x, a2.min.x, a3.min.x);
+	const simd128_t minY = simd_ld<simd128_t>(a0.min.y, a1.min.y, a2.min.y, a3.min.y);
+	const simd128_t minZ = simd_ld<simd128_t>(a0.min.z, a1.min.z, a2.min.z, a3.min.z);
+	const simd128_t maxX = simd_ld<simd128_t>(a0.max.x, a1.max.x, a2.max.x, a3.max.x);
+	const simd128_t maxY = simd_ld<simd128_t>(a0.max.y, a1.max.y, a2.max.y, a3.max.y);
+	const simd128_t maxZ = simd_ld<simd128_t>(a0.max.z, a1.max.z, a2.max.z, a3.max.z);
+
+	const simd128_t centerX  = simd_mul(simd_add(minX, maxX), half);
+	const simd128_t centerY  = simd_mul(simd_add(minY, maxY), half);
+	const simd128_t centerZ  = simd_mul(simd_add(minZ, maxZ), half);
+	const simd128_t extentsX = simd_mul(simd_sub(maxX, minX), half);
+	const simd128_t extentsY = simd_mul(simd_sub(maxY, minY), half);
+	const simd128_t extentsZ = simd_mul(simd_sub(maxZ, minZ), half);
+
+	simd128_t outside = simd_zero<simd128_t>();
+
+	// Box is outside of plane when its center is further behind the plane than its
+	// extents projected onto plane normal.
+	for (uint32_t ii = 0; ii < _planes.num; ++ii)
+	{
+		const simd128_t dist = simd_madd(_planes.normalX[ii], centerX
+			, simd_madd(_planes.normalY[ii], centerY
+			, simd_madd(_planes.normalZ[ii], centerZ, _planes.dist[ii]) ) );
+		const simd128_t radius = simd_madd(_planes.absNormalX[ii], extentsX
+			, simd_madd(_planes.absNormalY[ii], extentsY
+			, simd_mul(_planes.absNormalZ[ii], extentsZ) ) );
+		outside = simd_or(outside, simd_cmplt(simd_add(dist, radius), simd_zero<simd128_t>() ) );
+	}
+
+	return ~simd_signbitsmask(outside) & 0xf;
+}
+
+static void cullRange(const CullJob& _job)
+{
+	if (_job.begin >= _job.end)
+	{
+		return;
+	}
+
+	for (uint32_t word = _job.begin/32, wordEnd = (_job.end+31)/32; word < wordEnd; ++word)
+	{
+		const uint32_t begin = word*32;
+		const uint32_t end   = min(begin+32, _job.num);
+
+		uint32_t visible = 0;
+		for (uint32_t ii = begin; ii < end; ii += 4)
+		{
+			const uint32_t mask = NULL != _job.spheres
+				? cullSpheres4(*_job.planes, _job.spheres, ii, _job.num)
+				: cullAabbs4(*_job.planes, _job.aabbs, ii, _job.num)
+				;
+			const uint32_t numValid = min(end-ii, 4u);
+			visible |= (mask & ( (1u<<numValid)-1) ) << (ii-begin);
+		}
+
+		_job.outVisible[word] = visible;
+	}
+}
+
+static int32_t cullThreadFunc(Thread* _thread, void* _userData)
+{
+	BX_UNUSED(_thread);
+	cullRange(*(const CullJob*)_userData);
+	return 0;
+}
+
+static void cullDispatch(const CullJob& _job, uint32_t _numThreads)
+{
+	const uint32_t numWords = (_job.num+31)/32;
+	const uint32_t maxThreads = clamp(_numThreads, 1u, min(numWords, kCullMaxThreads) );
+
+	if (1 >= maxThreads)
+	{
+		cullRange(_job);
+		return;
+	}
+
+	// Ranges are split on bitmask word boundary, so that threads never write the same word.
+	// Thread count is recalculated from rounded up words per thread, so that no thread
+	// gets empty range.
+	const uint32_t wordsPerThread = (numWords + maxThreads - 1)/maxThreads;
+	const uint32_t numThreads     = (numWords + wordsPerThread - 1)/wordsPerThread;
+
+	CullJob job[kCullMaxThreads];
+	Thread  thread[kCullMaxThreads];
+
+	for (uint32_t ii = 0; ii < numThreads; ++ii)
+	{
+		job[ii]       = _job;
+		job[ii].begin = min(ii*wordsPerThread*32, _job.num);
+		job[ii].end   = min( (ii+1)*wordsPerThread*32, _job.num);
+	}
+
+	for (uint32_t ii = 1; ii < numThreads; ++ii)
+	{
+		if (!thread[ii].init(cullThreadFunc, &job[ii], 0, "cull") )
+		{
+			cullRange(job[ii]);
+		}
+	}
+
+	cullRange(job[0]);
+
+	for (uint32_t ii = 1; ii < numThreads; ++ii)
+	{
+		if (thread[ii].isRunning() )
+		{
+			thread[ii].shutdown();
+		}
+	}
+}
+
+void cullSpheres(uint32_t* _outVisible, const Plane* _planes, uint32_t _numPlanes, const Sphere* _spheres, uint32_t _num, uint32_t _numThreads)
+{
+	if (0 == _num)
+	{
+		return;
+	}
+
+	CullPlanes planes;
+	cullPlanesLoad(planes, _planes, _numPlanes);
+
+	CullJob job;
+	job.outVisible = _outVisible;
+	job.planes     = &planes;
+	job.spheres    = _spheres;
+	job.aabbs      = NULL;
+	job.num        = _num;
+	job.begin      = 0;
+	job.end        = _num;
+	cullDispatch(job, _numThreads);
+}
+
+void cullAabbs(uint32_t* _outVisible, const Plane* _planes, uint32_t _numPlanes, const Aabb* _aabbs, uint32_t _num, uint32_t _numThreads)
+{
+	if (0 == _num)
+	{
+		return;
+	}
+
+	CullPlanes planes;
+	cullPlanesLoad(planes, _planes, _numPlanes);
+
+	CullJob job;
+	job.outVisible = _outVisible;
+	job.planes     = &planes;
+	job.spheres    = NULL;
+	job.aabbs      = _aabbs;
+	job.num        = _num;
+	job.begin      = 0;
+	job.end        = _num;
+	cullDispatch(job, _numThreads);
+}
+
 struct LineSegment
 {
 	Vec3 pos;
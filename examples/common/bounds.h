@@ -145,6 +145,15 @@ void buildFrustumPlanes(bx::Plane* _outPlanes, const float* _viewProj);
 /// Returns point from 3 intersecting planes.
 bx::Vec3 intersectPlanes(const bx::Plane& _pa, const bx::Plane& _pb, const bx::Plane& _pc);
 
+/// Tests _num spheres against up to 16 planes (e.g. from buildFrustumPlanes), and sets bit
+/// ii of _outVisible when sphere ii isn't fully behind any of the planes. _outVisible must
+/// hold (_num+31)/32 words. With _numThreads > 1 work is split between threads created
+/// for the call, which pays off only for large batches.
+void cullSpheres(uint32_t* _outVisible, const bx::Plane* _planes, uint32_t _numPlanes, const Sphere* _spheres, uint32_t _num, uint32_t _numThreads = 1);
+
+/// Same as cullSpheres, for axis aligned bounding boxes.
+void cullAabbs(uint32_t* _outVisible, const bx::Plane* _planes, uint32_t _numPlanes, const Aabb* _aabbs, uint32_t _num, uint32_t _numThreads = 1);
+
 /// Make screen space ray from x, y coordinate and inverse view-projection matrix.
 Ray makeRay(float _x, float _y, const float* _invVp);
 
@@ -0,0 +1,513 @@
+/*
+ * Copyright 2011-2021 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx#license-bsd-2-clause
+ */
+
+#include <bx/math.h>
+#include "bvh.h"
+
+using namespace bx;
+
+constexpr uint32_t kBvhNumBins  = 8;
+constexpr uint32_t kBvhMaxDepth = 64;
+
+static void aabbEmpty(Aabb& _outAabb)
+{
+	_outAabb.min = {  kFloatMax,  kFloatMax,  kFloatMax };
+	_outAabb.max = { -kFloatMax, -kFloatMax, -kFloatMax };
+}
+
+static void aabbMerge(Aabb& _outAabb, const Aabb& _aabb)
+{
+	_outAabb.min = min(_outAabb.min, _aabb.min);
+	_outAabb.max = max(_outAabb.max, _aabb.max);
+}
+
+static float getAxis(const Vec3& _vec, uint32_t _axis)
+{
+	return 0 == _axis ? _vec.x : 1 == _axis ? _vec.y : _vec.z;
+}
+
+struct BvhBin
+{
+	Aabb     aabb;
+	uint32_t num;
+};
+
+struct BvhSplit
+{
+	uint32_t axis;
+	uint32_t bin;    //!< Primitives in bins [0, bin] go to left child.
+	float    cost;
+	float    centroidMin;
+	float    binScale;
+};
+
+static uint32_t binIndex(float _centroid, float _centroidMin, float _binScale)
+{
+	return min(uint32_t( (_centroid - _centroidMin)*_binScale), kBvhNumBins-1);
+}
+
+static void findSplit(BvhSplit& _outSplit, const Bvh& _bvh, const Vec3* _centroids, const BvhNode& _node)
+{
+	Aabb centroidAabb;
+	aabbEmpty(centroidAabb);
+
+	for (uint32_t ii = 0; ii < _node.m_numPrims; ++ii)
+	{
+		const Vec3& centroid = _centroids[_bvh.m_primIdx[_node.m_leftFirst + ii] ];
+		centroidAabb.min = min(centroidAabb.min, centroid);
+		centroidAabb.max = max(centroidAabb.max, centroid);
+	}
+
+	_outSplit.cost = kFloatMax;
+
+	for (uint32_t axis = 0; axis < 3; ++axis)
+	{
+		const float axisMin = getAxis(centroidAabb.min, axis);
+		const float axisMax = getAxis(centroidAabb.max, axis);
+
+		if (axisMax - axisMin <= kFloatSmallest)
+		{
+			continue;
+		}
+
+		BvhBin bin[kBvhNumBins];
+		for (uint32_t ii = 0; ii < kBvhNumBins; ++ii)
+		{
+			aabbEmpty(bin[ii].aabb);
+			bin[ii].num = 0;
+		}
+
+		const float binScale = float(kBvhNumBins)/(axisMax - axisMin);
+
+		for (uint32_t ii = 0; ii < _node.m_numPrims; ++ii)
+		{
+			const uint32_t primIdx = _node.m_leftFirst + ii;
+			const uint32_t idx     = binIndex(getAxis(_centroids[_bvh.m_primIdx[primIdx] ], axis), axisMin, binScale);
+			aabbMerge(bin[idx].aabb, _bvh.m_primAabb[primIdx]);
+			++bin[idx].num;
+		}
+
+		// Sweep from both sides, left side cost of plane ii covers bins [0, ii], right
+		// side bins [ii+1, kBvhNumBins).
+		float leftArea[kBvhNumBins-1];
+		uint32_t leftNum[kBvhNumBins-1];
+
+		Aabb aabb;
+		aabbEmpty(aabb);
+		uint32_t num = 0;
+
+		for (uint32_t ii = 0; ii < kBvhNumBins-1; ++ii)
+		{
+			num += bin[ii].num;
+			aabbMerge(aabb, bin[ii].aabb);
+			leftNum[ii]  = num;
+			leftArea[ii] = 0 < num ? calcAreaAabb(aabb) : 0.0f;
+		}
+
+		aabbEmpty(aabb);
+		num = 0;
+
+		for (uint32_t ii = kBvhNumBins-1; ii > 0; --ii)
+		{
+			num += bin[ii].num;
+			aabbMerge(aabb, bin[ii].aabb);
+
+			const float rightArea = 0 < num ? calcAreaAabb(aabb) : 0.0f;
+			const float cost      = leftNum[ii-1]*leftArea[ii-1] + num*rightArea;
+
+			if (0 < leftNum[ii-1]
+			&&  0 < num
+			&&  cost < _outSplit.cost)
+			{
+				_outSplit.axis        = axis;
+				_outSplit.bin         = ii-1;
+				_outSplit.cost        = cost;
+				_outSplit.centroidMin = axisMin;
+				_outSplit.binScale    = binScale;
+			}
+		}
+	}
+}
+
+static void updateNodeAabb(Bvh& _bvh, BvhNode& _node)
+{
+	aabbEmpty(_node.m_aabb);
+
+	for (uint32_t ii = 0; ii < _node.m_numPrims; ++ii)
+	{
+		aabbMerge(_node.m_aabb, _bvh.m_primAabb[_node.m_leftFirst + ii]);
+	}
+}
+
+// Builds hierarchy from m_primAabb in original order, and reorders primitive arrays into
+// leaf order.
+static void buildNodes(Bvh& _bvh, const Vec3* _centroids, uint32_t _num)
+{
+	_bvh.m_primIdx.resize(_num);
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		_bvh.m_primIdx[ii] = ii;
+	}
+
+	// Full binary tree with _num leaves has 2*_num-1 nodes, node 1 is unused so that
+	// siblings start at even index.
+	_bvh.m_nodes.resize(bx::max<uint32_t>(2*_num, 2) );
+
+	BvhNode& root = _bvh.m_nodes[0];
+	root.m_leftFirst = 0;
+	root.m_numPrims  = _num;
+
+	// Primitive bounds are permuted together with primitive indices while partitioning.
+	updateNodeAabb(_bvh, root);
+
+	uint32_t numNodes = 2;
+
+	struct Entry
+	{
+		uint32_t node;
+		uint32_t depth;
+	};
+
+	Entry stack[kBvhMaxDepth];
+	uint32_t top = 0;
+	stack[top++] = { 0, 0 };
+
+	while (0 < top)
+	{
+		const Entry entry = stack[--top];
+		BvhNode& node = _bvh.m_nodes[entry.node];
+
+		if (2 >= node.m_numPrims
+		||  kBvhMaxDepth-1 <= entry.depth)
+		{
+			continue;
+		}
+
+		BvhSplit split;
+		findSplit(split, _bvh, _centroids, node);
+
+		// Leaf cost is number of primitives times node area, intersection and traversal
+		// costs are assumed equal.
+		if (split.cost >= node.m_numPrims*calcAreaAabb(node.m_aabb) )
+		{
+			continue;
+		}
+
+		uint32_t ii = node.m_leftFirst;
+		uint32_t jj = node.m_leftFirst + node.m_numPrims;
+
+		while (ii < jj)
+		{
+			const float centroid = getAxis(_centroids[_bvh.m_primIdx[ii] ], split.axis);
+
+			if (binIndex(centroid, split.centroidMin, split.binScale) <= split.bin)
+			{
+				++ii;
+			}
+			else
+			{
+				--jj;
+				bx::swap(_bvh.m_primIdx[ii],  _bvh.m_primIdx[jj]);
+				bx::swap(_bvh.m_primAabb[ii], _bvh.m_primAabb[jj]);
+			}
+		}
+
+		const uint32_t numLeft = ii - node.m_leftFirst;
+
+		const uint32_t leftIdx = numNodes;
+		numNodes += 2;
+
+		BvhNode& left  = _bvh.m_nodes[leftIdx];
+		BvhNode& right = _bvh.m_nodes[leftIdx+1];
+
+		left.m_leftFirst  = node.m_leftFirst;
+		left.m_numPrims   = numLeft;
+		right.m_leftFirst = ii;
+		right.m_numPrims  = node.m_numPrims - numLeft;
+
+		updateNodeAabb(_bvh, left);
+		updateNodeAabb(_bvh, right);
+
+		node.m_leftFirst = leftIdx;
+		node.m_numPrims  = 0;
+
+		stack[top++] = { leftIdx,   entry.depth+1 };
+		stack[top++] = { leftIdx+1, entry.depth+1 };
+	}
+
+	_bvh.m_nodes.resize(numNodes);
+}
+
+static void refitNodes(Bvh& _bvh)
+{
+	// Children are always stored after their parent.
+	for (uint32_t ii = uint32_t(_bvh.m_nodes.size() ); ii-- > 0;)
+	{
+		if (1 == ii)
+		{
+			continue;
+		}
+
+		BvhNode& node = _bvh.m_nodes[ii];
+
+		if (0 < node.m_numPrims)
+		{
+			updateNodeAabb(_bvh, node);
+		}
+		else
+		{
+			node.m_aabb = _bvh.m_nodes[node.m_leftFirst].m_aabb;
+			aabbMerge(node.m_aabb, _bvh.m_nodes[node.m_leftFirst+1].m_aabb);
+		}
+	}
+}
+
+Bvh::Bvh()
+{
+}
+
+void Bvh::build(const Aabb* _aabbs, uint32_t _num)
+{
+	m_nodes.clear();
+	m_triangles.clear();
+
+	if (0 == _num)
+	{
+		return;
+	}
+
+	m_primAabb.resize(_num);
+	stl::vector<Vec3> centroids;
+	centroids.resize(_num);
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		m_primAabb[ii] = _aabbs[ii];
+		centroids[ii]  = getCenter(_aabbs[ii]);
+	}
+
+	buildNodes(*this, centroids.data(), _num);
+}
+
+void Bvh::build(const Triangle* _triangles, uint32_t _num)
+{
+	m_nodes.clear();
+	m_triangles.clear();
+
+	if (0 == _num)
+	{
+		return;
+	}
+
+	m_primAabb.resize(_num);
+	stl::vector<Vec3> centroids;
+	centroids.resize(_num);
+
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		toAabb(m_primAabb[ii], _triangles[ii]);
+		centroids[ii] = getCenter(m_primAabb[ii]);
+	}
+
+	buildNodes(*this, centroids.data(), _num);
+
+	m_triangles.resize(_num);
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		m_triangles[ii] = _triangles[m_primIdx[ii] ];
+	}
+}
+
+void Bvh::refit(const Aabb* _aabbs)
+{
+	for (uint32_t ii = 0, num = uint32_t(m_primIdx.size() ); ii < num; ++ii)
+	{
+		m_primAabb[ii] = _aabbs[m_primIdx[ii] ];
+	}
+
+	refitNodes(*this);
+}
+
+void Bvh::refit(const Triangle* _triangles)
+{
+	for (uint32_t ii = 0, num = uint32_t(m_primIdx.size() ); ii < num; ++ii)
+	{
+		m_triangles[ii] = _triangles[m_primIdx[ii] ];
+		toAabb(m_primAabb[ii], m_triangles[ii]);
+	}
+
+	refitNodes(*this);
+}
+
+// Returns ray parameter at which ray enters AABB, or kFloatMax if ray misses it or enters
+// it after _tmax.
+static float intersectNode(const Ray& _ray, const Vec3& _invDir, const Aabb& _aabb, float _tmax)
+{
+	const Vec3 t0 = mul(sub(_aabb.min, _ray.pos), _invDir);
+	const Vec3 t1 = mul(sub(_aabb.max, _ray.pos), _invDir);
+
+	const Vec3 tmin = min(t0, t1);
+	const Vec3 tmax = max(t0, t1);
+
+	const float enter = max(tmin.x, tmin.y, tmin.z);
+	const float exit  = min(tmax.x, tmax.y, tmax.z);
+
+	return exit >= max(enter, 0.0f) && enter < _tmax ? enter : kFloatMax;
+}
+
+uint32_t Bvh::intersect(const Ray& _ray, Hit* _hit) const
+{
+	if (m_nodes.empty() )
+	{
+		return UINT32_MAX;
+	}
+
+	const Vec3  invDir   = { 1.0f/_ray.dir.x, 1.0f/_ray.dir.y, 1.0f/_ray.dir.z };
+	const float invDirSq = 1.0f/dot(_ray.dir, _ray.dir);
+
+	float    best    = kFloatMax;
+	uint32_t bestIdx = UINT32_MAX;
+	Hit      bestHit;
+
+	if (kFloatMax == intersectNode(_ray, invDir, m_nodes[0].m_aabb, best) )
+	{
+		return UINT32_MAX;
+	}
+
+	uint32_t stack[kBvhMaxDepth];
+	uint32_t top  = 0;
+	uint32_t node = 0;
+
+	for (;;)
+	{
+		const BvhNode& current = m_nodes[node];
+
+		if (0 < current.m_numPrims)
+		{
+			for (uint32_t ii = current.m_leftFirst, end = ii + current.m_numPrims; ii < end; ++ii)
+			{
+				Hit hit;
+				const bool isHit = isTriangles()
+					? ::intersect(_ray, m_triangles[ii], &hit)
+					: ::intersect(_ray, m_primAabb[ii], &hit)
+					;
+
+				if (isHit)
+				{
+					const float tt = dot(sub(hit.pos, _ray.pos), _ray.dir)*invDirSq;
+					if (tt < best)
+					{
+						best    = tt;
+						bestIdx = m_primIdx[ii];
+						bestHit = hit;
+					}
+				}
+			}
+		}
+		else
+		{
+			// Visit closer child first, and skip subtrees entered beyond the closest hit.
+			uint32_t nearIdx = current.m_leftFirst;
+			uint32_t farIdx  = current.m_leftFirst+1;
+			float    tnear   = intersectNode(_ray, invDir, m_nodes[nearIdx].m_aabb, best);
+			float    tfar    = intersectNode(_ray, invDir, m_nodes[farIdx].m_aabb,  best);
+
+			if (tfar < tnear)
+			{
+				bx::swap(nearIdx, farIdx);
+				bx::swap(tnear,   tfar);
+			}
+
+			if (kFloatMax != tnear)
+			{
+				if (kFloatMax != tfar)
+				{
+					stack[top++] = farIdx;
+				}
+
+				node = nearIdx;
+				continue;
+			}
+		}
+
+		if (0 == top)
+		{
+			break;
+		}
+
+		node = stack[--top];
+	}
+
+	if (NULL != _hit
+	&&  UINT32_MAX != bestIdx)
+	{
+		*_hit = bestHit;
+	}
+
+	return bestIdx;
+}
+
+template<typename Ty>
+static uint32_t overlapQuery(const Bvh& _bvh, const Ty& _shape, uint32_t* _outIndices, uint32_t _max)
+{
+	if (_bvh.m_nodes.empty()
+	||  0 == _max)
+	{
+		return 0;
+	}
+
+	uint32_t num = 0;
+
+	uint32_t stack[kBvhMaxDepth];
+	uint32_t top = 0;
+	stack[top++] = 0;
+
+	while (0 < top)
+	{
+		const BvhNode& node = _bvh.m_nodes[stack[--top] ];
+
+		if (!::overlap(node.m_aabb, _shape) )
+		{
+			continue;
+		}
+
+		if (0 == node.m_numPrims)
+		{
+			stack[top++] = node.m_leftFirst;
+			stack[top++] = node.m_leftFirst+1;
+			continue;
+		}
+
+		for (uint32_t ii = node.m_leftFirst, end = ii + node.m_numPrims; ii < end; ++ii)
+		{
+			const bool isOverlap = _bvh.isTriangles()
+				? ::overlap(_bvh.m_triangles[ii], _shape)
+				: ::overlap(_bvh.m_primAabb[ii],  _shape)
+				;
+
+			if (isOverlap)
+			{
+				_outIndices[num++] = _bvh.m_primIdx[ii];
+
+				if (num == _max)
+				{
+					return num;
+				}
+			}
+		}
+	}
+
+	return num;
+}
+
+uint32_t Bvh::overlap(const Aabb& _aabb, uint32_t* _outIndices, uint32_t _max) const
+{
+	return overlapQuery(*this, _aabb, _outIndices, _max);
+}
+
+uint32_t Bvh::overlap(const Sphere& _sphere, uint32_t* _outIndices, uint32_t _max) const
+{
+	return overlapQuery(*this, _sphere, _outIndices, _max);
+}
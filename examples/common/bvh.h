@@ -0,0 +1,68 @@
+/*
+ * Copyright 2011-2021 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx#license-bsd-2-clause
+ */
+
+#ifndef BVH_H_HEADER_GUARD
+#define BVH_H_HEADER_GUARD
+
+#include "bounds.h"
+
+#include <tinystl/allocator.h>
+#include <tinystl/vector.h>
+namespace stl = tinystl;
+
+/// 32 byte BVH node. Inner node children are adjacent (m_leftFirst, m_leftFirst+1), and
+/// start at even index, so that both siblings share cache line.
+struct BvhNode
+{
+	Aabb     m_aabb;
+	uint32_t m_leftFirst; //!< Left child index for inner node, first primitive for leaf.
+	uint32_t m_numPrims;  //!< Zero for inner node.
+};
+
+BX_STATIC_ASSERT(sizeof(BvhNode) == 32);
+
+/// Bounding volume hierarchy built with binned surface area heuristic, over primitive
+/// bounds (scene objects) or over triangles.
+struct Bvh
+{
+	///
+	Bvh();
+
+	/// Builds BVH over object bounds. Queries test primitive AABB.
+	void build(const Aabb* _aabbs, uint32_t _num);
+
+	/// Builds BVH over triangles. Queries test triangles.
+	void build(const Triangle* _triangles, uint32_t _num);
+
+	/// Updates node bounds after primitives moved, hierarchy is kept. Quality degrades
+	/// when primitives move far from their original positions, rebuild in that case.
+	void refit(const Aabb* _aabbs);
+
+	///
+	void refit(const Triangle* _triangles);
+
+	/// Returns index of the closest primitive hit by ray, or UINT32_MAX.
+	uint32_t intersect(const Ray& _ray, Hit* _hit = NULL) const;
+
+	/// Writes up to _max indices of primitives overlapping AABB into _outIndices. Returns
+	/// number of indices written.
+	uint32_t overlap(const Aabb& _aabb, uint32_t* _outIndices, uint32_t _max) const;
+
+	///
+	uint32_t overlap(const Sphere& _sphere, uint32_t* _outIndices, uint32_t _max) const;
+
+	///
+	bool isTriangles() const
+	{
+		return !m_triangles.empty();
+	}
+
+	stl::vector<BvhNode>  m_nodes;
+	stl::vector<uint32_t> m_primIdx;   //!< Original primitive index, in leaf order.
+	stl::vector<Aabb>     m_primAabb;  //!< Primitive bounds, in leaf order.
+	stl::vector<Triangle> m_triangles; //!< Triangles, in leaf order. Empty for bounds BVH.
+};
+
+#endif // BVH_H_HEADER_GUARD
@@ -975,6 +975,16 @@ restart:
 		return s_fileWriter;
 	}
 
+	bx::FileReaderI* createFileReader()
+	{
+		return BX_NEW(getAllocator(), FileReader);
+	}
+
+	void destroyFileReader(bx::FileReaderI* _reader)
+	{
+		BX_DELETE(getAllocator(), _reader);
+	}
+
 	bx::AllocatorI* getAllocator()
 	{
 		if (NULL == g_allocator)
@@ -248,6 +248,11 @@ namespace entry
 	bx::FileWriterI* getFileWriter();
 	bx::AllocatorI*  getAllocator();
 
+	/// Creates file reader that resolves paths like getFileReader, but is not shared, so
+	/// it can be used from worker threads.
+	bx::FileReaderI* createFileReader();
+	void destroyFileReader(bx::FileReaderI* _reader);
+
 	WindowHandle createWindow(int32_t _x, int32_t _y, uint32_t _width, uint32_t _height, uint32_t _flags = ENTRY_WINDOW_FLAG_NONE, const char* _title = "");
 	void destroyWindow(WindowHandle _handle);
 	void setWindowPos(WindowHandle _handle, int32_t _x, int32_t _y);
@@ -420,6 +420,7 @@ namespace bgfx
 	BGFX_HANDLE(ProgramHandle)
 	BGFX_HANDLE(ShaderHandle)
 	BGFX_HANDLE(TextureHandle)
+	BGFX_HANDLE(UniformGroupHandle)
 	BGFX_HANDLE(UniformHandle)
 	BGFX_HANDLE(VertexBufferHandle)
 	BGFX_HANDLE(VertexLayoutHandle)
@@ -701,6 +702,7 @@ namespace bgfx
 			uint32_t minResourceCbSize; //!< Minimum resource command buffer size.
 			uint32_t transientVbSize;   //!< Maximum transient vertex buffer size.
 			uint32_t transientIbSize;   //!< Maximum transient index buffer size.
+			uint8_t  numFrames;         //!< Number of frames in flight between API and render thread.
 		};
 
 		Limits limits; // Configurable runtime limits.
@@ -872,6 +874,19 @@ namespace bgfx
 		VertexBufferHandle handle; //!< Vertex buffer object handle.
 	};
 
+	/// Caller owned scratch memory for `bgfx::topologySortTriList`. It also
+	///   keeps triangle order of previous sort, which is used as starting
+	///   point for the next sort.
+	///
+	/// @attention C99 equivalent is `bgfx_topology_sort_scratch_t`.
+	///
+	struct TopologySortScratch
+	{
+		void*    data;             //!< Scratch memory, see `bgfx::topologySortTriListScratchSize`.
+		uint32_t size;             //!< Scratch memory size in bytes.
+		uint32_t num;              //!< Number of triangles in previous order, set to 0 to discard it.
+	};
+
 	/// Texture info.
 	///
 	/// @attention C99 equivalent is `bgfx_texture_info_t`.
@@ -980,6 +995,7 @@ namespace bgfx
 		int64_t cpuTimeFrame;               //!< CPU time between two `bgfx::frame` calls.
 		int64_t cpuTimeBegin;               //!< Render thread CPU submit begin time.
 		int64_t cpuTimeEnd;                 //!< Render thread CPU submit end time.
+		int64_t cpuTimeSort;                //!< Render thread CPU time spent sorting draw calls (part of submit).
 		int64_t cpuTimerFreq;               //!< CPU timer frequency. Timestamps-per-second
 
 		int64_t gpuTimeBegin;               //!< GPU frame begin time.
@@ -1012,6 +1028,13 @@ namespace bgfx
 		int32_t transientVbUsed;            //!< Amount of transient vertex buffer used.
 		int32_t transientIbUsed;            //!< Amount of transient index buffer used.
 
+		int64_t dynamicVbUsed;              //!< Amount of dynamic vertex buffer memory used.
+		int64_t dynamicVbPeak;              //!< Peak amount of dynamic vertex buffer memory used.
+		int64_t dynamicIbUsed;              //!< Amount of dynamic index buffer memory used.
+		int64_t dynamicIbPeak;              //!< Peak amount of dynamic index buffer memory used.
+		float   dynamicVbFragmentation;     //!< Dynamic vertex buffer free memory fragmentation (0-1).
+		float   dynamicIbFragmentation;     //!< Dynamic index buffer free memory fragmentation (0-1).
+
 		uint32_t numPrims[Topology::Count]; //!< Number of primitives rendered.
 
 		int64_t gpuMemoryMax;               //!< Maximum available GPU memory for application.
@@ -1082,6 +1105,16 @@ namespace bgfx
 			, uint16_t _group
 		);
 
+		/// Set uniform group for draw primitive. Values of `UniformSet::Group`
+		/// uniforms stored in group are applied when group changes between
+		/// draw calls.
+		///
+		/// @param[in] _handle Uniform group handle.
+		///
+		/// @attention C99 equivalent is `bgfx_encoder_set_group`.
+		///
+		void setGroup(UniformGroupHandle _handle);
+
 		/// Set condition for rendering.
 		///
 		/// @param[in] _handle Occlusion query handle.
@@ -1419,6 +1452,71 @@ namespace bgfx
 		///
 		void setInstanceCount(uint32_t _numInstances);
 
+		/// Allocate transient index buffer from encoder's transient page.
+		///
+		/// @param[out] _tib TransientIndexBuffer structure is filled and is valid
+		///   for the duration of frame, and it can be reused for multiple draw
+		///   calls.
+		/// @param[in] _num Number of indices to allocate.
+		/// @param[in] _index32 Set to `true` if input indices will be 32-bit.
+		///
+		/// @remarks
+		///   Unlike `bgfx::allocTransientIndexBuffer` this doesn't take API lock.
+		///   Encoder reserves large pages from frame's transient index buffer,
+		///   and returns unused part of page at `bgfx::end`.
+		///
+		/// @attention C99 equivalent is `bgfx_encoder_alloc_transient_index_buffer`.
+		///
+		void allocTransientIndexBuffer(
+			  TransientIndexBuffer* _tib
+			, uint32_t _num
+			, bool _index32 = false
+			);
+
+		/// Allocate transient vertex buffer from encoder's transient page.
+		///
+		/// @param[out] _tvb TransientVertexBuffer structure is filled and is valid
+		///   for the duration of frame, and it can be reused for multiple draw
+		///   calls.
+		/// @param[in] _num Number of vertices to allocate.
+		/// @param[in] _layout Vertex layout.
+		///
+		/// @remarks
+		///   Unlike `bgfx::allocTransientVertexBuffer` this doesn't take API lock,
+		///   except first time vertex layout is used by encoder in frame.
+		///
+		/// @attention C99 equivalent is `bgfx_encoder_alloc_transient_vertex_buffer`.
+		///
+		void allocTransientVertexBuffer(
+			  TransientVertexBuffer* _tvb
+			, uint32_t _num
+			, const VertexLayout& _layout
+			);
+
+		/// Check for required space and allocate transient vertex and index
+		/// buffers from encoder's transient pages. If both space requirements
+		/// are satisfied function returns true.
+		///
+		/// @param[out] _tvb TransientVertexBuffer structure is filled and is valid
+		///   for the duration of frame.
+		/// @param[in] _layout Vertex layout.
+		/// @param[in] _numVertices Number of vertices to allocate.
+		/// @param[out] _tib TransientIndexBuffer structure is filled and is valid
+		///   for the duration of frame.
+		/// @param[in] _numIndices Number of indices to allocate.
+		/// @param[in] _index32 Set to `true` if input indices will be 32-bit.
+		///
+		/// @attention C99 equivalent is `bgfx_encoder_alloc_transient_buffers`.
+		///
+		bool allocTransientBuffers(
+			  TransientVertexBuffer* _tvb
+			, const VertexLayout& _layout
+			, uint32_t _numVertices
+			, TransientIndexBuffer* _tib
+			, uint32_t _numIndices
+			, bool _index32 = false
+			);
+
 		/// Set texture stage for draw primitive.
 		///
 		/// @param[in] _stage Texture unit.
@@ -1957,6 +2055,52 @@ namespace bgfx
 		, bool _index32
 		);
 
+	/// Sort indices, reusing caller owned scratch memory between calls.
+	///
+	/// @param[in] _sort Sort order, see `TopologySort::Enum`.
+	/// @param[in] _dst Destination index buffer.
+	/// @param[in] _dstSize Destination index buffer in bytes.
+	/// @param[in] _dir Direction (vector must be normalized).
+	/// @param[in] _pos Position.
+	/// @param[in] _vertices Pointer to first vertex represented as
+	///    float x, y, z.
+	/// @param[in] _stride Vertex stride.
+	/// @param[in] _indices Source indices, must be the same between calls
+	///    for previous order to be meaningful.
+	/// @param[in] _numIndices Number of input indices.
+	/// @param[in] _index32 Set to `true` if input indices are 32-bit.
+	/// @param[inout] _scratch Scratch memory. If it's too small, temporary
+	///    memory is allocated, and previous order is discarded.
+	///
+	/// @remarks
+	///   Keys are computed in previous call's triangle order. When camera
+	///   moved only slightly they are nearly sorted, and are sorted
+	///   incrementally with insertion sort. If too many triangles move, it
+	///   falls back to radix sort.
+	///
+	/// @attention C99 equivalent is `bgfx_topology_sort_tri_list_scratch`.
+	///
+	void topologySortTriList(
+		  TopologySort::Enum _sort
+		, void* _dst
+		, uint32_t _dstSize
+		, const float _dir[3]
+		, const float _pos[3]
+		, const void* _vertices
+		, uint32_t _stride
+		, const void* _indices
+		, uint32_t _numIndices
+		, bool _index32
+		, TopologySortScratch& _scratch
+		);
+
+	/// Returns scratch memory size in bytes required to sort `_numIndices`
+	///   indices with `bgfx::topologySortTriList`.
+	///
+	/// @attention C99 equivalent is `bgfx_topology_sort_tri_list_scratch_size`.
+	///
+	uint32_t topologySortTriListScratchSize(uint32_t _numIndices);
+
 	/// Returns supported backend API renderers.
 	///
 	/// @param[in] _max Maximum number of elements in _enum array.
@@ -2571,6 +2715,26 @@ namespace bgfx
 	///
 	ShaderHandle createShader(const Memory* _mem);
 
+	/// Create shader from memory buffer, selecting variant by key when buffer
+	/// contains shader variants.
+	///
+	/// @param[in] _mem Shader binary, or shader variants binary built by shaderc
+	///   from source with `$variant <name> [count]` declarations.
+	/// @param[in] _variantKey Variant key. Axis values are packed as bit fields
+	///   in declaration order, starting from least significant bit, each axis
+	///   taking as many bits as its largest value needs. Bits of axes not
+	///   declared by shader are ignored. Ignored for regular shader binary.
+	///
+	/// @remarks
+	///   `createShader(_mem)` with shader variants binary selects variant 0.
+	///
+	/// @attention C99 equivalent is `bgfx_create_shader_variant`.
+	///
+	ShaderHandle createShader(
+		  const Memory* _mem
+		, uint32_t _variantKey
+		);
+
 	/// Returns the number of uniforms and uniform handles used inside a shader.
 	///
 	/// @param[in] _handle Shader handle.
@@ -2663,6 +2827,27 @@ namespace bgfx
 		, bool _destroyShader = false
 		);
 
+	/// Create program with vertex and fragment shader variants selected by key.
+	///
+	/// @param[in] _vsMem Vertex shader binary, or shader variants binary.
+	/// @param[in] _fsMem Fragment shader binary, or shader variants binary.
+	/// @param[in] _variantKey Variant key, applied to both shaders. See
+	///   `createShader(const Memory*, uint32_t)`. Axes used by both shaders
+	///   must be declared first, and in the same order.
+	/// @returns Program handle. Shaders are destroyed when program is destroyed.
+	///
+	/// @remarks
+	///   Shaders and programs are deduplicated, creating program with the same
+	///   key again returns the same handle. Destroy it once per create call.
+	///
+	/// @attention C99 equivalent is `bgfx_create_program_variant`.
+	///
+	ProgramHandle createProgram(
+		  const Memory* _vsMem
+		, const Memory* _fsMem
+		, uint32_t _variantKey
+		);
+
 	/// Destroy program.
 	///
 	/// @param[in] _handle Program handle.
@@ -2671,6 +2856,21 @@ namespace bgfx
 	///
 	void destroy(ProgramHandle _handle);
 
+	/// Returns true when program is done compiling and linking. Draw and compute calls
+	/// using program which is not ready are skipped by renderer.
+	///
+	/// @param[in] _handle Program handle.
+	///
+	/// @remarks
+	///   Only OpenGL renderer built with `BGFX_CONFIG_RENDERER_OPENGL_ASYNC_PROGRAM`
+	///   creates programs asynchronously, other renderers report program ready once
+	///   it's created on render thread. Result is delayed by number of frames in flight.
+	///   Program that failed to link never becomes ready.
+	///
+	/// @attention C99 equivalent is `bgfx_is_program_ready`.
+	///
+	bool isProgramReady(ProgramHandle _handle);
+
 	/// Validate texture parameters.
 	///
 	/// @param[in] _depth Depth dimension of volume texture.
@@ -3238,6 +3438,41 @@ namespace bgfx
 		, uint16_t _num = 1
 	);
 
+	/// Create uniform group. Uniform group holds values of `UniformSet::Group`
+	/// uniforms, which persist across frames and are sent to renderer only
+	/// when group is updated.
+	///
+	/// @returns Handle to uniform group.
+	///
+	/// @attention C99 equivalent is `bgfx_create_uniform_group`.
+	///
+	UniformGroupHandle createUniformGroup();
+
+	/// Update value of uniform stored in uniform group.
+	///
+	/// @param[in] _handle Uniform group handle.
+	/// @param[in] _uniform Uniform, created with `UniformSet::Group` frequency.
+	/// @param[in] _value Pointer to uniform data.
+	/// @param[in] _num Number of elements. Passing `UINT16_MAX` will
+	///   use the _num passed on uniform creation.
+	///
+	/// @attention C99 equivalent is `bgfx_update_uniform_group`.
+	///
+	void updateUniformGroup(
+		  UniformGroupHandle _handle
+		, UniformHandle _uniform
+		, const void* _value
+		, uint16_t _num = 1
+		);
+
+	/// Destroy uniform group.
+	///
+	/// @param[in] _handle Uniform group handle.
+	///
+	/// @attention C99 equivalent is `bgfx_destroy_uniform_group`.
+	///
+	void destroy(UniformGroupHandle _handle);
+
 	/// Destroy shader uniform parameter.
 	///
 	/// @param[in] _handle Handle to uniform object.
@@ -3595,6 +3830,16 @@ namespace bgfx
 		, uint32_t _rgba = 0
 		);
 
+	/// Set uniform group for draw primitive. Values of `UniformSet::Group`
+	/// uniforms stored in group are applied when group changes between
+	/// draw calls.
+	///
+	/// @param[in] _handle Uniform group handle.
+	///
+	/// @attention C99 equivalent is `bgfx_set_group`.
+	///
+	void setGroup(UniformGroupHandle _handle);
+
 	void setUniformGroup(
 		  uint8_t _set
 		, uint16_t _group
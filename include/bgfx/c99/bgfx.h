@@ -472,6 +472,8 @@ typedef struct bgfx_shader_handle_s { uint16_t idx; } bgfx_shader_handle_t;
 
 typedef struct bgfx_texture_handle_s { uint16_t idx; } bgfx_texture_handle_t;
 
+typedef struct bgfx_uniform_group_handle_s { uint16_t idx; } bgfx_uniform_group_handle_t;
+
 typedef struct bgfx_uniform_handle_s { uint16_t idx; } bgfx_uniform_handle_t;
 
 typedef struct bgfx_vertex_buffer_handle_s { uint16_t idx; } bgfx_vertex_buffer_handle_t;
@@ -649,6 +651,7 @@ typedef struct bgfx_init_limits_s
     uint32_t             minResourceCbSize;  /** Minimum resource command buffer size.    */
     uint32_t             transientVbSize;    /** Maximum transient vertex buffer size.    */
     uint32_t             transientIbSize;    /** Maximum transient index buffer size.     */
+    uint8_t              numFrames;          /** Number of frames in flight between API and render thread. */
 
 } bgfx_init_limits_t;
 
@@ -759,6 +762,20 @@ typedef struct bgfx_instance_data_buffer_s
 
 } bgfx_instance_data_buffer_t;
 
+/**
+ * Caller owned scratch memory for `bgfx::topologySortTriList`. It also
+ *   keeps triangle order of previous sort, which is used as starting
+ *   point for the next sort.
+ *
+ */
+typedef struct bgfx_topology_sort_scratch_s
+{
+    void*                data;               /** Scratch memory, see `bgfx::topologySortTriListScratchSize`. */
+    uint32_t             size;               /** Scratch memory size in bytes.            */
+    uint32_t             num;                /** Number of triangles in previous order, set to 0 to discard it. */
+
+} bgfx_topology_sort_scratch_t;
+
 /**
  * Texture info.
  *
@@ -852,6 +869,7 @@ typedef struct bgfx_stats_s
     int64_t              cpuTimeFrame;       /** CPU time between two `bgfx::frame` calls. */
     int64_t              cpuTimeBegin;       /** Render thread CPU submit begin time.     */
     int64_t              cpuTimeEnd;         /** Render thread CPU submit end time.       */
+    int64_t              cpuTimeSort;        /** Render thread CPU time spent sorting draw calls (part of submit). */
     int64_t              cpuTimerFreq;       /** CPU timer frequency. Timestamps-per-second */
     int64_t              gpuTimeBegin;       /** GPU frame begin time.                    */
     int64_t              gpuTimeEnd;         /** GPU frame end time.                      */
@@ -877,6 +895,12 @@ typedef struct bgfx_stats_s
     int64_t              rtMemoryUsed;       /** Estimate of render target memory used.   */
     int32_t              transientVbUsed;    /** Amount of transient vertex buffer used.  */
     int32_t              transientIbUsed;    /** Amount of transient index buffer used.   */
+    int64_t              dynamicVbUsed;      /** Amount of dynamic vertex buffer memory used. */
+    int64_t              dynamicVbPeak;      /** Peak amount of dynamic vertex buffer memory used. */
+    int64_t              dynamicIbUsed;      /** Amount of dynamic index buffer memory used. */
+    int64_t              dynamicIbPeak;      /** Peak amount of dynamic index buffer memory used. */
+    float                dynamicVbFragmentation; /** Dynamic vertex buffer free memory fragmentation (0-1). */
+    float                dynamicIbFragmentation; /** Dynamic index buffer free memory fragmentation (0-1). */
     uint32_t             numPrims[BGFX_TOPOLOGY_COUNT]; /** Number of primitives rendered.           */
     int64_t              gpuMemoryMax;       /** Maximum available GPU memory for application. */
     int64_t              gpuMemoryUsed;      /** Amount of GPU memory used by the application. */
@@ -1079,6 +1103,43 @@ BGFX_C_API uint32_t bgfx_topology_convert(bgfx_topology_convert_t _conversion, v
  */
 BGFX_C_API void bgfx_topology_sort_tri_list(bgfx_topology_sort_t _sort, void* _dst, uint32_t _dstSize, const float _dir[3], const float _pos[3], const void* _vertices, uint32_t _stride, const void* _indices, uint32_t _numIndices, bool _index32);
 
+/**
+ * Sort indices, reusing caller owned scratch memory between calls.
+ * @remarks
+ *   Keys are computed in previous call's triangle order. When camera
+ *   moved only slightly they are nearly sorted, and are sorted
+ *   incrementally with insertion sort. If too many triangles move, it
+ *   falls back to radix sort.
+ *
+ * @param[in] _sort Sort order, see `TopologySort::Enum`.
+ * @param[out] _dst Destination index buffer.
+ * @param[in] _dstSize Destination index buffer in bytes.
+ * @param[in] _dir Direction (vector must be normalized).
+ * @param[in] _pos Position.
+ * @param[in] _vertices Pointer to first vertex represented as
+ *  float x, y, z.
+ * @param[in] _stride Vertex stride.
+ * @param[in] _indices Source indices, must be the same between calls
+ *  for previous order to be meaningful.
+ * @param[in] _numIndices Number of input indices.
+ * @param[in] _index32 Set to `true` if input indices are 32-bit.
+ * @param[inout] _scratch Scratch memory. If it's too small, temporary
+ *  memory is allocated, and previous order is discarded.
+ *
+ */
+BGFX_C_API void bgfx_topology_sort_tri_list_scratch(bgfx_topology_sort_t _sort, void* _dst, uint32_t _dstSize, const float _dir[3], const float _pos[3], const void* _vertices, uint32_t _stride, const void* _indices, uint32_t _numIndices, bool _index32, bgfx_topology_sort_scratch_t * _scratch);
+
+/**
+ * Returns scratch memory size in bytes required to sort `_numIndices`
+ *   indices with `bgfx::topologySortTriList`.
+ *
+ * @param[in] _numIndices Number of input indices.
+ *
+ * @returns Scratch memory size in bytes.
+ *
+ */
+BGFX_C_API uint32_t bgfx_topology_sort_tri_list_scratch_size(uint32_t _numIndices);
+
 /**
  * Returns supported backend API renderers.
  *
@@ -1638,6 +1699,24 @@ BGFX_C_API void bgfx_destroy_indirect_buffer(bgfx_indirect_buffer_handle_t _hand
  */
 BGFX_C_API bgfx_shader_handle_t bgfx_create_shader(const bgfx_memory_t* _mem);
 
+/**
+ * Create shader from memory buffer, selecting variant by key when buffer
+ * contains shader variants.
+ * @remarks
+ *   `createShader(_mem)` with shader variants binary selects variant 0.
+ *
+ * @param[in] _mem Shader binary, or shader variants binary built by shaderc
+ *  from source with `$variant <name> [count]` declarations.
+ * @param[in] _variantKey Variant key. Axis values are packed as bit fields
+ *  in declaration order, starting from least significant bit, each axis
+ *  taking as many bits as its largest value needs. Bits of axes not
+ *  declared by shader are ignored. Ignored for regular shader binary.
+ *
+ * @returns Shader handle.
+ *
+ */
+BGFX_C_API bgfx_shader_handle_t bgfx_create_shader_variant(const bgfx_memory_t* _mem, uint32_t _variantKey);
+
 /**
  * Returns the number of uniforms and uniform handles used inside a shader.
  * @remarks
@@ -1697,6 +1776,23 @@ BGFX_C_API bgfx_program_handle_t bgfx_create_program(bgfx_shader_handle_t _vsh,
  */
 BGFX_C_API bgfx_program_handle_t bgfx_create_compute_program(bgfx_shader_handle_t _csh, bool _destroyShaders);
 
+/**
+ * Create program with vertex and fragment shader variants selected by key.
+ * @remarks
+ *   Shaders and programs are deduplicated, creating program with the same
+ *   key again returns the same handle. Destroy it once per create call.
+ *
+ * @param[in] _vsMem Vertex shader binary, or shader variants binary.
+ * @param[in] _fsMem Fragment shader binary, or shader variants binary.
+ * @param[in] _variantKey Variant key, applied to both shaders. See
+ *  `createShader(const Memory*, uint32_t)`. Axes used by both shaders
+ *  must be declared first, and in the same order.
+ *
+ * @returns Program handle. Shaders are destroyed when program is destroyed.
+ *
+ */
+BGFX_C_API bgfx_program_handle_t bgfx_create_program_variant(const bgfx_memory_t* _vsMem, const bgfx_memory_t* _fsMem, uint32_t _variantKey);
+
 /**
  * Destroy program.
  *
@@ -1705,6 +1801,22 @@ BGFX_C_API bgfx_program_handle_t bgfx_create_compute_program(bgfx_shader_handle_
  */
 BGFX_C_API void bgfx_destroy_program(bgfx_program_handle_t _handle);
 
+/**
+ * Returns true when program is done compiling and linking. Draw and compute calls
+ * using program which is not ready are skipped by renderer.
+ * @remarks
+ *   Only OpenGL renderer built with `BGFX_CONFIG_RENDERER_OPENGL_ASYNC_PROGRAM`
+ *   creates programs asynchronously, other renderers report program ready once
+ *   it's created on render thread. Result is delayed by number of frames in flight.
+ *   Program that failed to link never becomes ready.
+ *
+ * @param[in] _handle Program handle.
+ *
+ * @returns True when program is ready.
+ *
+ */
+BGFX_C_API bool bgfx_is_program_ready(bgfx_program_handle_t _handle);
+
 /**
  * Validate texture parameters.
  *
@@ -2133,6 +2245,36 @@ BGFX_C_API void bgfx_get_uniform_info(bgfx_uniform_handle_t _handle, bgfx_unifor
  */
 BGFX_C_API void bgfx_destroy_uniform(bgfx_uniform_handle_t _handle);
 
+/**
+ * Create uniform group. Uniform group holds values of `UniformSet::Group`
+ * uniforms, which persist across frames and are sent to renderer only
+ * when group is updated.
+ *
+ * @returns Handle to uniform group.
+ *
+ */
+BGFX_C_API bgfx_uniform_group_handle_t bgfx_create_uniform_group(void);
+
+/**
+ * Update value of uniform stored in uniform group.
+ *
+ * @param[in] _handle Uniform group handle.
+ * @param[in] _uniform Uniform, created with `UniformSet::Group` frequency.
+ * @param[in] _value Pointer to uniform data.
+ * @param[in] _num Number of elements. Passing `UINT16_MAX` will
+ *  use the _num passed on uniform creation.
+ *
+ */
+BGFX_C_API void bgfx_update_uniform_group(bgfx_uniform_group_handle_t _handle, bgfx_uniform_handle_t _uniform, const void* _value, uint16_t _num);
+
+/**
+ * Destroy uniform group.
+ *
+ * @param[in] _handle Uniform group handle.
+ *
+ */
+BGFX_C_API void bgfx_destroy_uniform_group(bgfx_uniform_group_handle_t _handle);
+
 /**
  * Create occlusion query.
  *
@@ -2374,6 +2516,16 @@ BGFX_C_API void bgfx_encoder_set_marker(bgfx_encoder_t* _this, const char* _mark
  */
 BGFX_C_API void bgfx_encoder_set_state(bgfx_encoder_t* _this, uint64_t _state, uint32_t _rgba);
 
+/**
+ * Set uniform group for draw primitive. Values of `UniformSet::Group`
+ * uniforms stored in group are applied when group changes between
+ * draw calls.
+ *
+ * @param[in] _handle Uniform group handle.
+ *
+ */
+BGFX_C_API void bgfx_encoder_set_group(bgfx_encoder_t* _this, bgfx_uniform_group_handle_t _handle);
+
 /**
  * Set condition for rendering.
  *
@@ -2606,6 +2758,54 @@ BGFX_C_API void bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer(bgfx_e
  */
 BGFX_C_API void bgfx_encoder_set_instance_count(bgfx_encoder_t* _this, uint32_t _numInstances);
 
+/**
+ * Allocate transient index buffer from encoder's transient page.
+ * @remarks
+ *   Unlike `bgfx::allocTransientIndexBuffer` this doesn't take API lock.
+ *   Encoder reserves large pages from frame's transient index buffer,
+ *   and returns unused part of page at `bgfx::end`.
+ *
+ * @param[out] _tib TransientIndexBuffer structure is filled and is valid
+ *  for the duration of frame, and it can be reused for multiple draw
+ *  calls.
+ * @param[in] _num Number of indices to allocate.
+ * @param[in] _index32 Set to `true` if input indices will be 32-bit.
+ *
+ */
+BGFX_C_API void bgfx_encoder_alloc_transient_index_buffer(bgfx_encoder_t* _this, bgfx_transient_index_buffer_t* _tib, uint32_t _num, bool _index32);
+
+/**
+ * Allocate transient vertex buffer from encoder's transient page.
+ * @remarks
+ *   Unlike `bgfx::allocTransientVertexBuffer` this doesn't take API lock,
+ *   except first time vertex layout is used by encoder in frame.
+ *
+ * @param[out] _tvb TransientVertexBuffer structure is filled and is valid
+ *  for the duration of frame, and it can be reused for multiple draw
+ *  calls.
+ * @param[in] _num Number of vertices to allocate.
+ * @param[in] _layout Vertex layout.
+ *
+ */
+BGFX_C_API void bgfx_encoder_alloc_transient_vertex_buffer(bgfx_encoder_t* _this, bgfx_transient_vertex_buffer_t* _tvb, uint32_t _num, const bgfx_vertex_layout_t * _layout);
+
+/**
+ * Check for required space and allocate transient vertex and index
+ * buffers from encoder's transient pages. If both space requirements
+ * are satisfied function returns true.
+ *
+ * @param[out] _tvb TransientVertexBuffer structure is filled and is valid
+ *  for the duration of frame.
+ * @param[in] _layout Vertex layout.
+ * @param[in] _numVertices Number of vertices to allocate.
+ * @param[out] _tib TransientIndexBuffer structure is filled and is valid
+ *  for the duration of frame.
+ * @param[in] _numIndices Number of indices to allocate.
+ * @param[in] _index32 Set to `true` if input indices will be 32-bit.
+ *
+ */
+BGFX_C_API bool bgfx_encoder_alloc_transient_buffers(bgfx_encoder_t* _this, bgfx_transient_vertex_buffer_t* _tvb, const bgfx_vertex_layout_t * _layout, uint32_t _numVertices, bgfx_transient_index_buffer_t* _tib, uint32_t _numIndices, bool _index32);
+
 /**
  * Set texture stage for draw primitive.
  *
@@ -2925,6 +3125,16 @@ BGFX_C_API void bgfx_set_marker(const char* _marker);
  */
 BGFX_C_API void bgfx_set_state(uint64_t _state, uint32_t _rgba);
 
+/**
+ * Set uniform group for draw primitive. Values of `UniformSet::Group`
+ * uniforms stored in group are applied when group changes between
+ * draw calls.
+ *
+ * @param[in] _handle Uniform group handle.
+ *
+ */
+BGFX_C_API void bgfx_set_group(bgfx_uniform_group_handle_t _handle);
+
 /**
  * Set condition for rendering.
  *
@@ -3575,6 +3785,8 @@ struct bgfx_interface_vtbl
     uint32_t (*weld_vertices)(void* _output, const bgfx_vertex_layout_t * _layout, const void* _data, uint32_t _num, bool _index32, float _epsilon);
     uint32_t (*topology_convert)(bgfx_topology_convert_t _conversion, void* _dst, uint32_t _dstSize, const void* _indices, uint32_t _numIndices, bool _index32);
     void (*topology_sort_tri_list)(bgfx_topology_sort_t _sort, void* _dst, uint32_t _dstSize, const float _dir[3], const float _pos[3], const void* _vertices, uint32_t _stride, const void* _indices, uint32_t _numIndices, bool _index32);
+    void (*topology_sort_tri_list_scratch)(bgfx_topology_sort_t _sort, void* _dst, uint32_t _dstSize, const float _dir[3], const float _pos[3], const void* _vertices, uint32_t _stride, const void* _indices, uint32_t _numIndices, bool _index32, bgfx_topology_sort_scratch_t * _scratch);
+    uint32_t (*topology_sort_tri_list_scratch_size)(uint32_t _numIndices);
     uint8_t (*get_supported_renderers)(uint8_t _max, bgfx_renderer_type_t* _enum);
     const char* (*get_renderer_name)(bgfx_renderer_type_t _type);
     void (*init_ctor)(bgfx_init_t* _init);
@@ -3620,12 +3832,15 @@ struct bgfx_interface_vtbl
     bgfx_indirect_buffer_handle_t (*create_indirect_buffer)(uint32_t _num);
     void (*destroy_indirect_buffer)(bgfx_indirect_buffer_handle_t _handle);
     bgfx_shader_handle_t (*create_shader)(const bgfx_memory_t* _mem);
+    bgfx_shader_handle_t (*create_shader_variant)(const bgfx_memory_t* _mem, uint32_t _variantKey);
     uint16_t (*get_shader_uniforms)(bgfx_shader_handle_t _handle, bgfx_uniform_handle_t* _uniforms, uint16_t _max);
     void (*set_shader_name)(bgfx_shader_handle_t _handle, const char* _name, int32_t _len);
     void (*destroy_shader)(bgfx_shader_handle_t _handle);
     bgfx_program_handle_t (*create_program)(bgfx_shader_handle_t _vsh, bgfx_shader_handle_t _fsh, bool _destroyShaders);
     bgfx_program_handle_t (*create_compute_program)(bgfx_shader_handle_t _csh, bool _destroyShaders);
+    bgfx_program_handle_t (*create_program_variant)(const bgfx_memory_t* _vsMem, const bgfx_memory_t* _fsMem, uint32_t _variantKey);
     void (*destroy_program)(bgfx_program_handle_t _handle);
+    bool (*is_program_ready)(bgfx_program_handle_t _handle);
     bool (*is_texture_valid)(uint16_t _depth, bool _cubeMap, uint16_t _numLayers, bgfx_texture_format_t _format, uint64_t _flags);
     bool (*is_frame_buffer_valid)(uint8_t _num, const bgfx_attachment_t* _attachment);
     void (*calc_texture_size)(bgfx_texture_info_t * _info, uint16_t _width, uint16_t _height, uint16_t _depth, bool _cubeMap, bool _hasMips, uint16_t _numLayers, bgfx_texture_format_t _format);
@@ -3652,6 +3867,9 @@ struct bgfx_interface_vtbl
     bgfx_uniform_handle_t (*create_uniform)(const char* _name, bgfx_uniform_type_t _type, uint16_t _num, bgfx_uniform_freq_t _freq);
     void (*get_uniform_info)(bgfx_uniform_handle_t _handle, bgfx_uniform_info_t * _info);
     void (*destroy_uniform)(bgfx_uniform_handle_t _handle);
+    bgfx_uniform_group_handle_t (*create_uniform_group)(void);
+    void (*update_uniform_group)(bgfx_uniform_group_handle_t _handle, bgfx_uniform_handle_t _uniform, const void* _value, uint16_t _num);
+    void (*destroy_uniform_group)(bgfx_uniform_group_handle_t _handle);
     bgfx_occlusion_query_handle_t (*create_occlusion_query)(void);
     bgfx_occlusion_query_result_t (*get_result)(bgfx_occlusion_query_handle_t _handle, int32_t* _result);
     void (*destroy_occlusion_query)(bgfx_occlusion_query_handle_t _handle);
@@ -3672,6 +3890,7 @@ struct bgfx_interface_vtbl
     void (*encoder_end)(bgfx_encoder_t* _encoder);
     void (*encoder_set_marker)(bgfx_encoder_t* _this, const char* _marker);
     void (*encoder_set_state)(bgfx_encoder_t* _this, uint64_t _state, uint32_t _rgba);
+    void (*encoder_set_group)(bgfx_encoder_t* _this, bgfx_uniform_group_handle_t _handle);
     void (*encoder_set_condition)(bgfx_encoder_t* _this, bgfx_occlusion_query_handle_t _handle, bool _visible);
     void (*encoder_set_stencil)(bgfx_encoder_t* _this, uint32_t _fstencil, uint32_t _bstencil);
     uint16_t (*encoder_set_scissor)(bgfx_encoder_t* _this, uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height);
@@ -3694,6 +3913,9 @@ struct bgfx_interface_vtbl
     void (*encoder_set_instance_data_from_vertex_buffer)(bgfx_encoder_t* _this, bgfx_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num);
     void (*encoder_set_instance_data_from_dynamic_vertex_buffer)(bgfx_encoder_t* _this, bgfx_dynamic_vertex_buffer_handle_t _handle, uint32_t _startVertex, uint32_t _num);
     void (*encoder_set_instance_count)(bgfx_encoder_t* _this, uint32_t _numInstances);
+    void (*encoder_alloc_transient_index_buffer)(bgfx_encoder_t* _this, bgfx_transient_index_buffer_t* _tib, uint32_t _num, bool _index32);
+    void (*encoder_alloc_transient_vertex_buffer)(bgfx_encoder_t* _this, bgfx_transient_vertex_buffer_t* _tvb, uint32_t _num, const bgfx_vertex_layout_t * _layout);
+    bool (*encoder_alloc_transient_buffers)(bgfx_encoder_t* _this, bgfx_transient_vertex_buffer_t* _tvb, const bgfx_vertex_layout_t * _layout, uint32_t _numVertices, bgfx_transient_index_buffer_t* _tib, uint32_t _numIndices, bool _index32);
     void (*encoder_set_texture)(bgfx_encoder_t* _this, uint8_t _stage, bgfx_uniform_handle_t _sampler, bgfx_texture_handle_t _handle, uint32_t _flags);
     void (*encoder_touch)(bgfx_encoder_t* _this, bgfx_view_id_t _id);
     void (*encoder_submit)(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, uint32_t _depth, uint8_t _flags);
@@ -3717,6 +3939,7 @@ struct bgfx_interface_vtbl
     uintptr_t (*override_internal_texture)(bgfx_texture_handle_t _handle, uint16_t _width, uint16_t _height, uint8_t _numMips, bgfx_texture_format_t _format, uint64_t _flags);
     void (*set_marker)(const char* _marker);
     void (*set_state)(uint64_t _state, uint32_t _rgba);
+    void (*set_group)(bgfx_uniform_group_handle_t _handle);
     void (*set_condition)(bgfx_occlusion_query_handle_t _handle, bool _visible);
     void (*set_stencil)(uint32_t _fstencil, uint32_t _bstencil);
     uint16_t (*set_scissor)(uint16_t _x, uint16_t _y, uint16_t _width, uint16_t _height);
@@ -0,0 +1,69 @@
+--
+-- Copyright 2010-2021 Branimir Karadzic. All rights reserved.
+-- License: https://github.com/bkaradzic/bgfx#license-bsd-2-clause
+--
+
+project "bgfx-bench"
+	uuid (os.uuid("bgfx-bench"))
+	kind "ConsoleApp"
+
+	includedirs {
+		path.join(BX_DIR,   "include"),
+		path.join(BIMG_DIR, "include"),
+		path.join(BGFX_DIR, "include"),
+		path.join(BGFX_DIR, "3rdparty"),
+		path.join(BGFX_DIR, "examples/common"),
+	}
+
+	files {
+		path.join(BGFX_DIR, "tools/bench/**.cpp"),
+		path.join(BGFX_DIR, "3rdparty/meshoptimizer/src/**.cpp"),
+		path.join(BGFX_DIR, "examples/common/bgfx_utils.cpp"),
+		path.join(BGFX_DIR, "examples/common/bounds.cpp"),
+		path.join(BGFX_DIR, "examples/common/bvh.cpp"),
+		path.join(BGFX_DIR, "examples/common/entry/cmd.cpp"),
+		path.join(BGFX_DIR, "examples/common/entry/entry.cpp"),
+		path.join(BGFX_DIR, "examples/common/entry/entry_noop.cpp"),
+		path.join(BGFX_DIR, "examples/common/entry/input.cpp"),
+	}
+
+	defines {
+		"ENTRY_CONFIG_USE_NOOP=1",
+	}
+
+	links {
+		"bgfx",
+		"bimg_decode",
+		"bimg",
+		"bx",
+	}
+
+	configuration { "mingw-*" }
+		targetextension ".exe"
+		links {
+			"psapi",
+		}
+
+	configuration { "linux-* or freebsd" }
+		links {
+			"X11",
+			"GL",
+			"pthread",
+		}
+
+	configuration { "osx*" }
+		links {
+			"Cocoa.framework",
+			"IOKit.framework",
+			"Metal.framework",
+			"QuartzCore.framework",
+		}
+
+	configuration { "vs20*" }
+		links {
+			"psapi",
+		}
+
+	configuration {}
+
+	strip()
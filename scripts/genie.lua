@@ -30,6 +30,16 @@ newoption {
 	description = "Enable build with intrusive profiler.",
 }
 
+newoption {
+	trigger = "with-noop-replay",
+	description = "Enable noop renderer frame replay (headless render thread benchmarking).",
+}
+
+newoption {
+	trigger = "with-bench",
+	description = "Enable building headless submission benchmark (implies with-noop-replay).",
+}
+
 newoption {
 	trigger = "with-shared-lib",
 	description = "Enable building shared library.",
@@ -215,6 +225,13 @@ if _OPTIONS["with-profiler"] then
 	}
 end
 
+if _OPTIONS["with-noop-replay"]
+or _OPTIONS["with-bench"] then
+	defines {
+		"BGFX_CONFIG_RENDERER_NOOP_REPLAY=1",
+	}
+end
+
 if _OPTIONS["with-glfw"] then
 	GLFW_DIR = path.join(path.getabsolute("../.."), "two/3rdparty/glfw")
 	project "glfw3"
@@ -1045,3 +1062,8 @@ if _OPTIONS["with-tools"] then
 	dofile "geometryc.lua"
 	dofile "geometryv.lua"
 end
+
+if _OPTIONS["with-bench"] then
+	group "tools"
+	dofile "bench.lua"
+end
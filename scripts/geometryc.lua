@@ -33,6 +33,11 @@ project "geometryc"
 			"psapi",
 		}
 
+	configuration { "linux-*" }
+		links {
+			"pthread",
+		}
+
 	configuration { "osx*" }
 		links {
 			"Cocoa.framework",
@@ -1203,7 +1203,7 @@ namespace bgfx
 			return;
 		}
 
-		const uint32_t renderItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, 1, BGFX_CONFIG_MAX_DRAW_CALLS);
+		const uint32_t renderItemIdx = allocRenderItem();
 		if (BGFX_CONFIG_MAX_DRAW_CALLS <= renderItemIdx)
 		{
 			discard(_flags);
@@ -1229,6 +1229,24 @@ namespace bgfx
 		default: break;
 		}
 
+#if 0 != BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE
+		m_key.m_state = bx::hash<bx::HashMurmur2A>(m_draw.m_stateFlags);
+#endif // 0 != BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE
+
+#if 0 != BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE
+		{
+			bx::HashMurmur2A murmur;
+			murmur.begin();
+			for (uint32_t stage = 0; stage < BGFX_CONFIG_MAX_TEXTURE_SAMPLERS; ++stage)
+			{
+				const Binding& bind = m_bind.m_bind[stage];
+				murmur.add(bind.m_idx);
+				murmur.add(bind.m_samplerFlags);
+			}
+			m_key.m_texture = murmur.end();
+		}
+#endif // 0 != BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE
+
 		uint64_t key = m_key.encodeDraw(type);
 
 		m_frame->m_sortKeys[renderItemIdx]   = key;
@@ -1291,8 +1309,8 @@ namespace bgfx
 			return;
 		}
 
-		const uint32_t renderItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, 1, BGFX_CONFIG_MAX_DRAW_CALLS);
-		if (BGFX_CONFIG_MAX_DRAW_CALLS-1 <= renderItemIdx)
+		const uint32_t renderItemIdx = allocRenderItem();
+		if (BGFX_CONFIG_MAX_DRAW_CALLS <= renderItemIdx)
 		{
 			discard(_flags);
 			++m_numDropped;
@@ -1330,6 +1348,78 @@ namespace bgfx
 		m_uniformBegin = m_uniformEnd;
 	}
 
+	VertexLayoutHandle EncoderImpl::findTransientVertexLayout(const VertexLayout& _layout)
+	{
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_layoutCache); ++ii)
+		{
+			const LayoutCache& entry = m_layoutCache[ii];
+			if (isValid(entry.m_handle)
+			&&  entry.m_hash == _layout.m_hash)
+			{
+				return entry.m_handle;
+			}
+		}
+
+		VertexLayoutHandle layoutHandle;
+
+		{
+			BGFX_MUTEX_SCOPE(s_ctx->m_resourceApiLock);
+			layoutHandle = s_ctx->findTransientVertexLayout(_layout);
+		}
+
+		LayoutCache& entry = m_layoutCache[m_layoutCacheNext];
+		entry.m_hash   = _layout.m_hash;
+		entry.m_handle = layoutHandle;
+		m_layoutCacheNext = uint8_t( (m_layoutCacheNext+1) % BX_COUNTOF(m_layoutCache) );
+
+		return layoutHandle;
+	}
+
+	void EncoderImpl::allocTransientIndexBuffer(TransientIndexBuffer* _tib, uint32_t _num, bool _index32)
+	{
+		const bool isIndex16     = !_index32;
+		const uint32_t indexSize = isIndex16 ? 2 : 4;
+		const uint32_t offset    = allocTransientPage(m_transientIbPage, &m_frame->m_iboffset, g_caps.limits.transientIbSize, _num, indexSize);
+
+		TransientIndexBuffer& tib = *m_frame->m_transientIb;
+
+		_tib->data       = &tib.data[offset];
+		_tib->size       = _num * indexSize;
+		_tib->handle     = tib.handle;
+		_tib->startIndex = offset / indexSize;
+		_tib->isIndex16  = isIndex16;
+	}
+
+	void EncoderImpl::allocTransientVertexBuffer(TransientVertexBuffer* _tvb, uint32_t _num, const VertexLayout& _layout)
+	{
+		const VertexLayoutHandle layoutHandle = findTransientVertexLayout(_layout);
+		const uint32_t offset = allocTransientPage(m_transientVbPage, &m_frame->m_vboffset, g_caps.limits.transientVbSize, _num, _layout.m_stride);
+
+		TransientVertexBuffer& tvb = *m_frame->m_transientVb;
+
+		_tvb->data         = &tvb.data[offset];
+		_tvb->size         = _num * _layout.m_stride;
+		_tvb->startVertex  = offset / _layout.m_stride;
+		_tvb->stride       = _layout.m_stride;
+		_tvb->handle       = tvb.handle;
+		_tvb->layoutHandle = layoutHandle;
+	}
+
+	bool EncoderImpl::allocTransientBuffers(TransientVertexBuffer* _tvb, const VertexLayout& _layout, uint32_t _numVertices, TransientIndexBuffer* _tib, uint32_t _numIndices, bool _index32)
+	{
+		const uint32_t indexSize = _index32 ? 4 : 2;
+
+		if (reserveTransientPage(m_transientVbPage, &m_frame->m_vboffset, g_caps.limits.transientVbSize, _numVertices, _layout.m_stride)
+		&&  reserveTransientPage(m_transientIbPage, &m_frame->m_iboffset, g_caps.limits.transientIbSize, _numIndices,  indexSize) )
+		{
+			allocTransientVertexBuffer(_tvb, _numVertices, _layout);
+			allocTransientIndexBuffer(_tib, _numIndices, _index32);
+			return true;
+		}
+
+		return false;
+	}
+
 	void EncoderImpl::blit(ViewId _id, TextureHandle _dst, uint8_t _dstMip, uint16_t _dstX, uint16_t _dstY, uint16_t _dstZ, TextureHandle _src, uint8_t _srcMip, uint16_t _srcX, uint16_t _srcY, uint16_t _srcZ, uint16_t _width, uint16_t _height, uint16_t _depth)
 	{
 		BX_WARN(m_frame->m_numBlitItems < BGFX_CONFIG_MAX_BLIT_ITEMS
@@ -1362,10 +1452,245 @@ namespace bgfx
 		}
 	}
 
+	void JobPool::init(uint32_t _numThreads)
+	{
+#if BGFX_CONFIG_MULTITHREADED
+		m_fn         = NULL;
+		m_userData   = NULL;
+		m_exit       = false;
+		m_numWorkers = bx::clamp<uint32_t>(_numThreads, 1, BGFX_CONFIG_SORT_NUM_THREADS)-1;
+
+		for (uint32_t ii = 0, num = m_numWorkers; ii < num; ++ii)
+		{
+			Worker& worker = m_worker[ii];
+			worker.m_pool = this;
+			worker.m_idx  = ii+1;
+			worker.m_thread.init(workerThread, &worker, 0, "bgfx - job worker");
+		}
+#else
+		BX_UNUSED(_numThreads);
+#endif // BGFX_CONFIG_MULTITHREADED
+	}
+
+	void JobPool::shutdown()
+	{
+#if BGFX_CONFIG_MULTITHREADED
+		m_exit = true;
+
+		for (uint32_t ii = 0, num = m_numWorkers; ii < num; ++ii)
+		{
+			Worker& worker = m_worker[ii];
+			worker.m_start.post();
+			worker.m_thread.shutdown();
+		}
+
+		m_numWorkers = 0;
+#endif // BGFX_CONFIG_MULTITHREADED
+	}
+
+	void JobPool::run(JobFn _fn, void* _userData)
+	{
+#if BGFX_CONFIG_MULTITHREADED
+		m_fn       = _fn;
+		m_userData = _userData;
+
+		for (uint32_t ii = 0, num = m_numWorkers; ii < num; ++ii)
+		{
+			m_worker[ii].m_start.post();
+		}
+
+		_fn(_userData, 0);
+
+		for (uint32_t ii = 0, num = m_numWorkers; ii < num; ++ii)
+		{
+			m_done.wait();
+		}
+#else
+		_fn(_userData, 0);
+#endif // BGFX_CONFIG_MULTITHREADED
+	}
+
+#if BGFX_CONFIG_MULTITHREADED
+	int32_t JobPool::workerThread(bx::Thread* _self, void* _userData)
+	{
+		BX_UNUSED(_self);
+		BGFX_PROFILER_SET_CURRENT_THREAD_NAME("bgfx - Job Worker");
+
+		Worker& worker = *(Worker*)_userData;
+		JobPool& pool  = *worker.m_pool;
+
+		for (;;)
+		{
+			worker.m_start.wait();
+
+			if (pool.m_exit)
+			{
+				break;
+			}
+
+			pool.m_fn(pool.m_userData, worker.m_idx);
+			pool.m_done.post();
+		}
+
+		return bx::kExitSuccess;
+	}
+#endif // BGFX_CONFIG_MULTITHREADED
+
+	static constexpr uint32_t kSortRadixBits      = 11;
+	static constexpr uint32_t kSortHistogramSize  = 1<<kSortRadixBits;
+	static constexpr uint32_t kSortRadixMask      = kSortHistogramSize-1;
+
+	struct SortJob
+	{
+		uint32_t getBegin(uint32_t _idx) const
+		{
+			return uint32_t(uint64_t(m_num)*_idx/m_numJobs);
+		}
+
+		uint64_t*        m_keys;
+		uint64_t*        m_tempKeys;
+		RenderItemCount* m_values;
+		RenderItemCount* m_tempValues;
+		const ViewId*    m_viewRemap;
+		uint32_t         m_num;
+		uint32_t         m_numJobs;
+		uint32_t         m_shift;
+		uint32_t         m_histogram[BGFX_CONFIG_SORT_NUM_THREADS][kSortHistogramSize];
+		bool             m_sorted[BGFX_CONFIG_SORT_NUM_THREADS];
+	};
+
+	static SortJob s_sortJob;
+
+	static void sortJobHistogram(void* _userData, uint32_t _idx)
+	{
+		SortJob& job = *(SortJob*)_userData;
+
+		const uint32_t begin = job.getBegin(_idx);
+		const uint32_t end   = job.getBegin(_idx+1);
+		uint64_t* keys = job.m_keys;
+
+		if (NULL != job.m_viewRemap)
+		{
+			for (uint32_t ii = begin; ii < end; ++ii)
+			{
+				keys[ii] = SortKey::remapView(keys[ii], job.m_viewRemap);
+			}
+		}
+
+		uint32_t* histogram = job.m_histogram[_idx];
+		bx::memSet(histogram, 0, sizeof(uint32_t)*kSortHistogramSize);
+
+		const uint32_t shift = job.m_shift;
+		bool sorted = true;
+		uint64_t prevKey = begin < end ? keys[begin] : 0;
+		for (uint32_t ii = begin; ii < end; ++ii)
+		{
+			const uint64_t key = keys[ii];
+			++histogram[(key>>shift)&kSortRadixMask];
+			sorted &= prevKey <= key;
+			prevKey = key;
+		}
+
+		job.m_sorted[_idx] = sorted;
+	}
+
+	static void sortJobScatter(void* _userData, uint32_t _idx)
+	{
+		SortJob& job = *(SortJob*)_userData;
+
+		const uint32_t begin = job.getBegin(_idx);
+		const uint32_t end   = job.getBegin(_idx+1);
+		const uint64_t* keys = job.m_keys;
+		const RenderItemCount* values = job.m_values;
+		uint64_t* tempKeys = job.m_tempKeys;
+		RenderItemCount* tempValues = job.m_tempValues;
+
+		uint32_t* histogram = job.m_histogram[_idx];
+		const uint32_t shift = job.m_shift;
+		for (uint32_t ii = begin; ii < end; ++ii)
+		{
+			const uint64_t key  = keys[ii];
+			const uint32_t dest = histogram[(key>>shift)&kSortRadixMask]++;
+			tempKeys[dest]   = key;
+			tempValues[dest] = values[ii];
+		}
+	}
+
+	/// Same LSD radix sort as bx::radixSort, with view remap folded into first
+	/// histogram pass, and each pass split into per-thread histogram and
+	/// scatter jobs. Per-thread offsets are assigned in thread order so sort
+	/// stays stable.
+	static void sortParallel(
+		  JobPool& _pool
+		, const ViewId* _viewRemap
+		, uint64_t* _keys
+		, uint64_t* _tempKeys
+		, RenderItemCount* _values
+		, RenderItemCount* _tempValues
+		, uint32_t _num
+		)
+	{
+		SortJob& job = s_sortJob;
+		job.m_keys       = _keys;
+		job.m_tempKeys   = _tempKeys;
+		job.m_values     = _values;
+		job.m_tempValues = _tempValues;
+		job.m_viewRemap  = _viewRemap;
+		job.m_num        = _num;
+		job.m_numJobs    = _pool.getNumThreads();
+		job.m_shift      = 0;
+
+		uint32_t pass = 0;
+		for (; pass < 6; ++pass)
+		{
+			_pool.run(sortJobHistogram, &job);
+			job.m_viewRemap = NULL;
+
+			bool sorted = true;
+			for (uint32_t jj = 0, numJobs = job.m_numJobs; jj < numJobs; ++jj)
+			{
+				const uint32_t begin = job.getBegin(jj);
+				sorted &= job.m_sorted[jj];
+				sorted &= 0 == begin || begin >= _num || job.m_keys[begin-1] <= job.m_keys[begin];
+			}
+
+			if (sorted)
+			{
+				break;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t ii = 0; ii < kSortHistogramSize; ++ii)
+			{
+				for (uint32_t jj = 0, numJobs = job.m_numJobs; jj < numJobs; ++jj)
+				{
+					const uint32_t count = job.m_histogram[jj][ii];
+					job.m_histogram[jj][ii] = offset;
+					offset += count;
+				}
+			}
+
+			_pool.run(sortJobScatter, &job);
+
+			bx::swap(job.m_keys,   job.m_tempKeys);
+			bx::swap(job.m_values, job.m_tempValues);
+			job.m_shift += kSortRadixBits;
+		}
+
+		if (0 != (pass&1) )
+		{
+			// Odd number of passes needs to do copy to the destination.
+			bx::memCopy(_keys,   _tempKeys,   _num*sizeof(uint64_t) );
+			bx::memCopy(_values, _tempValues, _num*sizeof(RenderItemCount) );
+		}
+	}
+
 	void Frame::sort()
 	{
 		BGFX_PROFILER_SCOPE("bgfx/Sort", 0xff2040ff);
 
+		const int64_t timeBegin = bx::getHPCounter();
+
 		ViewId viewRemap[BGFX_CONFIG_MAX_VIEWS];
 		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
 		{
@@ -1401,12 +1726,21 @@ namespace bgfx
 			}
 		}
 
-		for (uint32_t ii = 0, num = m_numRenderItems; ii < num; ++ii)
+		JobPool& jobPool = s_ctx->m_sortJobPool;
+		if (1 < jobPool.getNumThreads()
+		&&  BGFX_CONFIG_SORT_PARALLEL_MIN_ITEMS <= m_numRenderItems)
 		{
-			m_sortKeys[ii] = SortKey::remapView(m_sortKeys[ii], viewRemap);
+			sortParallel(jobPool, viewRemap, m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_numRenderItems);
 		}
+		else
+		{
+			for (uint32_t ii = 0, num = m_numRenderItems; ii < num; ++ii)
+			{
+				m_sortKeys[ii] = SortKey::remapView(m_sortKeys[ii], viewRemap);
+			}
 
-		bx::radixSort(m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_numRenderItems);
+			bx::radixSort(m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_numRenderItems);
+		}
 
 		for (uint32_t ii = 0, num = m_numBlitItems; ii < num; ++ii)
 		{
@@ -1414,6 +1748,8 @@ namespace bgfx
 		}
 
 		bx::radixSort(m_blitKeys, (uint32_t*)&s_ctx->m_tempKeys, m_numBlitItems);
+
+		m_perfStats.cpuTimeSort = bx::getHPCounter() - timeBegin;
 	}
 
 	RenderFrame::Enum renderFrame(int32_t _msecs)
@@ -1484,6 +1820,71 @@ namespace bgfx
 		write(_marker, num);
 	}
 
+	void UniformBuffer::replaceUniform(UniformBuffer** _uniformBuffer, UniformType::Enum _type, uint16_t _loc, const void* _value, uint16_t _num)
+	{
+		UniformBuffer* uniformBuffer = *_uniformBuffer;
+		uniformBuffer->reset();
+
+		const uint32_t size = g_uniformTypeSize[_type]*_num;
+
+		uint32_t entryPos  = UINT32_MAX;
+		uint32_t entrySize = 0;
+
+		for (;;)
+		{
+			const uint32_t pos    = uniformBuffer->getPos();
+			const uint32_t opcode = uniformBuffer->read();
+
+			if (UniformType::End == opcode)
+			{
+				uniformBuffer->reset(pos);
+				break;
+			}
+
+			UniformType::Enum type;
+			uint16_t loc;
+			uint16_t num;
+			uint16_t copy;
+			decodeOpcode(opcode, type, loc, num, copy);
+
+			const uint32_t dataSize = g_uniformTypeSize[type]*num;
+
+			if (loc == _loc)
+			{
+				if (size == dataSize)
+				{
+					// Same size, overwrite value in place, entries after it stay intact.
+					uniformBuffer->reset(pos);
+					uniformBuffer->writeUniform(_type, _loc, _value, _num);
+					uniformBuffer->reset();
+					return;
+				}
+
+				entryPos  = pos;
+				entrySize = uint32_t(sizeof(uint32_t) ) + dataSize;
+			}
+
+			uniformBuffer->read(dataSize);
+		}
+
+		if (UINT32_MAX != entryPos)
+		{
+			// Size changed, remove stale entry by moving entries after it down.
+			const uint32_t end = uniformBuffer->getPos();
+			bx::memMove(
+				  &uniformBuffer->m_buffer[entryPos]
+				, &uniformBuffer->m_buffer[entryPos+entrySize]
+				, end - entryPos - entrySize
+				);
+			uniformBuffer->reset(end - entrySize);
+		}
+
+		update(_uniformBuffer, size+3*sizeof(uint32_t), bx::max<uint32_t>(size, 1<<10) );
+		uniformBuffer = *_uniformBuffer;
+		uniformBuffer->writeUniform(_type, _loc, _value, _num);
+		uniformBuffer->finish();
+	}
+
 	struct CapsFlags
 	{
 		uint64_t m_flag;
@@ -1867,11 +2268,28 @@ namespace bgfx
 		m_debug   = BGFX_DEBUG_NONE;
 		m_frameTimeLast = bx::getHPCounter();
 
-		m_submit->create(_init.limits.minResourceCbSize);
+		m_numFrames = _init.limits.numFrames;
+		m_frame     = (Frame*)BX_ALIGNED_ALLOC(g_allocator, sizeof(Frame)*m_numFrames, BX_ALIGNOF(Frame) );
+		for (uint32_t ii = 0, num = m_numFrames; ii < num; ++ii)
+		{
+			BX_PLACEMENT_NEW(&m_frame[ii], Frame);
+			m_frame[ii].create(_init.limits.minResourceCbSize);
+		}
+
+		m_submitIdx = 0;
+		m_renderIdx = uint8_t(m_numFrames-1);
+		m_submit    = &m_frame[m_submitIdx];
+		m_render    = &m_frame[m_renderIdx];
+		bx::memSet(m_occlusion, 0xff, sizeof(m_occlusion) );
+		bx::memSet(m_programGen, 0, sizeof(m_programGen) );
+		bx::memSet(m_programReady, 0, sizeof(m_programReady) );
+		bx::memSet(m_programRef, 0, sizeof(m_programRef) );
+		bx::memSet(m_uniformGroupRef, 0, sizeof(m_uniformGroupRef) );
+		bx::memSet(m_uniformGroup, 0, sizeof(m_uniformGroup) );
 
-#if BGFX_CONFIG_MULTITHREADED
-		m_render->create(_init.limits.minResourceCbSize);
+		m_sortJobPool.init(BGFX_CONFIG_SORT_NUM_THREADS);
 
+#if BGFX_CONFIG_MULTITHREADED
 		if (s_renderFrameCalled)
 		{
 			// When bgfx::renderFrame is called before init render thread
@@ -1921,7 +2339,6 @@ namespace bgfx
 
 		frameNoRenderWait();
 
-		m_encoderHandle = bx::createHandleAlloc(g_allocator, _init.limits.maxEncoders);
 		m_encoder       = (EncoderImpl*)BX_ALIGNED_ALLOC(g_allocator, sizeof(EncoderImpl)*_init.limits.maxEncoders, BX_ALIGNOF(EncoderImpl) );
 		m_encoderStats  = (EncoderStats*)BX_ALLOC(g_allocator, sizeof(EncoderStats)*_init.limits.maxEncoders);
 		for (uint32_t ii = 0, num = _init.limits.maxEncoders; ii < num; ++ii)
@@ -1929,8 +2346,7 @@ namespace bgfx
 			BX_PLACEMENT_NEW(&m_encoder[ii], EncoderImpl);
 		}
 
-		uint16_t idx = m_encoderHandle->alloc();
-		BX_ASSERT(0 == idx, "Internal encoder handle is not 0 (idx %d).", idx); BX_UNUSED(idx);
+		m_encoderAlloc = 1;
 		m_encoder[0].begin(m_submit, 0);
 		m_encoder0 = reinterpret_cast<Encoder*>(&m_encoder[0]);
 
@@ -1944,13 +2360,18 @@ namespace bgfx
 			frame();
 			frame();
 			m_vertexLayoutRef.shutdown(m_layoutHandle);
-			m_submit->destroy();
-#if BGFX_CONFIG_MULTITHREADED
-			m_render->destroy();
-#endif // BGFX_CONFIG_MULTITHREADED
+			m_sortJobPool.shutdown();
+			destroyFrames();
 			return false;
 		}
 
+		// Renderer is up, free remaining slots of frame ring so that API thread
+		// can run ahead of render thread by m_numFrames-1 frames.
+		if (2 < m_numFrames)
+		{
+			renderSemPost(m_numFrames-2);
+		}
+
 		for (uint32_t ii = 0; ii < BX_COUNTOF(s_emulatedFormats); ++ii)
 		{
 			const uint32_t fmt = s_emulatedFormats[ii];
@@ -1980,11 +2401,7 @@ namespace bgfx
 		m_textVideoMemBlitter.init();
 		m_clearQuad.init();
 
-		m_submit->m_transientVb = createTransientVertexBuffer(_init.limits.transientVbSize);
-		m_submit->m_transientIb = createTransientIndexBuffer(_init.limits.transientIbSize);
-		frame();
-
-		if (BX_ENABLED(BGFX_CONFIG_MULTITHREADED) )
+		for (uint32_t ii = 0, num = m_numFrames; ii < num; ++ii)
 		{
 			m_submit->m_transientVb = createTransientVertexBuffer(_init.limits.transientVbSize);
 			m_submit->m_transientIb = createTransientIndexBuffer(_init.limits.transientIbSize);
@@ -2007,7 +2424,7 @@ namespace bgfx
 		m_clearQuad.shutdown();
 		frame();
 
-		if (BX_ENABLED(BGFX_CONFIG_MULTITHREADED) )
+		for (uint32_t ii = 1, num = m_numFrames; ii < num; ++ii)
 		{
 			destroyTransientVertexBuffer(m_submit->m_transientVb);
 			destroyTransientIndexBuffer(m_submit->m_transientIb);
@@ -2020,9 +2437,7 @@ namespace bgfx
 		frame();
 
 		m_encoder[0].end(true);
-		m_encoderHandle->free(0);
-		bx::destroyHandleAlloc(g_allocator, m_encoderHandle);
-		m_encoderHandle = NULL;
+		m_encoderAlloc = 0;
 
 		for (uint32_t ii = 0, num = g_caps.limits.maxEncoders; ii < num; ++ii)
 		{
@@ -2046,7 +2461,10 @@ namespace bgfx
 
 #if BGFX_CONFIG_MULTITHREADED
 		// Render thread shutdown sequence.
-		renderSemWait(); // Wait for previous frame.
+		for (uint32_t ii = 1, num = m_numFrames; ii < num; ++ii)
+		{
+			renderSemWait(); // Wait for frames in flight.
+		}
 		apiSemPost();   // OK to set context to NULL.
 		// s_ctx is NULL here.
 		renderSemWait(); // In RenderFrame::Exiting state.
@@ -2055,14 +2473,29 @@ namespace bgfx
 		{
 			m_thread.shutdown();
 		}
-
-		m_render->destroy();
 #endif // BGFX_CONFIG_MULTITHREADED
 
+		m_sortJobPool.shutdown();
+
+		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_UNIFORM_GROUPS; ++ii)
+		{
+			if (NULL != m_uniformGroupRef[ii].m_uniformBuffer)
+			{
+				UniformBuffer::destroy(m_uniformGroupRef[ii].m_uniformBuffer);
+				m_uniformGroupRef[ii].m_uniformBuffer = NULL;
+			}
+
+			if (NULL != m_uniformGroup[ii])
+			{
+				UniformBuffer::destroy(m_uniformGroup[ii]);
+				m_uniformGroup[ii] = NULL;
+			}
+		}
+
 		bx::memSet(&g_internalData, 0, sizeof(InternalData) );
 		s_ctx = NULL;
 
-		m_submit->destroy();
+		destroyFrames();
 
 		if (BX_ENABLED(BGFX_CONFIG_DEBUG) )
 		{
@@ -2137,6 +2570,7 @@ namespace bgfx
 			CHECK_HANDLE_LEAK_RC_NAME("TextureHandle",             m_textureHandle,            TextureRef,     m_textureRef    );
 			CHECK_HANDLE_LEAK_NAME   ("FrameBufferHandle",         m_frameBufferHandle,        FrameBufferRef, m_frameBufferRef);
 			CHECK_HANDLE_LEAK_RC_NAME("UniformHandle",             m_uniformHandle,            UniformRef,     m_uniformRef    );
+			CHECK_HANDLE_LEAK        ("UniformGroupHandle",        m_uniformGroupHandle                                        );
 			CHECK_HANDLE_LEAK        ("OcclusionQueryHandle",      m_occlusionQueryHandle                                      );
 #undef CHECK_HANDLE_LEAK
 #undef CHECK_HANDLE_LEAK_NAME
@@ -2205,6 +2639,11 @@ namespace bgfx
 		{
 			m_uniformHandle.free(_frame->m_freeUniform.get(ii).idx);
 		}
+
+		for (uint16_t ii = 0, num = _frame->m_freeUniformGroup.getNumQueued(); ii < num; ++ii)
+		{
+			m_uniformGroupHandle.free(_frame->m_freeUniformGroup.get(ii).idx);
+		}
 	}
 
 	Encoder* Context::begin(bool _forThread)
@@ -2214,12 +2653,30 @@ namespace bgfx
 #if BGFX_CONFIG_MULTITHREADED
 		if (_forThread || BGFX_API_THREAD_MAGIC != s_threadIndex)
 		{
-			bx::MutexScope scopeLock(m_encoderApiLock);
+			uint32_t idx = m_encoderAlloc;
 
-			uint16_t idx = m_encoderHandle->alloc();
-			if (kInvalidHandle == idx)
+			for (;;)
 			{
-				return NULL;
+				if (0 != (idx & kEncoderAllocLocked) )
+				{
+					// API thread is inside frame, wait for it to finish.
+					bx::MutexScope scopeLock(m_encoderApiLock);
+					idx = m_encoderAlloc;
+					continue;
+				}
+
+				if (g_caps.limits.maxEncoders <= idx)
+				{
+					return NULL;
+				}
+
+				const uint32_t prev = bx::atomicCompareAndSwap<uint32_t>(&m_encoderAlloc, idx, idx+1);
+				if (prev == idx)
+				{
+					break;
+				}
+
+				idx = prev;
 			}
 
 			encoder = &m_encoder[idx];
@@ -2252,13 +2709,11 @@ namespace bgfx
 
 #if BGFX_CONFIG_MULTITHREADED
 		bx::MutexScope resourceApiScope(m_resourceApiLock);
-
-		encoderApiWait();
 		bx::MutexScope encoderApiScope(m_encoderApiLock);
-#else
-		encoderApiWait();
 #endif // BGFX_CONFIG_MULTITHREADED
 
+		encoderApiWait();
+
 		m_submit->m_capture = _capture;
 
 		BGFX_PROFILER_SCOPE("bgfx/API thread frame", 0xff2040ff);
@@ -2267,10 +2722,25 @@ namespace bgfx
 		frameNoRenderWait();
 
 		m_encoder[0].begin(m_submit, 0);
+		encoderApiRelease();
 
 		return m_frames;
 	}
 
+	void Context::destroyFrames()
+	{
+		for (uint32_t ii = 0, num = m_numFrames; ii < num; ++ii)
+		{
+			m_frame[ii].destroy();
+			m_frame[ii].~Frame();
+		}
+
+		BX_ALIGNED_FREE(g_allocator, m_frame, BX_ALIGNOF(Frame) );
+		m_frame  = NULL;
+		m_render = NULL;
+		m_submit = NULL;
+	}
+
 	void Context::frameNoRenderWait()
 	{
 		swap();
@@ -2296,14 +2766,18 @@ namespace bgfx
 			bx::memCopy(m_submit->m_colorPalette, m_clearColor, sizeof(m_clearColor) );
 		}
 
+		updateDirtyUniformGroups();
+
 		freeAllHandles(m_submit);
 		m_submit->resetFreeHandles();
 
 		m_submit->finish();
 
-		bx::swap(m_render, m_submit);
-
-		bx::memCopy(m_render->m_occlusion, m_submit->m_occlusion, sizeof(m_submit->m_occlusion) );
+		// Hand submitted frame over to render thread, and move to the next slot
+		// in the ring. Render thread is guaranteed to be done with it.
+		const bool small = m_submit->m_textVideoMem->m_small;
+		m_submitIdx = getNextFrameIdx(m_submitIdx);
+		m_submit    = &m_frame[m_submitIdx];
 
 		if (!BX_ENABLED(BGFX_CONFIG_MULTITHREADED)
 		||  m_singleThreaded)
@@ -2322,7 +2796,7 @@ namespace bgfx
 		bx::memSet(m_seq, 0, sizeof(m_seq) );
 
 		m_submit->m_textVideoMem->resize(
-			  m_render->m_textVideoMem->m_small
+			  small
 			, m_init.resolution.width
 			, m_init.resolution.height
 			);
@@ -2395,6 +2869,20 @@ namespace bgfx
 
 		if (apiSemWait(_msecs) )
 		{
+			m_renderIdx = getNextFrameIdx(m_renderIdx);
+			m_render    = &m_frame[m_renderIdx];
+			m_render->m_waitSubmit = m_waitSubmit;
+			m_render->m_perfStats.waitSubmit = m_waitSubmit;
+
+			if (1 < m_numFrames)
+			{
+				// Carry occlusion query results and program readiness over from
+				// previously rendered frame.
+				bx::memCopy(m_render->m_occlusion, m_occlusion, sizeof(m_occlusion) );
+				bx::memCopy(m_render->m_programGen, m_programGen, sizeof(m_programGen) );
+				bx::memCopy(m_render->m_programReady, m_programReady, sizeof(m_programReady) );
+			}
+
 			{
 				BGFX_PROFILER_SCOPE("bgfx/Exec commands pre", 0xff2040ff);
 				rendererExecCommands(m_render->m_cmdPre);
@@ -2423,6 +2911,13 @@ namespace bgfx
 				rendererExecCommands(m_render->m_cmdPost);
 			}
 
+			if (1 < m_numFrames)
+			{
+				bx::memCopy(m_occlusion, m_render->m_occlusion, sizeof(m_occlusion) );
+				bx::memCopy(m_programGen, m_render->m_programGen, sizeof(m_programGen) );
+				bx::memCopy(m_programReady, m_render->m_programReady, sizeof(m_programReady) );
+			}
+
 			renderSemPost();
 
 			if (m_flipAfterRender)
@@ -2480,6 +2975,18 @@ namespace bgfx
 		}
 	}
 
+	void rendererUpdateUniformGroup(RendererContextI* _renderCtx, uint16_t _group)
+	{
+		if (_group < BGFX_CONFIG_MAX_UNIFORM_GROUPS)
+		{
+			UniformBuffer* uniformBuffer = s_ctx->m_uniformGroup[_group];
+			if (NULL != uniformBuffer)
+			{
+				rendererUpdateUniforms(_renderCtx, uniformBuffer, 0, UINT32_MAX);
+			}
+		}
+	}
+
 	void Context::flushTextureUpdateBatch(CommandBuffer& _cmdbuf)
 	{
 		if (m_textureUpdateBatch.sort() )
@@ -3039,6 +3546,11 @@ namespace bgfx
 					_cmdbuf.read(fsh);
 
 					m_renderCtx->createProgram(handle, vsh, gsh, fsh);
+
+					// Renderers creating programs asynchronously clear ready flag on
+					// submit, until program is done compiling.
+					++m_render->m_programGen[handle.idx];
+					m_render->m_programReady[handle.idx] = true;
 				}
 				break;
 
@@ -3050,6 +3562,7 @@ namespace bgfx
 					_cmdbuf.read(handle);
 
 					m_renderCtx->destroyProgram(handle);
+					m_render->m_programReady[handle.idx] = false;
 				}
 				break;
 
@@ -3259,6 +3772,30 @@ namespace bgfx
 				}
 				break;
 
+			case CommandBuffer::UpdateUniformGroup:
+				{
+					BGFX_PROFILER_SCOPE("UpdateUniformGroup", 0xff2040ff);
+
+					UniformGroupHandle handle;
+					_cmdbuf.read(handle);
+
+					uint32_t size;
+					_cmdbuf.read(size);
+
+					const uint8_t* data = _cmdbuf.skip(size);
+
+					UniformBuffer*& uniformBuffer = m_uniformGroup[handle.idx];
+					if (NULL != uniformBuffer)
+					{
+						UniformBuffer::destroy(uniformBuffer);
+					}
+
+					uniformBuffer = UniformBuffer::create(size+16);
+					uniformBuffer->write(data, size);
+					uniformBuffer->reset();
+				}
+				break;
+
 			case CommandBuffer::DestroyUniform:
 				{
 					BGFX_PROFILER_SCOPE("DestroyUniform", 0xff2040ff);
@@ -3270,6 +3807,22 @@ namespace bgfx
 				}
 				break;
 
+			case CommandBuffer::DestroyUniformGroup:
+				{
+					BGFX_PROFILER_SCOPE("DestroyUniformGroup", 0xff2040ff);
+
+					UniformGroupHandle handle;
+					_cmdbuf.read(handle);
+
+					UniformBuffer*& uniformBuffer = m_uniformGroup[handle.idx];
+					if (NULL != uniformBuffer)
+					{
+						UniformBuffer::destroy(uniformBuffer);
+						uniformBuffer = NULL;
+					}
+				}
+				break;
+
 			case CommandBuffer::UpdateViewName:
 				{
 					BGFX_PROFILER_SCOPE("UpdateViewName", 0xff2040ff);
@@ -3337,6 +3890,16 @@ namespace bgfx
 		topologySortTriList(_sort, _dst, _dstSize, _dir, _pos, _vertices, _stride, _indices, _numIndices, _index32, g_allocator);
 	}
 
+	void topologySortTriList(TopologySort::Enum _sort, void* _dst, uint32_t _dstSize, const float _dir[3], const float _pos[3], const void* _vertices, uint32_t _stride, const void* _indices, uint32_t _numIndices, bool _index32, TopologySortScratch& _scratch)
+	{
+		topologySortTriList(_sort, _dst, _dstSize, _dir, _pos, _vertices, _stride, _indices, _numIndices, _index32, _scratch, g_allocator);
+	}
+
+	uint32_t topologySortTriListScratchSize(uint32_t _numIndices)
+	{
+		return topologySortScratchSize(_numIndices);
+	}
+
 	uint8_t getSupportedRenderers(uint8_t _max, RendererType::Enum* _enum)
 	{
 		_enum = _max == 0 ? NULL : _enum;
@@ -3397,6 +3960,7 @@ namespace bgfx
 		, minResourceCbSize(BGFX_CONFIG_MIN_RESOURCE_COMMAND_BUFFER_SIZE)
 		, transientVbSize(BGFX_CONFIG_TRANSIENT_VERTEX_BUFFER_SIZE)
 		, transientIbSize(BGFX_CONFIG_TRANSIENT_INDEX_BUFFER_SIZE)
+		, numFrames(BGFX_CONFIG_DEFAULT_NUM_FRAMES)
 	{
 	}
 
@@ -3433,6 +3997,10 @@ namespace bgfx
 
 		init.limits.maxEncoders       = bx::clamp<uint16_t>(init.limits.maxEncoders, 1, (0 != BGFX_CONFIG_MULTITHREADED) ? 128 : 1);
 		init.limits.minResourceCbSize = bx::min<uint32_t>(init.limits.minResourceCbSize, BGFX_CONFIG_MIN_RESOURCE_COMMAND_BUFFER_SIZE);
+		init.limits.numFrames         = (0 != BGFX_CONFIG_MULTITHREADED)
+			? bx::clamp<uint8_t>(init.limits.numFrames, 2, BGFX_CONFIG_MAX_FRAMES)
+			: 1
+			;
 
 		struct ErrorState
 		{
@@ -3611,6 +4179,12 @@ namespace bgfx
 		BGFX_ENCODER(setGroup(_set, _group));
 	}
 
+	void Encoder::setGroup(UniformGroupHandle _handle)
+	{
+		BGFX_CHECK_HANDLE("setGroup", s_ctx->m_uniformGroupHandle, _handle);
+		BGFX_ENCODER(setGroup(UniformSet::Group, _handle.idx) );
+	}
+
 	void Encoder::setCondition(OcclusionQueryHandle _handle, bool _visible)
 	{
 		BGFX_CHECK_CAPS(BGFX_CAPS_OCCLUSION_QUERY, "Occlusion query is not supported!");
@@ -3789,6 +4363,56 @@ namespace bgfx
 		BGFX_ENCODER(setInstanceCount(_numInstances) );
 	}
 
+	void Encoder::allocTransientIndexBuffer(TransientIndexBuffer* _tib, uint32_t _num, bool _index32)
+	{
+		BX_ASSERT(NULL != _tib, "_tib can't be NULL");
+		BX_ASSERT(0 < _num, "Requesting 0 indices.");
+		BX_ASSERT(
+			  !_index32 || 0 != (g_caps.supported & BGFX_CAPS_INDEX32)
+			, "32-bit indices are not supported. Use bgfx::getCaps to check BGFX_CAPS_INDEX32 backend renderer capabilities."
+			);
+
+		BGFX_ENCODER(allocTransientIndexBuffer(_tib, _num, _index32) );
+
+		const uint32_t indexSize = _tib->isIndex16 ? 2 : 4;
+		BX_ASSERT(_num == _tib->size/indexSize
+			, "Failed to allocate transient index buffer (requested %d, available %d). "
+			  "Use bgfx::Encoder::allocTransientBuffers to ensure availability."
+			, _num
+			, _tib->size/indexSize
+			);
+		BX_UNUSED(indexSize);
+	}
+
+	void Encoder::allocTransientVertexBuffer(TransientVertexBuffer* _tvb, uint32_t _num, const VertexLayout& _layout)
+	{
+		BX_ASSERT(NULL != _tvb, "_tvb can't be NULL");
+		BX_ASSERT(0 < _num, "Requesting 0 vertices.");
+		BX_ASSERT(isValid(_layout), "Invalid VertexLayout.");
+
+		BGFX_ENCODER(allocTransientVertexBuffer(_tvb, _num, _layout) );
+
+		BX_ASSERT(_num == _tvb->size / _layout.m_stride
+			, "Failed to allocate transient vertex buffer (requested %d, available %d). "
+			  "Use bgfx::Encoder::allocTransientBuffers to ensure availability."
+			, _num
+			, _tvb->size / _layout.m_stride
+			);
+	}
+
+	bool Encoder::allocTransientBuffers(TransientVertexBuffer* _tvb, const VertexLayout& _layout, uint32_t _numVertices, TransientIndexBuffer* _tib, uint32_t _numIndices, bool _index32)
+	{
+		BX_ASSERT(NULL != _tvb, "_tvb can't be NULL");
+		BX_ASSERT(NULL != _tib, "_tib can't be NULL");
+		BX_ASSERT(isValid(_layout), "Invalid VertexLayout.");
+		BX_ASSERT(
+			  !_index32 || 0 != (g_caps.supported & BGFX_CAPS_INDEX32)
+			, "32-bit indices are not supported. Use bgfx::getCaps to check BGFX_CAPS_INDEX32 backend renderer capabilities."
+			);
+
+		return BGFX_ENCODER(allocTransientBuffers(_tvb, _layout, _numVertices, _tib, _numIndices, _index32) );
+	}
+
 	void Encoder::setTexture(uint8_t _stage, UniformHandle _sampler, TextureHandle _handle, uint32_t _flags)
 	{
 		BGFX_CHECK_HANDLE("setTexture/UniformHandle", s_ctx->m_uniformHandle, _sampler);
@@ -4268,10 +4892,74 @@ namespace bgfx
 		s_ctx->destroyIndirectBuffer(_handle);
 	}
 
+	// Returns copy of variant selected by key from shader variants binary, and releases
+	// _mem. Regular shader binary is returned as is.
+	static const Memory* findShaderVariant(const Memory* _mem, uint32_t _variantKey)
+	{
+		bx::MemoryReader reader(_mem->data, _mem->size);
+
+		bx::Error err;
+
+		uint32_t magic;
+		bx::read(&reader, magic, &err);
+
+		if (!err.isOk()
+		||  BGFX_CHUNK_MAGIC_SVR != magic)
+		{
+			return _mem;
+		}
+
+		uint32_t keyMask;
+		bx::read(&reader, keyMask, &err);
+
+		uint16_t num;
+		bx::read(&reader, num, &err);
+
+		const uint32_t key = _variantKey & keyMask;
+
+		for (uint32_t ii = 0; ii < num && err.isOk(); ++ii)
+		{
+			uint32_t variantKey;
+			bx::read(&reader, variantKey, &err);
+
+			uint32_t offset;
+			bx::read(&reader, offset, &err);
+
+			uint32_t size;
+			bx::read(&reader, size, &err);
+
+			if (err.isOk()
+			&&  key == variantKey
+			&&  offset <= _mem->size
+			&&  size   <= _mem->size - offset)
+			{
+				const Memory* mem = copy(&_mem->data[offset], size);
+				release(_mem);
+				return mem;
+			}
+		}
+
+		BX_TRACE("Shader variant 0x%08x not found (key mask 0x%08x).", key, keyMask);
+		release(_mem);
+		return NULL;
+	}
+
 	ShaderHandle createShader(const Memory* _mem)
+	{
+		return createShader(_mem, 0);
+	}
+
+	ShaderHandle createShader(const Memory* _mem, uint32_t _variantKey)
 	{
 		BX_ASSERT(NULL != _mem, "_mem can't be NULL");
-		return s_ctx->createShader(_mem);
+
+		const Memory* mem = findShaderVariant(_mem, _variantKey);
+		if (NULL == mem)
+		{
+			return BGFX_INVALID_HANDLE;
+		}
+
+		return s_ctx->createShader(mem);
 	}
 
 	uint16_t getShaderUniforms(ShaderHandle _handle, UniformHandle* _uniforms, uint16_t _max)
@@ -4326,11 +5014,48 @@ namespace bgfx
 		return s_ctx->createProgram(_csh, _destroyShader);
 	}
 
+	ProgramHandle createProgram(const Memory* _vsMem, const Memory* _fsMem, uint32_t _variantKey)
+	{
+		ShaderHandle vsh = createShader(_vsMem, _variantKey);
+		ShaderHandle fsh = BGFX_INVALID_HANDLE;
+		if (NULL != _fsMem)
+		{
+			fsh = createShader(_fsMem, _variantKey);
+		}
+
+		// Program takes ownership of shaders, even when it fails to create program. Shaders
+		// are destroyed here only when program creation is not attempted.
+		if (!isValid(vsh)
+		|| (NULL != _fsMem && !isValid(fsh) ) )
+		{
+			if (isValid(vsh) )
+			{
+				destroy(vsh);
+			}
+
+			if (isValid(fsh) )
+			{
+				destroy(fsh);
+			}
+
+			return BGFX_INVALID_HANDLE;
+		}
+
+		// Shaders and programs are deduplicated, selecting the same variant again returns
+		// existing program with its reference count incremented.
+		return createProgram(vsh, fsh, true);
+	}
+
 	void destroy(ProgramHandle _handle)
 	{
 		s_ctx->destroyProgram(_handle);
 	}
 
+	bool isProgramReady(ProgramHandle _handle)
+	{
+		return s_ctx->isProgramReady(_handle);
+	}
+
 	void isFrameBufferValid(uint8_t _num, const Attachment* _attachment, bx::Error* _err)
 	{
 		BX_ERROR_SCOPE(_err, "Frame buffer validation");
@@ -4990,6 +5715,27 @@ namespace bgfx
 		s_ctx->destroyUniform(_handle);
 	}
 
+	UniformGroupHandle createUniformGroup()
+	{
+		return s_ctx->createUniformGroup();
+	}
+
+	void updateUniformGroup(UniformGroupHandle _handle, UniformHandle _uniform, const void* _value, uint16_t _num)
+	{
+		BGFX_CHECK_HANDLE("updateUniformGroup", s_ctx->m_uniformHandle, _uniform);
+		const UniformRef& uniform = s_ctx->m_uniformRef[_uniform.idx];
+		BX_ASSERT(isValid(_uniform) && 0 < uniform.m_refCount, "Setting invalid uniform (handle %3d)!", _uniform.idx);
+		BX_ASSERT(_num == UINT16_MAX || uniform.m_num >= _num, "Truncated uniform update. %d (max: %d)", _num, uniform.m_num);
+		BX_ASSERT(uniform.m_freq == bgfx::UniformSet::Group, "Uniform was not declared as per-group");
+
+		s_ctx->updateUniformGroup(_handle, uniform.m_type, _uniform, _value, UINT16_MAX == _num ? uniform.m_num : _num);
+	}
+
+	void destroy(UniformGroupHandle _handle)
+	{
+		s_ctx->destroyUniformGroup(_handle);
+	}
+
 	OcclusionQueryHandle createOcclusionQuery()
 	{
 		BGFX_CHECK_CAPS(BGFX_CAPS_OCCLUSION_QUERY, "Occlusion query is not supported!");
@@ -5145,6 +5891,12 @@ namespace bgfx
 		s_ctx->m_encoder0->setGroup(_set, _group);
 	}
 
+	void setGroup(UniformGroupHandle _handle)
+	{
+		BGFX_CHECK_API_THREAD();
+		s_ctx->m_encoder0->setGroup(_handle);
+	}
+
 	void setCondition(OcclusionQueryHandle _handle, bool _visible)
 	{
 		BGFX_CHECK_API_THREAD();
@@ -39,6 +39,7 @@ BGFX_C99_STRUCT_SIZE_CHECK(bgfx::VertexLayout,          bgfx_vertex_layout_t);
 BGFX_C99_STRUCT_SIZE_CHECK(bgfx::TransientIndexBuffer,  bgfx_transient_index_buffer_t);
 BGFX_C99_STRUCT_SIZE_CHECK(bgfx::TransientVertexBuffer, bgfx_transient_vertex_buffer_t);
 BGFX_C99_STRUCT_SIZE_CHECK(bgfx::InstanceDataBuffer,    bgfx_instance_data_buffer_t);
+BGFX_C99_STRUCT_SIZE_CHECK(bgfx::TopologySortScratch,   bgfx_topology_sort_scratch_t);
 BGFX_C99_STRUCT_SIZE_CHECK(bgfx::TextureInfo,           bgfx_texture_info_t);
 BGFX_C99_STRUCT_SIZE_CHECK(bgfx::UniformInfo,           bgfx_uniform_info_t);
 BGFX_C99_STRUCT_SIZE_CHECK(bgfx::Attachment,            bgfx_attachment_t);
@@ -130,6 +131,17 @@ BGFX_C_API void bgfx_topology_sort_tri_list(bgfx_topology_sort_t _sort, void* _d
 	bgfx::topologySortTriList((bgfx::TopologySort::Enum)_sort, _dst, _dstSize, _dir, _pos, _vertices, _stride, _indices, _numIndices, _index32);
 }
 
+BGFX_C_API void bgfx_topology_sort_tri_list_scratch(bgfx_topology_sort_t _sort, void* _dst, uint32_t _dstSize, const float _dir[3], const float _pos[3], const void* _vertices, uint32_t _stride, const void* _indices, uint32_t _numIndices, bool _index32, bgfx_topology_sort_scratch_t * _scratch)
+{
+	bgfx::TopologySortScratch & scratch = *(bgfx::TopologySortScratch *)_scratch;
+	bgfx::topologySortTriList((bgfx::TopologySort::Enum)_sort, _dst, _dstSize, _dir, _pos, _vertices, _stride, _indices, _numIndices, _index32, scratch);
+}
+
+BGFX_C_API uint32_t bgfx_topology_sort_tri_list_scratch_size(uint32_t _numIndices)
+{
+	return bgfx::topologySortTriListScratchSize(_numIndices);
+}
+
 BGFX_C_API uint8_t bgfx_get_supported_renderers(uint8_t _max, bgfx_renderer_type_t* _enum)
 {
 	return bgfx::getSupportedRenderers(_max, (bgfx::RendererType::Enum*)_enum);
@@ -387,6 +399,13 @@ BGFX_C_API bgfx_shader_handle_t bgfx_create_shader(const bgfx_memory_t* _mem)
 	return handle_ret.c;
 }
 
+BGFX_C_API bgfx_shader_handle_t bgfx_create_shader_variant(const bgfx_memory_t* _mem, uint32_t _variantKey)
+{
+	union { bgfx_shader_handle_t c; bgfx::ShaderHandle cpp; } handle_ret;
+	handle_ret.cpp = bgfx::createShader((const bgfx::Memory*)_mem, _variantKey);
+	return handle_ret.c;
+}
+
 BGFX_C_API uint16_t bgfx_get_shader_uniforms(bgfx_shader_handle_t _handle, bgfx_uniform_handle_t* _uniforms, uint16_t _max)
 {
 	union { bgfx_shader_handle_t c; bgfx::ShaderHandle cpp; } handle = { _handle };
@@ -422,12 +441,25 @@ BGFX_C_API bgfx_program_handle_t bgfx_create_compute_program(bgfx_shader_handle_
 	return handle_ret.c;
 }
 
+BGFX_C_API bgfx_program_handle_t bgfx_create_program_variant(const bgfx_memory_t* _vsMem, const bgfx_memory_t* _fsMem, uint32_t _variantKey)
+{
+	union { bgfx_program_handle_t c; bgfx::ProgramHandle cpp; } handle_ret;
+	handle_ret.cpp = bgfx::createProgram((const bgfx::Memory*)_vsMem, (const bgfx::Memory*)_fsMem, _variantKey);
+	return handle_ret.c;
+}
+
 BGFX_C_API void bgfx_destroy_program(bgfx_program_handle_t _handle)
 {
 	union { bgfx_program_handle_t c; bgfx::ProgramHandle cpp; } handle = { _handle };
 	bgfx::destroy(handle.cpp);
 }
 
+BGFX_C_API bool bgfx_is_program_ready(bgfx_program_handle_t _handle)
+{
+	union { bgfx_program_handle_t c; bgfx::ProgramHandle cpp; } handle = { _handle };
+	return bgfx::isProgramReady(handle.cpp);
+}
+
 BGFX_C_API bool bgfx_is_texture_valid(uint16_t _depth, bool _cubeMap, uint16_t _numLayers, bgfx_texture_format_t _format, uint64_t _flags)
 {
 	return bgfx::isTextureValid(_depth, _cubeMap, _numLayers, (bgfx::TextureFormat::Enum)_format, _flags);
@@ -596,6 +628,26 @@ BGFX_C_API void bgfx_destroy_uniform(bgfx_uniform_handle_t _handle)
 	bgfx::destroy(handle.cpp);
 }
 
+BGFX_C_API bgfx_uniform_group_handle_t bgfx_create_uniform_group(void)
+{
+	union { bgfx_uniform_group_handle_t c; bgfx::UniformGroupHandle cpp; } handle_ret;
+	handle_ret.cpp = bgfx::createUniformGroup();
+	return handle_ret.c;
+}
+
+BGFX_C_API void bgfx_update_uniform_group(bgfx_uniform_group_handle_t _handle, bgfx_uniform_handle_t _uniform, const void* _value, uint16_t _num)
+{
+	union { bgfx_uniform_group_handle_t c; bgfx::UniformGroupHandle cpp; } handle = { _handle };
+	union { bgfx_uniform_handle_t c; bgfx::UniformHandle cpp; } uniform = { _uniform };
+	bgfx::updateUniformGroup(handle.cpp, uniform.cpp, _value, _num);
+}
+
+BGFX_C_API void bgfx_destroy_uniform_group(bgfx_uniform_group_handle_t _handle)
+{
+	union { bgfx_uniform_group_handle_t c; bgfx::UniformGroupHandle cpp; } handle = { _handle };
+	bgfx::destroy(handle.cpp);
+}
+
 BGFX_C_API bgfx_occlusion_query_handle_t bgfx_create_occlusion_query(void)
 {
 	union { bgfx_occlusion_query_handle_t c; bgfx::OcclusionQueryHandle cpp; } handle_ret;
@@ -703,6 +755,13 @@ BGFX_C_API void bgfx_encoder_set_state(bgfx_encoder_t* _this, uint64_t _state, u
 	This->setState(_state, _rgba);
 }
 
+BGFX_C_API void bgfx_encoder_set_group(bgfx_encoder_t* _this, bgfx_uniform_group_handle_t _handle)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	union { bgfx_uniform_group_handle_t c; bgfx::UniformGroupHandle cpp; } handle = { _handle };
+	This->setGroup(handle.cpp);
+}
+
 BGFX_C_API void bgfx_encoder_set_condition(bgfx_encoder_t* _this, bgfx_occlusion_query_handle_t _handle, bool _visible)
 {
 	bgfx::Encoder* This = (bgfx::Encoder*)_this;
@@ -848,6 +907,26 @@ BGFX_C_API void bgfx_encoder_set_instance_count(bgfx_encoder_t* _this, uint32_t
 	This->setInstanceCount(_numInstances);
 }
 
+BGFX_C_API void bgfx_encoder_alloc_transient_index_buffer(bgfx_encoder_t* _this, bgfx_transient_index_buffer_t* _tib, uint32_t _num, bool _index32)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	This->allocTransientIndexBuffer((bgfx::TransientIndexBuffer*)_tib, _num, _index32);
+}
+
+BGFX_C_API void bgfx_encoder_alloc_transient_vertex_buffer(bgfx_encoder_t* _this, bgfx_transient_vertex_buffer_t* _tvb, uint32_t _num, const bgfx_vertex_layout_t * _layout)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	const bgfx::VertexLayout & layout = *(const bgfx::VertexLayout *)_layout;
+	This->allocTransientVertexBuffer((bgfx::TransientVertexBuffer*)_tvb, _num, layout);
+}
+
+BGFX_C_API bool bgfx_encoder_alloc_transient_buffers(bgfx_encoder_t* _this, bgfx_transient_vertex_buffer_t* _tvb, const bgfx_vertex_layout_t * _layout, uint32_t _numVertices, bgfx_transient_index_buffer_t* _tib, uint32_t _numIndices, bool _index32)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	const bgfx::VertexLayout & layout = *(const bgfx::VertexLayout *)_layout;
+	return This->allocTransientBuffers((bgfx::TransientVertexBuffer*)_tvb, layout, _numVertices, (bgfx::TransientIndexBuffer*)_tib, _numIndices, _index32);
+}
+
 BGFX_C_API void bgfx_encoder_set_texture(bgfx_encoder_t* _this, uint8_t _stage, bgfx_uniform_handle_t _sampler, bgfx_texture_handle_t _handle, uint32_t _flags)
 {
 	bgfx::Encoder* This = (bgfx::Encoder*)_this;
@@ -1000,6 +1079,12 @@ BGFX_C_API void bgfx_set_state(uint64_t _state, uint32_t _rgba)
 	bgfx::setState(_state, _rgba);
 }
 
+BGFX_C_API void bgfx_set_group(bgfx_uniform_group_handle_t _handle)
+{
+	union { bgfx_uniform_group_handle_t c; bgfx::UniformGroupHandle cpp; } handle = { _handle };
+	bgfx::setGroup(handle.cpp);
+}
+
 BGFX_C_API void bgfx_set_condition(bgfx_occlusion_query_handle_t _handle, bool _visible)
 {
 	union { bgfx_occlusion_query_handle_t c; bgfx::OcclusionQueryHandle cpp; } handle = { _handle };
@@ -1269,6 +1354,8 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_weld_vertices,
 			bgfx_topology_convert,
 			bgfx_topology_sort_tri_list,
+			bgfx_topology_sort_tri_list_scratch,
+			bgfx_topology_sort_tri_list_scratch_size,
 			bgfx_get_supported_renderers,
 			bgfx_get_renderer_name,
 			bgfx_init_ctor,
@@ -1314,12 +1401,15 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_create_indirect_buffer,
 			bgfx_destroy_indirect_buffer,
 			bgfx_create_shader,
+			bgfx_create_shader_variant,
 			bgfx_get_shader_uniforms,
 			bgfx_set_shader_name,
 			bgfx_destroy_shader,
 			bgfx_create_program,
 			bgfx_create_compute_program,
+			bgfx_create_program_variant,
 			bgfx_destroy_program,
+			bgfx_is_program_ready,
 			bgfx_is_texture_valid,
 			bgfx_is_frame_buffer_valid,
 			bgfx_calc_texture_size,
@@ -1346,6 +1436,9 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_create_uniform,
 			bgfx_get_uniform_info,
 			bgfx_destroy_uniform,
+			bgfx_create_uniform_group,
+			bgfx_update_uniform_group,
+			bgfx_destroy_uniform_group,
 			bgfx_create_occlusion_query,
 			bgfx_get_result,
 			bgfx_destroy_occlusion_query,
@@ -1366,6 +1459,7 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_encoder_end,
 			bgfx_encoder_set_marker,
 			bgfx_encoder_set_state,
+			bgfx_encoder_set_group,
 			bgfx_encoder_set_condition,
 			bgfx_encoder_set_stencil,
 			bgfx_encoder_set_scissor,
@@ -1388,6 +1482,9 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_encoder_set_instance_data_from_vertex_buffer,
 			bgfx_encoder_set_instance_data_from_dynamic_vertex_buffer,
 			bgfx_encoder_set_instance_count,
+			bgfx_encoder_alloc_transient_index_buffer,
+			bgfx_encoder_alloc_transient_vertex_buffer,
+			bgfx_encoder_alloc_transient_buffers,
 			bgfx_encoder_set_texture,
 			bgfx_encoder_touch,
 			bgfx_encoder_submit,
@@ -1411,6 +1508,7 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_override_internal_texture,
 			bgfx_set_marker,
 			bgfx_set_state,
+			bgfx_set_group,
 			bgfx_set_condition,
 			bgfx_set_stencil,
 			bgfx_set_scissor,
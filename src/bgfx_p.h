@@ -158,6 +158,7 @@ namespace bgfx
 #include "version.h"
 
 #define BGFX_CHUNK_MAGIC_TEX BX_MAKEFOURCC('T', 'E', 'X', 0x0)
+#define BGFX_CHUNK_MAGIC_SVR BX_MAKEFOURCC('S', 'V', 'R', 0x0)
 
 #define BGFX_CLEAR_COLOR_USE_PALETTE UINT16_C(0x8000)
 #define BGFX_CLEAR_MASK (0                 \
@@ -375,6 +376,31 @@ namespace bgfx
 		return (_magic & BX_MAKEFOURCC(0, 0, 0, 0xff) ) < BX_MAKEFOURCC(0, 0, 0, _version);
 	}
 
+	/// Reads uniform name hash and predefined uniform enum that shaderc stores after each
+	/// uniform table entry since shader binary version 12. For older binaries they are
+	/// computed from uniform name.
+	inline void readUniformReflection(
+		  bx::ReaderI* _reader
+		, uint32_t _magic
+		, const char* _name
+		, uint32_t& _outNameHash
+		, PredefinedUniform::Enum& _outPredefined
+		, bx::Error* _err = NULL
+		)
+	{
+		if (isShaderVerLess(_magic, 12) )
+		{
+			_outNameHash   = bx::hash<bx::HashMurmur2A>(_name);
+			_outPredefined = nameToPredefinedUniformEnum(_name);
+			return;
+		}
+
+		uint8_t predefined = PredefinedUniform::Count;
+		bx::read(_reader, _outNameHash, _err);
+		bx::read(_reader, predefined, _err);
+		_outPredefined = PredefinedUniform::Enum(bx::min<uint8_t>(predefined, PredefinedUniform::Count) );
+	}
+
 	const char* getShaderTypeName(uint32_t _magic);
 
 	struct Clear
@@ -814,6 +840,7 @@ namespace bgfx
 			ResizeTexture,
 			CreateFrameBuffer,
 			CreateUniform,
+			UpdateUniformGroup,
 			UpdateViewName,
 			InvalidateOcclusionQuery,
 			SetName,
@@ -829,6 +856,7 @@ namespace bgfx
 			DestroyTexture,
 			DestroyFrameBuffer,
 			DestroyUniform,
+			DestroyUniformGroup,
 			ReadTexture,
 		};
 
@@ -961,7 +989,13 @@ namespace bgfx
 	constexpr uint8_t  kSortKeyDraw0ProgramShift   = kSortKeyDraw0BlendShift - BGFX_CONFIG_SORT_KEY_NUM_BITS_PROGRAM;
 	constexpr uint64_t kSortKeyDraw0ProgramMask    = uint64_t(BGFX_CONFIG_MAX_PROGRAMS-1)<<kSortKeyDraw0ProgramShift;
 
-	constexpr uint8_t  kSortKeyDraw0DepthShift     = kSortKeyDraw0ProgramShift - BGFX_CONFIG_SORT_KEY_NUM_BITS_DEPTH;
+	constexpr uint8_t  kSortKeyDraw0StateShift     = kSortKeyDraw0ProgramShift - BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE;
+	constexpr uint64_t kSortKeyDraw0StateMask      = ( (uint64_t(1)<<BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE)-1)<<kSortKeyDraw0StateShift;
+
+	constexpr uint8_t  kSortKeyDraw0TextureShift   = kSortKeyDraw0StateShift - BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE;
+	constexpr uint64_t kSortKeyDraw0TextureMask    = ( (uint64_t(1)<<BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE)-1)<<kSortKeyDraw0TextureShift;
+
+	constexpr uint8_t  kSortKeyDraw0DepthShift     = kSortKeyDraw0TextureShift - BGFX_CONFIG_SORT_KEY_NUM_BITS_DEPTH;
 	constexpr uint64_t kSortKeyDraw0DepthMask      = ( (uint64_t(1)<<BGFX_CONFIG_SORT_KEY_NUM_BITS_DEPTH)-1)<<kSortKeyDraw0DepthShift;
 
 	//
@@ -974,6 +1008,12 @@ namespace bgfx
 	constexpr uint8_t  kSortKeyDraw1ProgramShift   = kSortKeyDraw1BlendShift - BGFX_CONFIG_SORT_KEY_NUM_BITS_PROGRAM;
 	constexpr uint64_t kSortKeyDraw1ProgramMask    = uint64_t(BGFX_CONFIG_MAX_PROGRAMS-1)<<kSortKeyDraw1ProgramShift;
 
+	constexpr uint8_t  kSortKeyDraw1StateShift     = kSortKeyDraw1ProgramShift - BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE;
+	constexpr uint64_t kSortKeyDraw1StateMask      = ( (uint64_t(1)<<BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE)-1)<<kSortKeyDraw1StateShift;
+
+	constexpr uint8_t  kSortKeyDraw1TextureShift   = kSortKeyDraw1StateShift - BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE;
+	constexpr uint64_t kSortKeyDraw1TextureMask    = ( (uint64_t(1)<<BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE)-1)<<kSortKeyDraw1TextureShift;
+
 	//
 	constexpr uint8_t  kSortKeyDraw2SeqShift       = kSortKeyDrawTypeBitShift - BGFX_CONFIG_SORT_KEY_NUM_BITS_SEQ;
 	constexpr uint64_t kSortKeyDraw2SeqMask        = ( (uint64_t(1)<<BGFX_CONFIG_SORT_KEY_NUM_BITS_SEQ)-1)<<kSortKeyDraw2SeqShift;
@@ -992,6 +1032,14 @@ namespace bgfx
 	constexpr uint64_t kSortKeyComputeProgramMask  = uint64_t(BGFX_CONFIG_MAX_PROGRAMS-1)<<kSortKeyComputeProgramShift;
 
 	BX_STATIC_ASSERT(BGFX_CONFIG_MAX_VIEWS <= (1<<kSortKeyViewNumBits) );
+	BX_STATIC_ASSERT(kSortKeyDrawTypeBitShift >= 0 // Draw key bit budget.
+		+ kSortKeyTransNumBits
+		+ BGFX_CONFIG_SORT_KEY_NUM_BITS_PROGRAM
+		+ BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE
+		+ BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE
+		+ BGFX_CONFIG_SORT_KEY_NUM_BITS_DEPTH
+		, "Sort key bit budget exceeded, reduce BGFX_CONFIG_SORT_KEY_NUM_BITS_* values."
+		);
 	BX_STATIC_ASSERT( (BGFX_CONFIG_MAX_PROGRAMS & (BGFX_CONFIG_MAX_PROGRAMS-1) ) == 0); // Must be power of 2.
 	BX_STATIC_ASSERT( (0 // Render key mask shouldn't overlap.
 		| kSortKeyViewMask
@@ -999,6 +1047,8 @@ namespace bgfx
 		| kSortKeyDrawTypeMask
 		| kSortKeyDraw0BlendMask
 		| kSortKeyDraw0ProgramMask
+		| kSortKeyDraw0StateMask
+		| kSortKeyDraw0TextureMask
 		| kSortKeyDraw0DepthMask
 		) == (0
 		^ kSortKeyViewMask
@@ -1006,6 +1056,8 @@ namespace bgfx
 		^ kSortKeyDrawTypeMask
 		^ kSortKeyDraw0BlendMask
 		^ kSortKeyDraw0ProgramMask
+		^ kSortKeyDraw0StateMask
+		^ kSortKeyDraw0TextureMask
 		^ kSortKeyDraw0DepthMask
 		) );
 	BX_STATIC_ASSERT( (0 // Render key mask shouldn't overlap.
@@ -1015,6 +1067,8 @@ namespace bgfx
 		| kSortKeyDraw1DepthMask
 		| kSortKeyDraw1BlendMask
 		| kSortKeyDraw1ProgramMask
+		| kSortKeyDraw1StateMask
+		| kSortKeyDraw1TextureMask
 		) == (0
 		^ kSortKeyViewMask
 		^ kSortKeyDrawBit
@@ -1022,6 +1076,8 @@ namespace bgfx
 		^ kSortKeyDraw1DepthMask
 		^ kSortKeyDraw1BlendMask
 		^ kSortKeyDraw1ProgramMask
+		^ kSortKeyDraw1StateMask
+		^ kSortKeyDraw1TextureMask
 		) );
 	BX_STATIC_ASSERT( (0 // Render key mask shouldn't overlap.
 		| kSortKeyViewMask
@@ -1058,16 +1114,22 @@ namespace bgfx
 	// |  view-+|                                                       |
 	// |        +-draw                                                  |
 	// |----------------------------------------------------------------| Draw Key 0 - Sort by program
-	// |        |kkttpppppppppdddddddddddddddddddddddddddddddd          |
-	// |        |   ^        ^                               ^          |
-	// |        |   |        |                               |          |
-	// |        |   +-blend  +-program                 depth-+          |
+	// |        |kkttppppppppp[state][texture]dddddddddddddddddddddddddd|
+	// |        |   ^        ^    ^        ^                           ^|
+	// |        |   |        |    |        |                           ||
+	// |        |   +-blend  +-program     +-texture             depth-+|
+	// |        |                 +-state                               |
 	// |        |                                                       |
 	// |----------------------------------------------------------------| Draw Key 1 - Sort by depth
-	// |        |kkddddddddddddddddddddddddddddddddttppppppppp          |
-	// |        |                                ^^ ^        ^          |
-	// |        |                                || +-trans  |          |
-	// |        |                          depth-+   program-+          |
+	// |        |kkddddddddddddddddddddddddddddddddttppppppppp[s][t]    |
+	// |        |                                ^^ ^        ^  ^  ^    |
+	// |        |                                || +-trans  |  |  |    |
+	// |        |                          depth-+   program-+  |  |    |
+	// |        |                                         state-+  |    |
+	// |        |                                         texture--+    |
+	// |        |                                                       |
+	// | State and texture hash bits are 0 wide by default, see         |
+	// | BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE/TEXTURE.                   |
 	// |        |                                                       |
 	// |----------------------------------------------------------------| Draw Key 2 - Sequential
 	// |        |kkssssssssssssssssssssttppppppppp                      |
@@ -1099,10 +1161,12 @@ namespace bgfx
 			case SortProgram:
 				{
 					const uint64_t depth   = (uint64_t(m_depth      ) << kSortKeyDraw0DepthShift  ) & kSortKeyDraw0DepthMask;
+					const uint64_t texture = (encodeHash(m_texture, BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE) << kSortKeyDraw0TextureShift) & kSortKeyDraw0TextureMask;
+					const uint64_t state   = (encodeHash(m_state,   BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE  ) << kSortKeyDraw0StateShift  ) & kSortKeyDraw0StateMask;
 					const uint64_t program = (uint64_t(m_program.idx) << kSortKeyDraw0ProgramShift) & kSortKeyDraw0ProgramMask;
 					const uint64_t blend   = (uint64_t(m_blend      ) << kSortKeyDraw0BlendShift  ) & kSortKeyDraw0BlendMask;
 					const uint64_t view    = (uint64_t(m_view       ) << kSortKeyViewBitShift     ) & kSortKeyViewMask;
-					const uint64_t key     = view|kSortKeyDrawBit|kSortKeyDrawTypeProgram|blend|program|depth;
+					const uint64_t key     = view|kSortKeyDrawBit|kSortKeyDrawTypeProgram|blend|program|state|texture|depth;
 
 					return key;
 				}
@@ -1112,9 +1176,11 @@ namespace bgfx
 				{
 					const uint64_t depth   = (uint64_t(m_depth      ) << kSortKeyDraw1DepthShift  ) & kSortKeyDraw1DepthMask;
 					const uint64_t program = (uint64_t(m_program.idx) << kSortKeyDraw1ProgramShift) & kSortKeyDraw1ProgramMask;
+					const uint64_t state   = (encodeHash(m_state,   BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE  ) << kSortKeyDraw1StateShift  ) & kSortKeyDraw1StateMask;
+					const uint64_t texture = (encodeHash(m_texture, BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE) << kSortKeyDraw1TextureShift) & kSortKeyDraw1TextureMask;
 					const uint64_t blend   = (uint64_t(m_blend      ) << kSortKeyDraw1BlendShift) & kSortKeyDraw1BlendMask;
 					const uint64_t view    = (uint64_t(m_view       ) << kSortKeyViewBitShift     ) & kSortKeyViewMask;
-					const uint64_t key     = view|kSortKeyDrawBit|kSortKeyDrawTypeDepth|depth|blend|program;
+					const uint64_t key     = view|kSortKeyDrawBit|kSortKeyDrawTypeDepth|depth|blend|program|state|texture;
 					return key;
 				}
 				break;
@@ -1185,6 +1251,12 @@ namespace bgfx
 			return true; // compute
 		}
 
+		/// Returns top _numBits of 32-bit hash.
+		static uint64_t encodeHash(uint32_t _hash, uint8_t _numBits)
+		{
+			return uint64_t(_hash) >> (32 - _numBits);
+		}
+
 		static ProgramHandle decodeProgram(uint64_t _key, uint64_t _mask, uint8_t _shift)
 		{
 			uint16_t idx = uint16_t( (_key & _mask) >> _shift);
@@ -1215,10 +1287,14 @@ namespace bgfx
 			m_program = {0};
 			m_view    = 0;
 			m_blend   = 0;
+			m_state   = 0;
+			m_texture = 0;
 		}
 
 		uint32_t      m_depth;
 		uint32_t      m_seq;
+		uint32_t      m_state;
+		uint32_t      m_texture;
 		ProgramHandle m_program;
 		ViewId        m_view;
 		uint8_t       m_blend;
@@ -1494,6 +1570,11 @@ namespace bgfx
 		void writeUniformHandle(UniformType::Enum _type, uint16_t _loc, UniformHandle _handle, uint16_t _num = 1);
 		void writeMarker(const char* _marker);
 
+		// Replaces value of uniform at _loc in finished stream that holds at most one
+		// value per uniform, or appends it when it's not in stream yet. Stream is left
+		// finished.
+		static void replaceUniform(UniformBuffer** _uniformBuffer, UniformType::Enum _type, uint16_t _loc, const void* _value, uint16_t _num);
+
 	private:
 		UniformBuffer(uint32_t _size)
 			: m_size(_size)
@@ -1530,7 +1611,12 @@ namespace bgfx
 
 		const UniformRegInfo* find(const char* _name) const
 		{
-			uint16_t handle = m_uniforms.find(bx::hash<bx::HashMurmur2A>(_name) );
+			return find(bx::hash<bx::HashMurmur2A>(_name) );
+		}
+
+		const UniformRegInfo* find(uint32_t _nameHash) const
+		{
+			uint16_t handle = m_uniforms.find(_nameHash);
 			if (kInvalidHandle != handle)
 			{
 				return &m_info[handle];
@@ -1833,6 +1919,7 @@ namespace bgfx
 		ShaderHandle m_gsh;
 		ShaderHandle m_fsh;
 		int16_t      m_refCount;
+		uint16_t     m_gen; //!< Incremented each time handle is assigned to new program.
 	};
 
 	struct UniformRef
@@ -1844,6 +1931,12 @@ namespace bgfx
 		int16_t           m_refCount;
 	};
 
+	struct UniformGroupRef
+	{
+		UniformBuffer* m_uniformBuffer;
+		bool           m_dirty;
+	};
+
 	struct TextureRef
 	{
 		void init(
@@ -2050,6 +2143,53 @@ namespace bgfx
 		FrameBufferHandle handle;
 	};
 
+	/// Small fixed pool of worker threads used by render thread to split
+	/// frame work (e.g. sort) into equally sized jobs.
+	class JobPool
+	{
+	public:
+		typedef void (*JobFn)(void* _userData, uint32_t _idx);
+
+		JobPool()
+			: m_numWorkers(0)
+		{
+		}
+
+		void init(uint32_t _numThreads);
+
+		void shutdown();
+
+		uint32_t getNumThreads() const
+		{
+			return m_numWorkers+1;
+		}
+
+		/// Call _fn once for each thread in pool, passing job index. Calling
+		/// thread executes job 0. Returns when all jobs are done.
+		void run(JobFn _fn, void* _userData);
+
+	private:
+#if BGFX_CONFIG_MULTITHREADED
+		struct Worker
+		{
+			JobPool*      m_pool;
+			uint32_t      m_idx;
+			bx::Thread    m_thread;
+			bx::Semaphore m_start;
+		};
+
+		static int32_t workerThread(bx::Thread* _self, void* _userData);
+
+		Worker        m_worker[BGFX_CONFIG_SORT_NUM_THREADS];
+		bx::Semaphore m_done;
+		JobFn         m_fn;
+		void*         m_userData;
+		bool          m_exit;
+#endif // BGFX_CONFIG_MULTITHREADED
+
+		uint32_t m_numWorkers;
+	};
+
 	BX_ALIGN_DECL_CACHE_LINE(struct) Frame
 	{
 		Frame()
@@ -2065,6 +2205,8 @@ namespace bgfx
 			m_sortKeys[BGFX_CONFIG_MAX_DRAW_CALLS]   = term.encodeDraw(SortKey::SortProgram);
 			m_sortValues[BGFX_CONFIG_MAX_DRAW_CALLS] = BGFX_CONFIG_MAX_DRAW_CALLS;
 			bx::memSet(m_occlusion, 0xff, sizeof(m_occlusion) );
+			bx::memSet(m_programGen, 0, sizeof(m_programGen) );
+			bx::memSet(m_programReady, 0, sizeof(m_programReady) );
 
 			m_perfStats.viewStats = m_viewStats;
 		}
@@ -2090,6 +2232,8 @@ namespace bgfx
 				{
 					m_submitUniforms[ii] = UniformBuffer::create();
 				}
+
+				m_renderItemGap = (RenderItemRange*)BX_ALLOC(g_allocator, sizeof(RenderItemRange)*num);
 			}
 
 			reset();
@@ -2113,6 +2257,7 @@ namespace bgfx
 			//}
 
 			BX_FREE(g_allocator, m_submitUniforms);
+			BX_FREE(g_allocator, m_renderItemGap);
 			BX_DELETE(g_allocator, m_textVideoMem);
 		}
 
@@ -2129,8 +2274,9 @@ namespace bgfx
 			m_perfStats.transientIbUsed = m_iboffset;
 
 			m_frameCache.reset();
-			m_numRenderItems = 0;
-			m_numBlitItems   = 0;
+			m_numRenderItems    = 0;
+			m_numRenderItemGaps = 0;
+			m_numBlitItems      = 0;
 			m_iboffset = 0;
 			m_vboffset = 0;
 			m_cmdPre.start();
@@ -2149,6 +2295,8 @@ namespace bgfx
 			m_cmdPre.finish();
 			m_cmdPost.finish();
 
+			compactRenderItems();
+
 //			if (0 < m_numDropped)
 //			{
 //				BX_TRACE("Too many draw calls: %d, dropped %d (max: %d)"
@@ -2161,6 +2309,61 @@ namespace bgfx
 
 		void sort();
 
+		void addRenderItemGap(uint32_t _begin, uint32_t _end)
+		{
+			const uint32_t idx = bx::atomicFetchAndAdd<uint32_t>(&m_numRenderItemGaps, 1);
+			BX_ASSERT(idx < g_caps.limits.maxEncoders, "Too many render item gaps (%d).", idx);
+
+			RenderItemRange& gap = m_renderItemGap[idx];
+			gap.m_begin = _begin;
+			gap.m_end   = _end;
+		}
+
+		void compactRenderItems()
+		{
+			const uint32_t numGaps = m_numRenderItemGaps;
+			m_numRenderItemGaps = 0;
+
+			// Gaps are processed from the top down, so items moved into gap are never
+			// taken from another, not yet processed, gap.
+			for (uint32_t ii = 1; ii < numGaps; ++ii)
+			{
+				const RenderItemRange gap = m_renderItemGap[ii];
+
+				uint32_t jj = ii;
+				for (; 0 < jj && m_renderItemGap[jj-1].m_begin < gap.m_begin; --jj)
+				{
+					m_renderItemGap[jj] = m_renderItemGap[jj-1];
+				}
+
+				m_renderItemGap[jj] = gap;
+			}
+
+			uint32_t numItems = m_numRenderItems;
+
+			for (uint32_t ii = 0; ii < numGaps; ++ii)
+			{
+				const RenderItemRange& gap = m_renderItemGap[ii];
+				const uint32_t size = gap.m_end - gap.m_begin;
+				const uint32_t num  = bx::min(size, numItems - gap.m_end);
+
+				for (uint32_t jj = 0; jj < num; ++jj)
+				{
+					const uint32_t dst = gap.m_begin + jj;
+					const uint32_t src = numItems - num + jj;
+
+					m_sortKeys[dst]       = m_sortKeys[src];
+					m_sortValues[dst]     = RenderItemCount(dst);
+					m_renderItem[dst]     = m_renderItem[src];
+					m_renderItemBind[dst] = m_renderItemBind[src];
+				}
+
+				numItems -= size;
+			}
+
+			m_numRenderItems = numItems;
+		}
+
 		uint32_t getAvailTransientIndexBuffer(uint32_t _num)
 		{
 			uint32_t offset   = bx::strideAlign(m_iboffset, sizeof(uint16_t) );
@@ -2172,12 +2375,7 @@ namespace bgfx
 
 		uint32_t allocTransientIndexBuffer(uint32_t& _num, uint32_t _indexSize)
 		{
-			uint32_t offset = bx::strideAlign(m_iboffset, _indexSize);
-			uint32_t num    = getAvailTransientIndexBuffer(_num);
-			m_iboffset = offset + num*_indexSize;
-			_num = num;
-
-			return offset;
+			return allocTransient(&m_iboffset, g_caps.limits.transientIbSize, _num, _indexSize);
 		}
 
 		uint32_t getAvailTransientVertexBuffer(uint32_t _num, uint16_t _stride)
@@ -2191,14 +2389,46 @@ namespace bgfx
 
 		uint32_t allocTransientVertexBuffer(uint32_t& _num, uint16_t _stride)
 		{
-			uint32_t offset = bx::strideAlign(m_vboffset, _stride);
-			uint32_t num    = getAvailTransientVertexBuffer(_num, _stride);
-			m_vboffset = offset + num * _stride;
+			return allocTransient(&m_vboffset, g_caps.limits.transientVbSize, _num, _stride);
+		}
+
+		/// Reserves up to _num elements of _stride size from transient buffer, and
+		/// returns number of reserved elements in _num. Lock-free, since encoders
+		/// reserve transient pages concurrently.
+		static uint32_t allocTransient(uint32_t* _offset, uint32_t _size, uint32_t& _num, uint32_t _stride)
+		{
+			uint32_t offset;
+			uint32_t num;
+
+			for (uint32_t current = *_offset;;)
+			{
+				offset = bx::min(bx::strideAlign(current, _stride), _size);
+				num    = bx::min(_num, (_size - offset)/_stride);
+
+				const uint32_t prev = bx::atomicCompareAndSwap<uint32_t>(_offset, current, offset + num*_stride);
+				if (prev == current)
+				{
+					break;
+				}
+
+				current = prev;
+			}
+
 			_num = num;
 
 			return offset;
 		}
 
+		/// Returns [_begin, _end) range back to transient buffer. Only succeeds if
+		/// range is at the end of allocated space.
+		static void freeTransient(uint32_t* _offset, uint32_t _begin, uint32_t _end)
+		{
+			if (_begin != _end)
+			{
+				bx::atomicCompareAndSwap<uint32_t>(_offset, _end, _begin);
+			}
+		}
+
 		bool free(IndexBufferHandle _handle)
 		{
 			return m_freeIndexBuffer.queue(_handle);
@@ -2239,6 +2469,11 @@ namespace bgfx
 			return m_freeUniform.queue(_handle);
 		}
 
+		bool free(UniformGroupHandle _handle)
+		{
+			return m_freeUniformGroup.queue(_handle);
+		}
+
 		void resetFreeHandles()
 		{
 			m_freeIndexBuffer.reset();
@@ -2249,6 +2484,7 @@ namespace bgfx
 			m_freeTexture.reset();
 			m_freeFrameBuffer.reset();
 			m_freeUniform.reset();
+			m_freeUniformGroup.reset();
 		}
 
 		ViewId m_viewRemap[BGFX_CONFIG_MAX_VIEWS];
@@ -2258,6 +2494,9 @@ namespace bgfx
 
 		int32_t m_occlusion[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
 
+		uint16_t m_programGen[BGFX_CONFIG_MAX_PROGRAMS];
+		bool     m_programReady[BGFX_CONFIG_MAX_PROGRAMS];
+
 		uint64_t m_sortKeys[BGFX_CONFIG_MAX_DRAW_CALLS+1];
 		RenderItemCount m_sortValues[BGFX_CONFIG_MAX_DRAW_CALLS+1];
 		RenderItem m_renderItem[BGFX_CONFIG_MAX_DRAW_CALLS+1];
@@ -2271,6 +2510,15 @@ namespace bgfx
 		UniformBuffer* m_viewUniforms;
 		UniformBuffer** m_submitUniforms;
 
+		struct RenderItemRange
+		{
+			uint32_t m_begin;
+			uint32_t m_end;
+		};
+
+		RenderItemRange* m_renderItemGap;
+		uint32_t m_numRenderItemGaps;
+
 		uint32_t m_numRenderItems;
 		uint16_t m_numBlitItems;
 
@@ -2352,6 +2600,7 @@ namespace bgfx
 		FreeHandle<TextureHandle,      BGFX_CONFIG_MAX_TEXTURES>       m_freeTexture;
 		FreeHandle<FrameBufferHandle,  BGFX_CONFIG_MAX_FRAME_BUFFERS>  m_freeFrameBuffer;
 		FreeHandle<UniformHandle,      BGFX_CONFIG_MAX_UNIFORMS>       m_freeUniform;
+		FreeHandle<UniformGroupHandle, BGFX_CONFIG_MAX_UNIFORM_GROUPS> m_freeUniformGroup;
 
 		TextVideoMem* m_textVideoMem;
 
@@ -2386,10 +2635,36 @@ namespace bgfx
 
 			m_numSubmitted = 0;
 			m_numDropped   = 0;
+
+			m_renderItemNext = 0;
+			m_renderItemEnd  = 0;
+
+			m_transientVbPage.m_offset = 0;
+			m_transientVbPage.m_end    = 0;
+			m_transientIbPage.m_offset = 0;
+			m_transientIbPage.m_end    = 0;
+
+			for (uint32_t ii = 0; ii < BX_COUNTOF(m_layoutCache); ++ii)
+			{
+				m_layoutCache[ii].m_handle.idx = kInvalidHandle;
+			}
+			m_layoutCacheNext = 0;
 		}
 
 		void end(bool _finalize)
 		{
+			if (m_renderItemNext != m_renderItemEnd)
+			{
+				// Return unused part of reserved chunk, frame will compact it away.
+				m_frame->addRenderItemGap(m_renderItemNext, m_renderItemEnd);
+				m_renderItemNext = m_renderItemEnd;
+			}
+
+			Frame::freeTransient(&m_frame->m_vboffset, m_transientVbPage.m_offset, m_transientVbPage.m_end);
+			m_transientVbPage.m_offset = m_transientVbPage.m_end;
+			Frame::freeTransient(&m_frame->m_iboffset, m_transientIbPage.m_offset, m_transientIbPage.m_end);
+			m_transientIbPage.m_offset = m_transientIbPage.m_end;
+
 			if (_finalize)
 			{
 				m_frame->m_frameUniforms->finish();
@@ -2413,6 +2688,27 @@ namespace bgfx
 			}
 		}
 
+		uint32_t allocRenderItem()
+		{
+			if (m_renderItemNext == m_renderItemEnd)
+			{
+				const uint32_t idx = bx::atomicFetchAndAddsat<uint32_t>(
+					  &m_frame->m_numRenderItems
+					, BGFX_CONFIG_ENCODER_RENDER_ITEM_CHUNK
+					, BGFX_CONFIG_MAX_DRAW_CALLS
+					);
+				if (BGFX_CONFIG_MAX_DRAW_CALLS <= idx)
+				{
+					return BGFX_CONFIG_MAX_DRAW_CALLS;
+				}
+
+				m_renderItemNext = idx;
+				m_renderItemEnd  = bx::min<uint32_t>(idx + BGFX_CONFIG_ENCODER_RENDER_ITEM_CHUNK, BGFX_CONFIG_MAX_DRAW_CALLS);
+			}
+
+			return m_renderItemNext++;
+		}
+
 		void setMarker(const char* _name)
 		{
 			UniformBuffer* uniformBuffer = m_frame->m_submitUniforms[m_uniformIdx];
@@ -2629,6 +2925,60 @@ namespace bgfx
 			m_draw.m_numInstances = _numInstances;
 		}
 
+		struct TransientPage
+		{
+			uint32_t m_offset;
+			uint32_t m_end;
+		};
+
+		static bool fitsTransientPage(const TransientPage& _page, uint32_t _num, uint32_t _stride)
+		{
+			const uint32_t offset = bx::strideAlign(_page.m_offset, _stride);
+			return offset <= _page.m_end
+				&& _num <= (_page.m_end - offset)/_stride
+				;
+		}
+
+		/// Makes sure that page can fit _num elements of _stride size, by replacing
+		/// it with new page from frame if needed.
+		static bool reserveTransientPage(TransientPage& _page, uint32_t* _frameOffset, uint32_t _frameSize, uint32_t _num, uint32_t _stride)
+		{
+			if (fitsTransientPage(_page, _num, _stride) )
+			{
+				return true;
+			}
+
+			Frame::freeTransient(_frameOffset, _page.m_offset, _page.m_end);
+
+			uint32_t size = uint32_t(bx::min<uint64_t>(
+				  bx::max<uint64_t>(BGFX_CONFIG_ENCODER_TRANSIENT_PAGE_SIZE, uint64_t(_num)*_stride + _stride)
+				, UINT32_MAX
+				) );
+			_page.m_offset = Frame::allocTransient(_frameOffset, _frameSize, size, 1);
+			_page.m_end    = _page.m_offset + size;
+
+			return fitsTransientPage(_page, _num, _stride);
+		}
+
+		static uint32_t allocTransientPage(TransientPage& _page, uint32_t* _frameOffset, uint32_t _frameSize, uint32_t& _num, uint32_t _stride)
+		{
+			reserveTransientPage(_page, _frameOffset, _frameSize, _num, _stride);
+
+			const uint32_t offset = bx::min(bx::strideAlign(_page.m_offset, _stride), _page.m_end);
+			_num = bx::min(_num, (_page.m_end - offset)/_stride);
+			_page.m_offset = offset + _num*_stride;
+
+			return offset;
+		}
+
+		VertexLayoutHandle findTransientVertexLayout(const VertexLayout& _layout);
+
+		void allocTransientIndexBuffer(TransientIndexBuffer* _tib, uint32_t _num, bool _index32);
+
+		void allocTransientVertexBuffer(TransientVertexBuffer* _tvb, uint32_t _num, const VertexLayout& _layout);
+
+		bool allocTransientBuffers(TransientVertexBuffer* _tvb, const VertexLayout& _layout, uint32_t _numVertices, TransientIndexBuffer* _tib, uint32_t _numIndices, bool _index32);
+
 		void setTexture(uint8_t _stage, UniformHandle _sampler, TextureHandle _handle, uint32_t _flags)
 		{
 			Binding& bind = m_bind.m_bind[_stage];
@@ -2734,6 +3084,21 @@ namespace bgfx
 		uint32_t m_numSubmitted;
 		uint32_t m_numDropped;
 
+		uint32_t m_renderItemNext;
+		uint32_t m_renderItemEnd;
+
+		TransientPage m_transientVbPage;
+		TransientPage m_transientIbPage;
+
+		struct LayoutCache
+		{
+			uint32_t           m_hash;
+			VertexLayoutHandle m_handle;
+		};
+
+		LayoutCache m_layoutCache[4];
+		uint8_t     m_layoutCacheNext;
+
 		uint32_t m_uniformBegin;
 		uint32_t m_uniformEnd;
 		uint32_t m_numVertices[BGFX_CONFIG_MAX_VERTEX_STREAMS];
@@ -2845,7 +3210,10 @@ namespace bgfx
 		VertexLayoutHandle m_dynamicVertexBufferRef[BGFX_CONFIG_MAX_DYNAMIC_VERTEX_BUFFERS];
 	};
 
-	// First-fit non-local allocator.
+	/// Two-level segregated fit (TLSF) allocator for memory that is not directly
+	/// accessible by CPU, i.e. ranges inside of GPU buffers. Block metadata is
+	/// kept on side. Allocation and free are O(1), free blocks are coalesced
+	/// with adjacent free blocks on free.
 	class NonLocalAllocator
 	{
 	public:
@@ -2853,6 +3221,7 @@ namespace bgfx
 
 		NonLocalAllocator()
 		{
+			reset();
 		}
 
 		~NonLocalAllocator()
@@ -2861,24 +3230,53 @@ namespace bgfx
 
 		void reset()
 		{
-			m_free.clear();
+			m_block.clear();
 			m_used.clear();
+
+			m_freeNode   = kInvalidNode;
+			m_flBitmap   = 0;
+			m_totalSize  = 0;
+			m_usedSize   = 0;
+			m_peakSize   = 0;
+
+			bx::memSet(m_slBitmap, 0, sizeof(m_slBitmap) );
+			bx::memSet(m_freeHead, 0xff, sizeof(m_freeHead) );
 		}
 
 		void add(uint64_t _ptr, uint32_t _size)
 		{
-			m_free.push_back(Free(_ptr, _size) );
+			const uint32_t idx = allocNode();
+
+			Block& block = m_block[idx];
+			block.m_ptr      = _ptr;
+			block.m_size     = _size;
+			block.m_prevPhys = kInvalidNode;
+			block.m_nextPhys = kInvalidNode;
+
+			m_totalSize += _size;
+
+			insertFree(idx);
 		}
 
 		uint64_t remove()
 		{
 			BX_ASSERT(0 == m_used.size(), "");
 
-			if (0 < m_free.size() )
+			if (0 != m_flBitmap)
 			{
-				Free freeBlock = m_free.front();
-				m_free.pop_front();
-				return freeBlock.m_ptr;
+				const uint32_t fl  = bx::uint32_cnttz(m_flBitmap);
+				const uint32_t sl  = bx::uint32_cnttz(m_slBitmap[fl]);
+				const uint32_t idx = m_freeHead[fl][sl];
+
+				removeFree(idx);
+
+				const Block& block = m_block[idx];
+				const uint64_t ptr = block.m_ptr;
+				m_totalSize -= block.m_size;
+
+				freeNode(idx);
+
+				return ptr;
 			}
 
 			return 0;
@@ -2888,86 +3286,307 @@ namespace bgfx
 		{
 			_size = bx::max(_size, 16u);
 
-			for (FreeList::iterator it = m_free.begin(), itEnd = m_free.end(); it != itEnd; ++it)
+			uint32_t fl, sl;
+			mappingSearch(_size, fl, sl);
+
+			const uint32_t idx = findFree(fl, sl);
+			if (kInvalidNode == idx)
 			{
-				if (it->m_size >= _size)
-				{
-					uint64_t ptr = it->m_ptr;
+				// there is no block large enough.
+				return kInvalidBlock;
+			}
 
-					m_used.insert(stl::make_pair(ptr, _size) );
+			removeFree(idx);
 
-					if (it->m_size != _size)
-					{
-						it->m_size -= _size;
-						it->m_ptr  += _size;
-					}
-					else
-					{
-						m_free.erase(it);
-					}
+			const uint32_t remainder = m_block[idx].m_size - _size;
+			if (0 != remainder)
+			{
+				const uint32_t split = allocNode();
 
-					return ptr;
+				Block& block = m_block[idx];
+				Block& rest  = m_block[split];
+				rest.m_ptr      = block.m_ptr + _size;
+				rest.m_size     = remainder;
+				rest.m_prevPhys = idx;
+				rest.m_nextPhys = block.m_nextPhys;
+
+				if (kInvalidNode != block.m_nextPhys)
+				{
+					m_block[block.m_nextPhys].m_prevPhys = split;
 				}
+
+				block.m_nextPhys = split;
+				block.m_size     = _size;
+
+				insertFree(split);
 			}
 
-			// there is no block large enough.
-			return kInvalidBlock;
+			const uint64_t ptr = m_block[idx].m_ptr;
+			m_used.insert(stl::make_pair(ptr, idx) );
+
+			m_usedSize += _size;
+			m_peakSize  = bx::max(m_peakSize, m_usedSize);
+
+			return ptr;
 		}
 
 		void free(uint64_t _block)
 		{
 			UsedList::iterator it = m_used.find(_block);
-			if (it != m_used.end() )
+			if (it == m_used.end() )
+			{
+				return;
+			}
+
+			uint32_t idx = it->second;
+			m_used.erase(it);
+
+			m_usedSize -= m_block[idx].m_size;
+
+			const uint32_t next = m_block[idx].m_nextPhys;
+			if (kInvalidNode != next
+			&&  m_block[next].m_free)
+			{
+				removeFree(next);
+				merge(idx, next);
+			}
+
+			const uint32_t prev = m_block[idx].m_prevPhys;
+			if (kInvalidNode != prev
+			&&  m_block[prev].m_free)
 			{
-				m_free.push_front(Free(it->first, it->second) );
-				m_used.erase(it);
+				removeFree(prev);
+				merge(prev, idx);
+				idx = prev;
 			}
+
+			insertFree(idx);
 		}
 
+		/// Free blocks are already coalesced on free. Returns true if there are
+		/// no used blocks, and all added ranges can be removed.
 		bool compact()
 		{
-			m_free.sort();
+			return 0 == m_used.size();
+		}
+
+		/// Returns number of bytes in used blocks.
+		uint64_t getUsed() const
+		{
+			return m_usedSize;
+		}
+
+		/// Returns peak number of bytes in used blocks.
+		uint64_t getPeak() const
+		{
+			return m_peakSize;
+		}
+
+		/// Returns free space fragmentation in 0-1 range. 0 means that all free
+		/// space is in single block.
+		float getFragmentation() const
+		{
+			const uint64_t freeSize = m_totalSize - m_usedSize;
+			if (0 == freeSize
+			||  0 == m_flBitmap)
+			{
+				return 0.0f;
+			}
+
+			// Largest free block is in highest non-empty list.
+			const uint32_t fl = 31 - bx::uint32_cntlz(m_flBitmap);
+			const uint32_t sl = 31 - bx::uint32_cntlz(m_slBitmap[fl]);
+
+			uint32_t largest = 0;
+			for (uint32_t idx = m_freeHead[fl][sl]; kInvalidNode != idx; idx = m_block[idx].m_nextFree)
+			{
+				largest = bx::max(largest, m_block[idx].m_size);
+			}
+
+			return 1.0f - float(largest)/float(freeSize);
+		}
+
+	private:
+		static const uint32_t kInvalidNode = UINT32_MAX;
+		static const uint32_t kSlNumBits   = 4;
+		static const uint32_t kSlCount     = 1<<kSlNumBits;
+		static const uint32_t kFlCount     = 32-kSlNumBits+1;
+
+		struct Block
+		{
+			uint64_t m_ptr;
+			uint32_t m_size;
+			uint32_t m_prevPhys;
+			uint32_t m_nextPhys;
+			uint32_t m_prevFree;
+			uint32_t m_nextFree;
+			bool     m_free;
+		};
+
+		static void mapping(uint32_t _size, uint32_t& _fl, uint32_t& _sl)
+		{
+			if (_size < kSlCount)
+			{
+				_fl = 0;
+				_sl = _size;
+			}
+			else
+			{
+				const uint32_t msb = 31 - bx::uint32_cntlz(_size);
+				_fl = msb - kSlNumBits + 1;
+				_sl = (_size >> (msb - kSlNumBits) ) - kSlCount;
+			}
+		}
+
+		static void mappingSearch(uint32_t _size, uint32_t& _fl, uint32_t& _sl)
+		{
+			// Round up to next size class, so that any block in found list fits.
+			if (_size >= kSlCount)
+			{
+				const uint32_t msb   = 31 - bx::uint32_cntlz(_size);
+				const uint32_t round = (1 << (msb - kSlNumBits) ) - 1;
+				_size = uint32_t(bx::min<uint64_t>(uint64_t(_size) + round, UINT32_MAX) );
+			}
 
-			for (FreeList::iterator it = m_free.begin(), next = it, itEnd = m_free.end(); next != itEnd;)
+			mapping(_size, _fl, _sl);
+		}
+
+		uint32_t findFree(uint32_t _fl, uint32_t _sl) const
+		{
+			uint32_t slBitmap = m_slBitmap[_fl] & (UINT32_MAX << _sl);
+
+			if (0 == slBitmap)
 			{
-				if ( (it->m_ptr + it->m_size) == next->m_ptr)
+				const uint32_t flBitmap = _fl+1 < kFlCount
+					? m_flBitmap & (UINT32_MAX << (_fl+1) )
+					: 0
+					;
+				if (0 == flBitmap)
 				{
-					it->m_size += next->m_size;
-					next = m_free.erase(next);
+					return kInvalidNode;
 				}
-				else
+
+				_fl = bx::uint32_cnttz(flBitmap);
+				slBitmap = m_slBitmap[_fl];
+			}
+
+			_sl = bx::uint32_cnttz(slBitmap);
+
+			return m_freeHead[_fl][_sl];
+		}
+
+		void insertFree(uint32_t _idx)
+		{
+			Block& block = m_block[_idx];
+
+			uint32_t fl, sl;
+			mapping(block.m_size, fl, sl);
+
+			const uint32_t head = m_freeHead[fl][sl];
+			block.m_free     = true;
+			block.m_prevFree = kInvalidNode;
+			block.m_nextFree = head;
+
+			if (kInvalidNode != head)
+			{
+				m_block[head].m_prevFree = _idx;
+			}
+
+			m_freeHead[fl][sl] = _idx;
+			m_flBitmap    |= 1 << fl;
+			m_slBitmap[fl] |= 1 << sl;
+		}
+
+		void removeFree(uint32_t _idx)
+		{
+			Block& block = m_block[_idx];
+
+			uint32_t fl, sl;
+			mapping(block.m_size, fl, sl);
+
+			if (kInvalidNode != block.m_prevFree)
+			{
+				m_block[block.m_prevFree].m_nextFree = block.m_nextFree;
+			}
+			else
+			{
+				m_freeHead[fl][sl] = block.m_nextFree;
+
+				if (kInvalidNode == block.m_nextFree)
 				{
-					it = next;
-					++next;
+					m_slBitmap[fl] &= ~(1 << sl);
+
+					if (0 == m_slBitmap[fl])
+					{
+						m_flBitmap &= ~(1 << fl);
+					}
 				}
 			}
 
-			return 0 == m_used.size();
+			if (kInvalidNode != block.m_nextFree)
+			{
+				m_block[block.m_nextFree].m_prevFree = block.m_prevFree;
+			}
+
+			block.m_free = false;
 		}
 
-	private:
-		struct Free
+		/// Merge physically adjacent _next block into _idx block.
+		void merge(uint32_t _idx, uint32_t _next)
 		{
-			Free(uint64_t _ptr, uint32_t _size)
-				: m_ptr(_ptr)
-				, m_size(_size)
+			Block& block = m_block[_idx];
+			const Block& next = m_block[_next];
+
+			block.m_size    += next.m_size;
+			block.m_nextPhys = next.m_nextPhys;
+
+			if (kInvalidNode != next.m_nextPhys)
 			{
+				m_block[next.m_nextPhys].m_prevPhys = _idx;
 			}
 
-			bool operator<(const Free& rhs) const
+			freeNode(_next);
+		}
+
+		uint32_t allocNode()
+		{
+			uint32_t idx = m_freeNode;
+
+			if (kInvalidNode != idx)
+			{
+				m_freeNode = m_block[idx].m_nextFree;
+			}
+			else
 			{
-				return m_ptr < rhs.m_ptr;
+				idx = uint32_t(m_block.size() );
+				m_block.push_back(Block() );
 			}
 
-			uint64_t m_ptr;
-			uint32_t m_size;
-		};
+			m_block[idx].m_free = false;
+
+			return idx;
+		}
+
+		void freeNode(uint32_t _idx)
+		{
+			m_block[_idx].m_nextFree = m_freeNode;
+			m_freeNode = _idx;
+		}
 
-		typedef stl::list<Free> FreeList;
-		FreeList m_free;
+		typedef stl::vector<Block> BlockArray;
+		BlockArray m_block;
+		uint32_t   m_freeNode;
 
 		typedef stl::unordered_map<uint64_t, uint32_t> UsedList;
 		UsedList m_used;
+
+		uint32_t m_flBitmap;
+		uint32_t m_slBitmap[kFlCount];
+		uint32_t m_freeHead[kFlCount][kSlCount];
+
+		uint64_t m_totalSize;
+		uint64_t m_usedSize;
+		uint64_t m_peakSize;
 	};
 
 	struct BX_NO_VTABLE RendererContextI
@@ -3024,6 +3643,8 @@ namespace bgfx
 
 	void rendererUpdateUniforms(RendererContextI* _renderCtx, UniformBuffer* _uniformBuffer, uint32_t _begin, uint32_t _end);
 
+	void rendererUpdateUniformGroup(RendererContextI* _renderCtx, uint16_t _group);
+
 #if BGFX_CONFIG_DEBUG
 #	define BGFX_API_FUNC(_func) BX_NO_INLINE _func
 #else
@@ -3035,11 +3656,17 @@ namespace bgfx
 		static constexpr uint32_t kAlignment = 64;
 
 		Context()
-			: m_render(&m_frame[0])
-			, m_submit(&m_frame[BGFX_CONFIG_MULTITHREADED ? 1 : 0])
+			: m_frame(NULL)
+			, m_render(NULL)
+			, m_submit(NULL)
+			, m_numFrames(0)
+			, m_renderIdx(0)
+			, m_submitIdx(0)
+			, m_waitSubmit(0)
 			, m_numFreeDynamicIndexBufferHandles(0)
 			, m_numFreeDynamicVertexBufferHandles(0)
 			, m_numFreeOcclusionQueryHandles(0)
+			, m_numDirtyUniformGroups(0)
 			, m_colorPaletteDirty(0)
 			, m_frames(0)
 			, m_debug(BGFX_DEBUG_NONE)
@@ -3191,6 +3818,13 @@ namespace bgfx
 			stats.textureMemoryUsed = m_textureMemoryUsed;
 			stats.rtMemoryUsed      = m_rtMemoryUsed;
 
+			stats.dynamicVbUsed          = int64_t(m_dynVertexBufferAllocator.getUsed() );
+			stats.dynamicVbPeak          = int64_t(m_dynVertexBufferAllocator.getPeak() );
+			stats.dynamicVbFragmentation = m_dynVertexBufferAllocator.getFragmentation();
+			stats.dynamicIbUsed          = int64_t(m_dynIndexBufferAllocator.getUsed() );
+			stats.dynamicIbPeak          = int64_t(m_dynIndexBufferAllocator.getPeak() );
+			stats.dynamicIbFragmentation = m_dynIndexBufferAllocator.getFragmentation();
+
 			return &stats;
 		}
 
@@ -3367,7 +4001,7 @@ namespace bgfx
 			{
 				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyVertexLayout);
 				cmdbuf.write(layoutHandle);
-				m_render->free(layoutHandle);
+				getNextSubmitFrame()->free(layoutHandle);
 			}
 
 			m_vertexBufferHandle.free(_handle.idx);
@@ -3735,7 +4369,7 @@ namespace bgfx
 			{
 				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyVertexLayout);
 				cmdbuf.write(layoutHandle);
-				m_render->free(layoutHandle);
+				getNextSubmitFrame()->free(layoutHandle);
 			}
 
 			DynamicVertexBuffer& dvb = m_dynamicVertexBuffers[_handle.idx];
@@ -3882,14 +4516,10 @@ namespace bgfx
 			BX_ALIGNED_FREE(g_allocator, _tvb, 16);
 		}
 
-		BGFX_API_FUNC(void allocTransientVertexBuffer(TransientVertexBuffer* _tvb, uint32_t _num, const VertexLayout& _layout) )
+		VertexLayoutHandle findTransientVertexLayout(const VertexLayout& _layout)
 		{
-			BGFX_MUTEX_SCOPE(m_resourceApiLock);
-
 			VertexLayoutHandle layoutHandle = m_vertexLayoutRef.find(_layout.m_hash);
 
-			TransientVertexBuffer& dvb = *m_submit->m_transientVb;
-
 			if (!isValid(layoutHandle) )
 			{
 				VertexLayoutHandle temp = { m_layoutHandle.alloc() };
@@ -3900,6 +4530,17 @@ namespace bgfx
 				m_vertexLayoutRef.add(layoutHandle, _layout.m_hash);
 			}
 
+			return layoutHandle;
+		}
+
+		BGFX_API_FUNC(void allocTransientVertexBuffer(TransientVertexBuffer* _tvb, uint32_t _num, const VertexLayout& _layout) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			VertexLayoutHandle layoutHandle = findTransientVertexLayout(_layout);
+
+			TransientVertexBuffer& dvb = *m_submit->m_transientVb;
+
 			uint32_t offset = m_submit->allocTransientVertexBuffer(_num, _layout.m_stride);
 
 			_tvb->data = &dvb.data[offset];
@@ -4093,10 +4734,13 @@ namespace bgfx
 					bx::read(&reader, texFormat);
 				}
 
-				PredefinedUniform::Enum predefined = nameToPredefinedUniformEnum(name);
+				uint32_t nameHash;
+				PredefinedUniform::Enum predefined;
+				readUniformReflection(&reader, magic, name, nameHash, predefined, &err);
+
 				if (PredefinedUniform::Count == predefined && UniformType::End != UniformType::Enum(type) )
 				{
-					uniforms[sr.m_num] = createUniform(name, UniformType::Enum(type), regCount, UniformSet::Submit);
+					uniforms[sr.m_num] = createUniform(name, nameHash, UniformType::Enum(type), regCount, UniformSet::Submit);
 					sr.m_num++;
 				}
 			}
@@ -4270,6 +4914,7 @@ namespace bgfx
 					pr.m_gsh = _gsh;
 					pr.m_fsh = _fsh;
 					pr.m_refCount = 1;
+					++pr.m_gen;
 
 					const uint32_t key = uint32_t(_fsh.idx<<16)|_vsh.idx;
 					bool ok = m_programHashMap.insert(key, handle.idx);
@@ -4335,6 +4980,7 @@ namespace bgfx
 					pr.m_gsh = gsh;
 					pr.m_fsh = _fsh;
 					pr.m_refCount = 1;
+					++pr.m_gen;
 
 					const uint32_t key = uint32_t(_fsh.idx<<16)|_vsh.idx;
 					bool ok = m_programHashMap.insert(key, handle.idx);
@@ -4390,6 +5036,7 @@ namespace bgfx
 					ShaderHandle fsh = BGFX_INVALID_HANDLE;
 					pr.m_fsh = fsh;
 					pr.m_refCount = 1;
+					++pr.m_gen;
 
 					const uint32_t key = uint32_t(_vsh.idx);
 					bool ok = m_programHashMap.insert(key, handle.idx);
@@ -4438,6 +5085,20 @@ namespace bgfx
 			}
 		}
 
+		BGFX_API_FUNC(bool isProgramReady(ProgramHandle _handle) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			BGFX_CHECK_HANDLE("isProgramReady", m_programHandle, _handle);
+
+			// Readiness is reported by render thread for the generation it executed, so
+			// stale state left by previous program with the same handle is never used.
+			const ProgramRef& pr = m_programRef[_handle.idx];
+			return pr.m_gen == m_submit->m_programGen[_handle.idx]
+				&& m_submit->m_programReady[_handle.idx]
+				;
+		}
+
 		BGFX_API_FUNC(TextureHandle createTexture(const Memory* _mem, uint64_t _flags, uint8_t _skip, TextureInfo* _info, BackbufferRatio::Enum _ratio, bool _immutable) )
 		{
 			BGFX_MUTEX_SCOPE(m_resourceApiLock);
@@ -4578,7 +5239,7 @@ namespace bgfx
 			cmdbuf.write(_handle);
 			cmdbuf.write(_data);
 			cmdbuf.write(_mip);
-			return m_frames + 2;
+			return m_frames + bx::max<uint32_t>(m_numFrames, 2);
 		}
 
 		void resizeTexture(TextureHandle _handle, uint16_t _width, uint16_t _height, uint8_t _numMips, uint16_t _numLayers)
@@ -4835,9 +5496,16 @@ namespace bgfx
 				return BGFX_INVALID_HANDLE;
 			}
 
+			return createUniform(_name, bx::hash<bx::HashMurmur2A>(_name), _type, _num, _freq);
+		}
+
+		BGFX_API_FUNC(UniformHandle createUniform(const char* _name, uint32_t _nameHash, UniformType::Enum _type, uint16_t _num, UniformSet::Enum _freq) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
 			_num  = bx::max<uint16_t>(1, _num);
 
-			uint16_t idx = m_uniformHashMap.find(bx::hash<bx::HashMurmur2A>(_name) );
+			uint16_t idx = m_uniformHashMap.find(_nameHash);
 			if (kInvalidHandle != idx)
 			{
 				UniformHandle handle = { idx };
@@ -4888,7 +5556,7 @@ namespace bgfx
 			uniform.m_num  = _num;
 			uniform.m_freq = _freq;
 
-			bool ok = m_uniformHashMap.insert(bx::hash<bx::HashMurmur2A>(_name), handle.idx);
+			bool ok = m_uniformHashMap.insert(_nameHash, handle.idx);
 			BX_ASSERT(ok, "Uniform already exists (name: %s)!", _name); BX_UNUSED(ok);
 
 			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::CreateUniform);
@@ -4938,6 +5606,105 @@ namespace bgfx
 			}
 		}
 
+		BGFX_API_FUNC(UniformGroupHandle createUniformGroup() )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			UniformGroupHandle handle = { m_uniformGroupHandle.alloc() };
+
+			if (!isValid(handle) )
+			{
+				BX_TRACE("Failed to allocate uniform group handle.");
+				return BGFX_INVALID_HANDLE;
+			}
+
+			UniformGroupRef& group = m_uniformGroupRef[handle.idx];
+			group.m_uniformBuffer = UniformBuffer::create(1<<10);
+			group.m_uniformBuffer->finish();
+			group.m_dirty         = false;
+
+			return handle;
+		}
+
+		BGFX_API_FUNC(void updateUniformGroup(UniformGroupHandle _handle, UniformType::Enum _type, UniformHandle _uniform, const void* _value, uint16_t _num) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			BGFX_CHECK_HANDLE("updateUniformGroup", m_uniformGroupHandle, _handle);
+
+			UniformGroupRef& group = m_uniformGroupRef[_handle.idx];
+			UniformBuffer::replaceUniform(&group.m_uniformBuffer, _type, _uniform.idx, _value, _num);
+
+			if (!group.m_dirty)
+			{
+				group.m_dirty = true;
+				m_dirtyUniformGroup[m_numDirtyUniformGroups++] = _handle;
+			}
+		}
+
+		BGFX_API_FUNC(void destroyUniformGroup(UniformGroupHandle _handle) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			BGFX_CHECK_HANDLE("destroyUniformGroup", m_uniformGroupHandle, _handle);
+
+			bool ok = m_submit->free(_handle); BX_UNUSED(ok);
+			BX_ASSERT(ok, "Uniform group handle %d is already destroyed!", _handle.idx);
+
+			UniformGroupRef& group = m_uniformGroupRef[_handle.idx];
+			UniformBuffer::destroy(group.m_uniformBuffer);
+			group.m_uniformBuffer = NULL;
+
+			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyUniformGroup);
+			cmdbuf.write(_handle);
+		}
+
+		void updateDirtyUniformGroups()
+		{
+			for (uint16_t ii = 0, num = m_numDirtyUniformGroups; ii < num; ++ii)
+			{
+				UniformGroupHandle handle = m_dirtyUniformGroup[ii];
+				UniformGroupRef& group = m_uniformGroupRef[handle.idx];
+
+				// Group could be destroyed after it was updated.
+				if (NULL != group.m_uniformBuffer
+				&&  group.m_dirty)
+				{
+					UniformBuffer* uniformBuffer = group.m_uniformBuffer;
+					uniformBuffer->reset();
+
+					for (;;)
+					{
+						const uint32_t opcode = uniformBuffer->read();
+						if (UniformType::End == opcode)
+						{
+							break;
+						}
+
+						UniformType::Enum type;
+						uint16_t loc;
+						uint16_t num;
+						uint16_t copy;
+						UniformBuffer::decodeOpcode(opcode, type, loc, num, copy);
+						uniformBuffer->read(g_uniformTypeSize[type]*num);
+					}
+
+					const uint32_t size = uniformBuffer->getPos();
+					uniformBuffer->reset();
+
+					CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::UpdateUniformGroup);
+					cmdbuf.write(handle);
+					cmdbuf.write(size);
+					cmdbuf.write(uniformBuffer->read(size), size);
+					uniformBuffer->reset();
+				}
+
+				group.m_dirty = false;
+			}
+
+			m_numDirtyUniformGroups = 0;
+		}
+
 		BGFX_API_FUNC(OcclusionQueryHandle createOcclusionQuery() )
 		{
 			BGFX_MUTEX_SCOPE(m_resourceApiLock);
@@ -5148,6 +5915,7 @@ namespace bgfx
 		void dumpViewStats();
 		void freeDynamicBuffers();
 		void freeAllHandles(Frame* _frame);
+		void destroyFrames();
 		void frameNoRenderWait();
 		void swap();
 
@@ -5178,8 +5946,7 @@ namespace bgfx
 			bool ok = m_apiSem.wait(_msecs);
 			if (ok)
 			{
-				m_render->m_waitSubmit = bx::getHPCounter()-start;
-				m_submit->m_perfStats.waitSubmit = m_submit->m_waitSubmit;
+				m_waitSubmit = bx::getHPCounter()-start;
 				return true;
 			}
 
@@ -5194,6 +5961,14 @@ namespace bgfx
 			}
 		}
 
+		void renderSemPost(uint32_t _count)
+		{
+			if (!m_singleThreaded)
+			{
+				m_renderSem.post(_count);
+			}
+		}
+
 		void renderSemWait()
 		{
 			if (!m_singleThreaded)
@@ -5209,25 +5984,31 @@ namespace bgfx
 
 		void encoderApiWait()
 		{
-			uint16_t numEncoders = m_encoderHandle->getNumHandles();
+			// Close encoder allocation until encoderApiRelease. Must be called with
+			// m_encoderApiLock held, begin() waits on it while allocation is closed.
+			const uint32_t numEncoders = bx::atomicFetchAndAdd<uint32_t>(&m_encoderAlloc, kEncoderAllocLocked);
+			BX_ASSERT(0 == (numEncoders & kEncoderAllocLocked), "Encoder allocation is already closed.");
 
-			for (uint16_t ii = 1; ii < numEncoders; ++ii)
+			for (uint32_t ii = 1; ii < numEncoders; ++ii)
 			{
 				m_encoderEndSem.wait();
 			}
 
-			for (uint16_t ii = 0; ii < numEncoders; ++ii)
+			for (uint32_t ii = 0; ii < numEncoders; ++ii)
 			{
-				uint16_t idx = m_encoderHandle->getHandleAt(ii);
-				m_encoderStats[ii].cpuTimeBegin = m_encoder[idx].m_cpuTimeBegin;
-				m_encoderStats[ii].cpuTimeEnd   = m_encoder[idx].m_cpuTimeEnd;
+				m_encoderStats[ii].cpuTimeBegin = m_encoder[ii].m_cpuTimeBegin;
+				m_encoderStats[ii].cpuTimeEnd   = m_encoder[ii].m_cpuTimeEnd;
 			}
 
 			m_submit->m_perfStats.numEncoders = uint8_t(numEncoders);
+		}
 
-			m_encoderHandle->reset();
-			uint16_t idx = m_encoderHandle->alloc();
-			BX_ASSERT(0 == idx, "Internal encoder handle is not 0 (idx %d).", idx); BX_UNUSED(idx);
+		void encoderApiRelease()
+		{
+			// Encoder 0 is always owned by API thread.
+			const uint32_t numEncoders = m_encoderAlloc;
+			const uint32_t prev = bx::atomicCompareAndSwap<uint32_t>(&m_encoderAlloc, numEncoders, 1);
+			BX_ASSERT(prev == numEncoders && 0 != (prev & kEncoderAllocLocked), "Encoder allocation is not closed."); BX_UNUSED(prev);
 		}
 
 		bx::Semaphore m_renderSem;
@@ -5251,6 +6032,11 @@ namespace bgfx
 		{
 		}
 
+		void renderSemPost(uint32_t _count)
+		{
+			BX_UNUSED(_count);
+		}
+
 		void renderSemWait()
 		{
 		}
@@ -5261,20 +6047,50 @@ namespace bgfx
 			m_encoderStats[0].cpuTimeEnd   = m_encoder[0].m_cpuTimeEnd;
 			m_submit->m_perfStats.numEncoders = 1;
 		}
+
+		void encoderApiRelease()
+		{
+		}
 #endif // BGFX_CONFIG_MULTITHREADED
 
 		EncoderStats* m_encoderStats;
 		Encoder*      m_encoder0;
 		EncoderImpl*  m_encoder;
 		uint32_t      m_numEncoders;
-		bx::HandleAlloc* m_encoderHandle;
 
-		Frame  m_frame[1+(BGFX_CONFIG_MULTITHREADED ? 1 : 0)];
-		Frame* m_render;
-		Frame* m_submit;
+		// Number of encoders handed out in current frame. Top bit is set while
+		// API thread is finishing frame.
+		static constexpr uint32_t kEncoderAllocLocked = UINT32_C(0x80000000);
+		uint32_t      m_encoderAlloc;
+
+		uint8_t getNextFrameIdx(uint8_t _idx) const
+		{
+			return uint8_t( (_idx+1) % m_numFrames);
+		}
+
+		Frame* getNextSubmitFrame()
+		{
+			return &m_frame[getNextFrameIdx(m_submitIdx)];
+		}
+
+		// Frames form a ring. API thread records into m_submit while render
+		// thread consumes frames in order, up to m_numFrames-1 behind.
+		Frame*  m_frame;
+		Frame*  m_render;
+		Frame*  m_submit;
+		uint8_t m_numFrames;
+		uint8_t m_renderIdx;
+		uint8_t m_submitIdx;
+
+		int64_t m_waitSubmit;
+		int32_t m_occlusion[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
+
+		uint16_t m_programGen[BGFX_CONFIG_MAX_PROGRAMS];
+		bool     m_programReady[BGFX_CONFIG_MAX_PROGRAMS];
 
 		uint64_t m_tempKeys[BGFX_CONFIG_MAX_DRAW_CALLS];
 		RenderItemCount m_tempValues[BGFX_CONFIG_MAX_DRAW_CALLS];
+		JobPool m_sortJobPool;
 
 		IndexBuffer  m_indexBuffers[BGFX_CONFIG_MAX_INDEX_BUFFERS];
 		VertexBuffer m_vertexBuffers[BGFX_CONFIG_MAX_VERTEX_BUFFERS];
@@ -5303,12 +6119,20 @@ namespace bgfx
 		bx::HandleAllocT<BGFX_CONFIG_MAX_TEXTURES> m_textureHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_FRAME_BUFFERS> m_frameBufferHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_UNIFORMS> m_uniformHandle;
+		bx::HandleAllocT<BGFX_CONFIG_MAX_UNIFORM_GROUPS> m_uniformGroupHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_OCCLUSION_QUERIES> m_occlusionQueryHandle;
 
 		typedef bx::HandleHashMapT<BGFX_CONFIG_MAX_UNIFORMS*2> UniformHashMap;
 		UniformHashMap m_uniformHashMap;
 		UniformRef     m_uniformRef[BGFX_CONFIG_MAX_UNIFORMS];
 
+		UniformGroupRef    m_uniformGroupRef[BGFX_CONFIG_MAX_UNIFORM_GROUPS];
+		UniformGroupHandle m_dirtyUniformGroup[BGFX_CONFIG_MAX_UNIFORM_GROUPS];
+		uint16_t           m_numDirtyUniformGroups;
+
+		// Render thread copy of uniform group values.
+		UniformBuffer* m_uniformGroup[BGFX_CONFIG_MAX_UNIFORM_GROUPS];
+
 		typedef bx::HandleHashMapT<BGFX_CONFIG_MAX_SHADERS*2> ShaderHashMap;
 		ShaderHashMap m_shaderHashMap;
 		ShaderRef     m_shaderRef[BGFX_CONFIG_MAX_SHADERS];
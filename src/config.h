@@ -174,6 +174,21 @@
 #	define BGFX_CONFIG_RENDERER_USE_EXTENSIONS 1
 #endif // BGFX_CONFIG_RENDERER_USE_EXTENSIONS
 
+/// Noop renderer decodes and replays full frame against stub device, instead
+/// of just discarding it. Used for measuring render thread CPU cost headless.
+#ifndef BGFX_CONFIG_RENDERER_NOOP_REPLAY
+#	define BGFX_CONFIG_RENDERER_NOOP_REPLAY 0
+#endif // BGFX_CONFIG_RENDERER_NOOP_REPLAY
+
+/// OpenGL renderer creates programs asynchronously when `GL_KHR_parallel_shader_compile`
+/// is available. Draws using program that is still compiling are skipped, see
+/// `bgfx::isProgramReady`. Only compile and link are asynchronous, program binary cache
+/// lookup (`CallbackI::cacheReadSize` and `cacheRead`) still runs on render thread when
+/// program is created. Without the extension program creation is fully synchronous.
+#ifndef BGFX_CONFIG_RENDERER_OPENGL_ASYNC_PROGRAM
+#	define BGFX_CONFIG_RENDERER_OPENGL_ASYNC_PROGRAM 0
+#endif // BGFX_CONFIG_RENDERER_OPENGL_ASYNC_PROGRAM
+
 /// Enable use of tinystl.
 #ifndef BGFX_CONFIG_USE_TINYSTL
 #	define BGFX_CONFIG_USE_TINYSTL 1
@@ -236,6 +251,21 @@
 #	define BGFX_CONFIG_SORT_KEY_NUM_BITS_PROGRAM 9
 #endif // BGFX_CONFIG_SORT_KEY_NUM_BITS_PROGRAM
 
+/// Number of sort key bits used for render state hash. When not 0, draw calls
+/// using same program are grouped by render state, in views with default and
+/// depth sort modes. Sort key has 8 spare bits with default bit budgets, more
+/// can be freed by reducing BGFX_CONFIG_SORT_KEY_NUM_BITS_DEPTH.
+#ifndef BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE
+#	define BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE 0
+#endif // BGFX_CONFIG_SORT_KEY_NUM_BITS_STATE
+
+/// Number of sort key bits used for hash of bound textures and samplers. When
+/// not 0, draw calls using same program and render state are grouped by bound
+/// textures.
+#ifndef BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE
+#	define BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE 0
+#endif // BGFX_CONFIG_SORT_KEY_NUM_BITS_TEXTURE
+
 // Cannot be configured via compiler options.
 #define BGFX_CONFIG_MAX_PROGRAMS (1<<BGFX_CONFIG_SORT_KEY_NUM_BITS_PROGRAM)
 BX_STATIC_ASSERT(bx::isPowerOf2(BGFX_CONFIG_MAX_PROGRAMS), "BGFX_CONFIG_MAX_PROGRAMS must be power of 2.");
@@ -307,6 +337,10 @@ BX_STATIC_ASSERT(bx::isPowerOf2(BGFX_CONFIG_MAX_VIEWS), "BGFX_CONFIG_MAX_VIEWS m
 #	define BGFX_CONFIG_MAX_UNIFORMS 512
 #endif // BGFX_CONFIG_MAX_UNIFORMS
 
+#ifndef BGFX_CONFIG_MAX_UNIFORM_GROUPS
+#	define BGFX_CONFIG_MAX_UNIFORM_GROUPS (4<<10)
+#endif // BGFX_CONFIG_MAX_UNIFORM_GROUPS
+
 #ifndef BGFX_CONFIG_MAX_OCCLUSION_QUERIES
 #	define BGFX_CONFIG_MAX_OCCLUSION_QUERIES 256
 #endif // BGFX_CONFIG_MAX_OCCLUSION_QUERIES
@@ -357,6 +391,41 @@ BX_STATIC_ASSERT(bx::isPowerOf2(BGFX_CONFIG_MAX_VIEWS), "BGFX_CONFIG_MAX_VIEWS m
 #	define BGFX_CONFIG_DEFAULT_MAX_ENCODERS ( (0 != BGFX_CONFIG_MULTITHREADED) ? 8 : 1)
 #endif // BGFX_CONFIG_DEFAULT_MAX_ENCODERS
 
+/// Default number of frames in flight between API and render thread. 2 is the
+/// classic submit/render double buffering, higher values let API thread record
+/// ahead while render thread is still busy with older frames.
+#ifndef BGFX_CONFIG_DEFAULT_NUM_FRAMES
+#	define BGFX_CONFIG_DEFAULT_NUM_FRAMES ( (0 != BGFX_CONFIG_MULTITHREADED) ? 2 : 1)
+#endif // BGFX_CONFIG_DEFAULT_NUM_FRAMES
+
+#ifndef BGFX_CONFIG_MAX_FRAMES
+#	define BGFX_CONFIG_MAX_FRAMES 4
+#endif // BGFX_CONFIG_MAX_FRAMES
+
+/// Number of threads, including render thread, used to sort draw calls.
+/// Set to 1 to disable parallel sort.
+#ifndef BGFX_CONFIG_SORT_NUM_THREADS
+#	define BGFX_CONFIG_SORT_NUM_THREADS ( (0 != BGFX_CONFIG_MULTITHREADED) ? 4 : 1)
+#endif // BGFX_CONFIG_SORT_NUM_THREADS
+
+/// Minimum number of draw calls in frame before parallel sort is used.
+#ifndef BGFX_CONFIG_SORT_PARALLEL_MIN_ITEMS
+#	define BGFX_CONFIG_SORT_PARALLEL_MIN_ITEMS (8<<10)
+#endif // BGFX_CONFIG_SORT_PARALLEL_MIN_ITEMS
+
+/// Number of render items encoder reserves from frame at once. Reserving in
+/// chunks keeps encoder threads off shared frame counter on every submit.
+#ifndef BGFX_CONFIG_ENCODER_RENDER_ITEM_CHUNK
+#	define BGFX_CONFIG_ENCODER_RENDER_ITEM_CHUNK 256
+#endif // BGFX_CONFIG_ENCODER_RENDER_ITEM_CHUNK
+
+/// Size of transient vertex/index buffer page encoder reserves from frame at
+/// once. Encoder transient allocations are sub-allocated from page without
+/// locking.
+#ifndef BGFX_CONFIG_ENCODER_TRANSIENT_PAGE_SIZE
+#	define BGFX_CONFIG_ENCODER_TRANSIENT_PAGE_SIZE (64<<10)
+#endif // BGFX_CONFIG_ENCODER_TRANSIENT_PAGE_SIZE
+
 #ifndef BGFX_CONFIG_MAX_BACK_BUFFERS
 #	define BGFX_CONFIG_MAX_BACK_BUFFERS 4
 #endif // BGFX_CONFIG_MAX_BACK_BUFFERS
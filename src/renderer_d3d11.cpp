@@ -4177,7 +4177,10 @@ namespace bgfx { namespace d3d11
 
 				const char* kind = "invalid";
 
-				PredefinedUniform::Enum predefined = nameToPredefinedUniformEnum(name);
+				uint32_t nameHash;
+				PredefinedUniform::Enum predefined;
+				readUniformReflection(&reader, magic, name, nameHash, predefined);
+
 				if (PredefinedUniform::Count != predefined)
 				{
 					kind = "predefined";
@@ -4188,7 +4191,7 @@ namespace bgfx { namespace d3d11
 				}
 				else if (0 == (kUniformSamplerBit & type) )
 				{
-					const UniformRegInfo* info = s_renderD3D11->m_uniformReg.find(name);
+					const UniformRegInfo* info = s_renderD3D11->m_uniformReg.find(nameHash);
 					BX_WARN(NULL != info, "User defined uniform '%s' is not found, it won't be set.", name);
 
 					if (NULL != info)
@@ -6064,6 +6067,11 @@ namespace bgfx { namespace d3d11
 				bool programChanged = false;
 				bool constantsChanged = draw.m_uniformBegin < draw.m_uniformEnd;
 				bool groupChanged = draw.m_uniformGroup[UniformSet::Group] != currentGroup;
+				if (groupChanged)
+				{
+					rendererUpdateUniformGroup(this, draw.m_uniformGroup[UniformSet::Group]);
+				}
+
 				rendererUpdateUniforms(this, _render->m_submitUniforms[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
 				currentGroup = draw.m_uniformGroup[UniformSet::Group];
@@ -4475,7 +4475,10 @@ namespace bgfx { namespace d3d12
 
 				const char* kind = "invalid";
 
-				PredefinedUniform::Enum predefined = nameToPredefinedUniformEnum(name);
+				uint32_t nameHash;
+				PredefinedUniform::Enum predefined;
+				readUniformReflection(&reader, magic, name, nameHash, predefined);
+
 				if (PredefinedUniform::Count != predefined)
 				{
 					kind = "predefined";
@@ -4486,7 +4489,7 @@ namespace bgfx { namespace d3d12
 				}
 				else if (0 == (kUniformSamplerBit & type) )
 				{
-					const UniformRegInfo* info = s_renderD3D12->m_uniformReg.find(name);
+					const UniformRegInfo* info = s_renderD3D12->m_uniformReg.find(nameHash);
 					BX_WARN(NULL != info, "User defined uniform '%s' is not found, it won't be set.", name);
 
 					if (NULL != info)
@@ -6360,6 +6363,11 @@ namespace bgfx { namespace d3d12
 				bool constantsChanged = false;
 				bool submitConstants = draw.m_uniformBegin < draw.m_uniformEnd;
 				bool groupChanged = draw.m_uniformGroup[UniformSet::Group] != currentGroup;
+				if (groupChanged)
+				{
+					rendererUpdateUniformGroup(this, draw.m_uniformGroup[UniformSet::Group]);
+				}
+
 				rendererUpdateUniforms(this, _render->m_submitUniforms[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
 				currentGroup = draw.m_uniformGroup[UniformSet::Group];
@@ -6616,6 +6624,7 @@ namespace bgfx { namespace d3d12
 					const bool programChanged = currentProgram.idx != key.m_program.idx;
 					if (submitConstants
 					||  programChanged
+					||  groupChanged
 					||  BGFX_STATE_ALPHA_REF_MASK & changedFlags)
 					{
 						currentProgram = key.m_program;
@@ -6643,15 +6652,11 @@ namespace bgfx { namespace d3d12
 						if (programChanged)
 						{
 							commitConstants(*this, UniformSet::Frame);
-							constantsChanged = true;
-						}
-
-						if (programChanged)
-						{
 							commitConstants(*this, UniformSet::View);
+							groupChanged     = true;
 							constantsChanged = true;
 						}
-						
+
 						if (groupChanged)
 						{
 							commitConstants(*this, UniformSet::Group);
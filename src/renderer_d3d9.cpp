@@ -2453,7 +2453,10 @@ namespace bgfx { namespace d3d9
 
 				const char* kind = "invalid";
 
-				PredefinedUniform::Enum predefined = nameToPredefinedUniformEnum(name);
+				uint32_t nameHash;
+				PredefinedUniform::Enum predefined;
+				readUniformReflection(&reader, magic, name, nameHash, predefined);
+
 				if (PredefinedUniform::Count != predefined)
 				{
 					kind = "predefined";
@@ -2464,7 +2467,7 @@ namespace bgfx { namespace d3d9
 				}
 				else if (0 == (kUniformSamplerBit & type) )
 				{
-					const UniformRegInfo* info = s_renderD3D9->m_uniformReg.find(name);
+					const UniformRegInfo* info = s_renderD3D9->m_uniformReg.find(nameHash);
 					BX_WARN(NULL != info, "User defined uniform '%s' is not found, it won't be set.", name);
 
 					if (NULL != info)
@@ -3757,6 +3760,7 @@ namespace bgfx { namespace d3d9
 
 		DX_CHECK(device->SetRenderState(D3DRS_FILLMODE, _render->m_debug&BGFX_DEBUG_WIREFRAME ? D3DFILL_WIREFRAME : D3DFILL_SOLID) );
 		ProgramHandle currentProgram = BGFX_INVALID_HANDLE;
+		uint16_t currentGroup = UINT16_MAX;
 		bool usedProgram[BGFX_CONFIG_MAX_PROGRAMS] = {};
 		SortKey key;
 		uint16_t view = UINT16_MAX;
@@ -4137,8 +4141,16 @@ namespace bgfx { namespace d3d9
 
 				bool programChanged = false;
 				bool constantsChanged = draw.m_uniformBegin < draw.m_uniformEnd;
+				bool groupChanged = draw.m_uniformGroup[UniformSet::Group] != currentGroup;
+				if (groupChanged)
+				{
+					rendererUpdateUniformGroup(this, draw.m_uniformGroup[UniformSet::Group]);
+				}
+
 				rendererUpdateUniforms(this, _render->m_submitUniforms[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
+				currentGroup = draw.m_uniformGroup[UniformSet::Group];
+
 				if (key.m_program.idx != currentProgram.idx)
 				{
 					currentProgram = key.m_program;
@@ -4159,6 +4171,7 @@ namespace bgfx { namespace d3d9
 					}
 
 					programChanged =
+						groupChanged =
 						constantsChanged = true;
 				}
 
@@ -4199,6 +4212,11 @@ namespace bgfx { namespace d3d9
 						constantsChanged = true;
 					}
 
+					if (groupChanged)
+					{
+						commitConstants(UniformSet::Group);
+					}
+
 					if (constantsChanged)
 					{
 						commitConstants(UniformSet::Submit);
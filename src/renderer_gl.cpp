@@ -622,6 +622,7 @@ namespace bgfx { namespace gl
 
 			KHR_debug,
 			KHR_no_error,
+			KHR_parallel_shader_compile,
 
 			MOZ_WEBGL_compressed_texture_s3tc,
 			MOZ_WEBGL_depth_texture,
@@ -838,6 +839,7 @@ namespace bgfx { namespace gl
 
 		{ "KHR_debug",                                BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "KHR_no_error",                             false,                             true  },
+		{ "KHR_parallel_shader_compile",              false,                             true  },
 
 		{ "MOZ_WEBGL_compressed_texture_s3tc",        false,                             true  },
 		{ "MOZ_WEBGL_depth_texture",                  false,                             true  },
@@ -2165,12 +2167,14 @@ namespace bgfx { namespace gl
 			, m_occlusionQuerySupport(false)
 			, m_atocSupport(false)
 			, m_conservativeRasterSupport(false)
+			, m_asyncProgram(false)
 			, m_flip(false)
 			, m_hash( (BX_PLATFORM_WINDOWS<<1) | BX_ARCH_64BIT)
 			, m_backBufferFbo(0)
 			, m_msaaBackBufferFbo(0)
 			, m_clearQuadColor(BGFX_INVALID_HANDLE)
 			, m_clearQuadDepth(BGFX_INVALID_HANDLE)
+			, m_numPendingPrograms(0)
 		{
 			bx::memSet(m_msaaBackBufferRbos, 0, sizeof(m_msaaBackBufferRbos) );
 		}
@@ -2861,6 +2865,17 @@ namespace bgfx { namespace gl
 						|| s_extension[Extension::IMG_shader_binary     ].m_supported
 						);
 
+				m_asyncProgram = BX_ENABLED(BGFX_CONFIG_RENDERER_OPENGL_ASYNC_PROGRAM)
+					&& s_extension[Extension::KHR_parallel_shader_compile].m_supported
+					;
+
+				if (m_asyncProgram
+				&&  NULL != glMaxShaderCompilerThreads)
+				{
+					// 0xffffffff lets driver pick number of compiler threads.
+					GL_CHECK(glMaxShaderCompilerThreads(UINT32_MAX) );
+				}
+
 				m_textureSwizzleSupport = false
 					|| s_extension[Extension::ARB_texture_swizzle].m_supported
 					|| s_extension[Extension::EXT_texture_swizzle].m_supported
@@ -3236,13 +3251,55 @@ namespace bgfx { namespace gl
 			ShaderGL dummyFragmentShader;
 			ShaderGL dummyGeometryShader;
 			m_program[_handle.idx].create(m_shaders[_vsh.idx], isValid(_gsh) ? m_shaders[_gsh.idx] : dummyGeometryShader, isValid(_fsh) ? m_shaders[_fsh.idx] : dummyFragmentShader);
+
+			// Program that failed to link synchronously goes through pending list too, so
+			// that it's reported as not ready.
+			if (m_program[_handle.idx].m_pending
+			||  0 == m_program[_handle.idx].m_id)
+			{
+				m_pendingPrograms[m_numPendingPrograms++] = _handle.idx;
+			}
 		}
 
 		void destroyProgram(ProgramHandle _handle) override
 		{
+			if (m_program[_handle.idx].m_pending
+			||  0 == m_program[_handle.idx].m_id)
+			{
+				for (uint32_t ii = 0, num = m_numPendingPrograms; ii < num; ++ii)
+				{
+					if (_handle.idx == m_pendingPrograms[ii])
+					{
+						m_pendingPrograms[ii] = m_pendingPrograms[--m_numPendingPrograms];
+						break;
+					}
+				}
+			}
+
 			m_program[_handle.idx].destroy();
 		}
 
+		void updatePendingPrograms(Frame* _render)
+		{
+			for (uint32_t ii = 0; ii < m_numPendingPrograms;)
+			{
+				const uint16_t idx = m_pendingPrograms[ii];
+				const bool done = m_program[idx].poll();
+
+				// Program that failed to link is done, but it's never ready.
+				_render->m_programReady[idx] = done && 0 != m_program[idx].m_id;
+
+				if (done)
+				{
+					m_pendingPrograms[ii] = m_pendingPrograms[--m_numPendingPrograms];
+				}
+				else
+				{
+					++ii;
+				}
+			}
+		}
+
 		void* createTexture(TextureHandle _handle, const Memory* _mem, uint64_t _flags, uint8_t _skip) override
 		{
 			m_textures[_handle.idx].create(_mem, _flags, _skip);
@@ -3552,6 +3609,7 @@ namespace bgfx { namespace gl
 			GL_CHECK(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE) );
 
 			ProgramGL& program = m_program[_blitter.m_program.idx];
+			program.wait();
 			setProgram(program.m_id);
 			setUniform1i(program.m_sampler[0], 0);
 
@@ -4293,6 +4351,7 @@ namespace bgfx { namespace gl
 				GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, vb.m_id) );
 
 				ProgramGL& program = m_program[_clearQuad.m_program[numMrt-1].idx];
+				program.wait();
 				setProgram(program.m_id);
 				program.bindAttributesBegin();
 				program.bindAttributes(layout, 0);
@@ -4491,6 +4550,7 @@ namespace bgfx { namespace gl
 		bool m_atocSupport;
 		bool m_conservativeRasterSupport;
 		bool m_imageLoadStoreSupport;
+		bool m_asyncProgram;
 		bool m_flip;
 
 		uint64_t m_hash;
@@ -4505,6 +4565,9 @@ namespace bgfx { namespace gl
 		UniformHandle m_clearQuadColor;
 		UniformHandle m_clearQuadDepth;
 
+		uint16_t m_pendingPrograms[BGFX_CONFIG_MAX_PROGRAMS];
+		uint16_t m_numPendingPrograms;
+
 		const char* m_vendor;
 		const char* m_renderer;
 		const char* m_version;
@@ -4718,27 +4781,75 @@ namespace bgfx { namespace gl
 		m_id = glCreateProgram();
 		BX_TRACE("Program create: GL%d: GL%d, GL%d, GL%d", m_id, _vsh.m_id, _gsh.m_id, _fsh.m_id);
 
-		const uint64_t id = (uint64_t(_vsh.m_hash)<<32) | _fsh.m_hash;
-		const bool cached = s_renderGL->programFetchFromCache(m_id, id);
+		m_hash    = (uint64_t(_vsh.m_hash)<<32) | _fsh.m_hash;
+		m_vsh     = _vsh.m_id;
+		m_fsh     = _fsh.m_id;
+		m_cached  = s_renderGL->programFetchFromCache(m_id, m_hash);
+		m_pending = false;
 
-		if (!cached)
+		if (!m_cached
+		&&  0 != _vsh.m_id)
 		{
-			GLint linked = 0;
-			if (0 != _vsh.m_id)
+			GL_CHECK(glAttachShader(m_id, _vsh.m_id) );
+
+			if (0 != _gsh.m_id)
 			{
-				GL_CHECK(glAttachShader(m_id, _vsh.m_id) );
-				
-				if (0 != _gsh.m_id)
-				{
-					GL_CHECK(glAttachShader(m_id, _gsh.m_id) );
-				}
+				GL_CHECK(glAttachShader(m_id, _gsh.m_id) );
+			}
 
-				if (0 != _fsh.m_id)
-				{
-					GL_CHECK(glAttachShader(m_id, _fsh.m_id) );
-				}
+			if (0 != _fsh.m_id)
+			{
+				GL_CHECK(glAttachShader(m_id, _fsh.m_id) );
+			}
 
-				GL_CHECK(glLinkProgram(m_id) );
+			GL_CHECK(glLinkProgram(m_id) );
+
+			// Link status is checked once driver reports completion, querying it
+			// here would block until compile and link are done.
+			m_pending = s_renderGL->m_asyncProgram;
+		}
+
+		if (!m_pending)
+		{
+			link();
+		}
+	}
+
+	bool ProgramGL::poll()
+	{
+		if (m_pending)
+		{
+			GLint completed = 0;
+			GL_CHECK(glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &completed) );
+
+			if (0 == completed)
+			{
+				return false;
+			}
+
+			m_pending = false;
+			link();
+		}
+
+		return true;
+	}
+
+	void ProgramGL::wait()
+	{
+		if (m_pending)
+		{
+			m_pending = false;
+			link();
+		}
+	}
+
+	void ProgramGL::link()
+	{
+		if (!m_cached)
+		{
+			GLint linked = 0;
+			if (0 != m_vsh)
+			{
 				GL_CHECK(glGetProgramiv(m_id, GL_LINK_STATUS, &linked) );
 
 				if (0 == linked)
@@ -4752,28 +4863,28 @@ namespace bgfx { namespace gl
 			BX_ASSERT(0 != linked, "Invalid vertex/compute shader.");
 			if (0 == linked)
 			{
-				BX_WARN(0 != _vsh.m_id, "Invalid vertex/compute shader.");
+				BX_WARN(0 != m_vsh, "Invalid vertex/compute shader.");
 				GL_CHECK(glDeleteProgram(m_id) );
 				m_usedCount = 0;
 				m_id = 0;
 				return;
 			}
 
-			s_renderGL->programCache(m_id, id);
+			s_renderGL->programCache(m_id, m_hash);
 		}
 
 		init();
 
-		if (!cached
+		if (!m_cached
 		&&  s_renderGL->m_workaround.m_detachShader)
 		{
 			// Must be after init, otherwise init might fail to lookup shader
 			// info (NVIDIA Tegra 3 OpenGL ES 2.0 14.01003).
-			GL_CHECK(glDetachShader(m_id, _vsh.m_id) );
+			GL_CHECK(glDetachShader(m_id, m_vsh) );
 
-			if (0 != _fsh.m_id)
+			if (0 != m_fsh)
 			{
-				GL_CHECK(glDetachShader(m_id, _fsh.m_id) );
+				GL_CHECK(glDetachShader(m_id, m_fsh) );
 			}
 		}
 	}
@@ -4790,6 +4901,7 @@ namespace bgfx { namespace gl
 		}
 
 		m_numPredefined = 0;
+		m_pending = false;
 
 		if (0 != m_id)
 		{
@@ -5967,6 +6079,15 @@ namespace bgfx { namespace gl
 				uint16_t texFormat = 0;
 				bx::read(&reader, texFormat);
 			}
+
+			if (!isShaderVerLess(magic, 12) )
+			{
+				uint32_t nameHash = 0;
+				bx::read(&reader, nameHash);
+
+				uint8_t predefined = 0;
+				bx::read(&reader, predefined);
+			}
 		}
 
 		uint32_t shaderSize;
@@ -6539,8 +6660,12 @@ namespace bgfx { namespace gl
 			GL_CHECK(glShaderSource(m_id, 1, (const GLchar**)&code, NULL) );
 			GL_CHECK(glCompileShader(m_id) );
 
-			GLint compiled = 0;
-			GL_CHECK(glGetShaderiv(m_id, GL_COMPILE_STATUS, &compiled) );
+			// Compile errors surface as link errors when programs are created asynchronously.
+			GLint compiled = 1;
+			if (!s_renderGL->m_asyncProgram)
+			{
+				GL_CHECK(glGetShaderiv(m_id, GL_COMPILE_STATUS, &compiled) );
+			}
 
 			if (0 == compiled)
 			{
@@ -7219,6 +7344,8 @@ namespace bgfx { namespace gl
 			m_occlusionQuery.resolve(_render);
 		}
 
+		updatePendingPrograms(_render);
+
 		rendererUpdateUniforms(this, _render->m_frameUniforms, 0, UINT32_MAX);
 		_render->m_frameUniforms->reset();
 
@@ -7333,7 +7460,8 @@ namespace bgfx { namespace gl
 						BGFX_GL_PROFILER_BEGIN(view, kColorCompute);
 					}
 
-					if (computeSupported)
+					if (computeSupported
+					&&  !m_program[key.m_program.idx].m_pending)
 					{
 						const RenderCompute& compute = renderItem.compute;
 
@@ -7463,7 +7591,13 @@ namespace bgfx { namespace gl
 						&& !isVisible(_render, draw.m_occlusionQuery, 0 != (draw.m_submitFlags&BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE) )
 						;
 
+					const bool pending = true
+						&& isValid(key.m_program)
+						&& m_program[key.m_program.idx].m_pending
+						;
+
 					if (occluded
+					||  pending
 					||  _render->m_frameCache.isZeroArea(viewScissorRect, draw.m_scissor) )
 					{
 						if (resetState)
@@ -7828,6 +7962,11 @@ namespace bgfx { namespace gl
 				bool constantsChanged = draw.m_uniformBegin < draw.m_uniformEnd;
 				bool groupChanged = draw.m_uniformGroup[UniformSet::Group] != currentGroup;
 				bool bindAttribs = false;
+				if (groupChanged)
+				{
+					rendererUpdateUniformGroup(this, draw.m_uniformGroup[UniformSet::Group]);
+				}
+
 				rendererUpdateUniforms(this, _render->m_submitUniforms[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
 				currentGroup = draw.m_uniformGroup[UniformSet::Group];
@@ -7842,6 +7981,7 @@ namespace bgfx { namespace gl
 
 					setProgram(id);
 					programChanged =
+						groupChanged =
 						constantsChanged =
 						bindAttribs = true;
 				}
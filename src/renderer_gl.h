@@ -1084,6 +1084,10 @@ typedef uint64_t GLuint64;
 #	define GL_TEXTURE_LOD_BIAS 0x8501
 #endif // GL_TEXTURE_LOD_BIAS
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#	define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif // GL_COMPLETION_STATUS_KHR
+
 #if BX_PLATFORM_WINDOWS
 #	include <windows.h>
 #elif BX_PLATFORM_LINUX || BX_PLATFORM_BSD
@@ -1478,12 +1482,22 @@ namespace bgfx { namespace gl
 			: m_id(0)
 			, m_constantBuffer{}
 			, m_numPredefined(0)
+			, m_pending(false)
 		{
 		}
 
 		void create(const ShaderGL& _vsh, const ShaderGL& _gsh, const ShaderGL& _fsh);
 		void destroy();
 		void init();
+
+		/// Returns true when program is done linking, without blocking. Program that
+		/// failed to link is done too, and has m_id set to 0.
+		bool poll();
+
+		/// Blocks until program is done linking.
+		void wait();
+
+		void link();
 		void bindInstanceData(uint32_t _stride, uint32_t _baseVertex = 0) const;
 		void unbindInstanceData() const;
 
@@ -1523,6 +1537,12 @@ namespace bgfx { namespace gl
 		UniformBuffer* m_constantBuffer[UniformSet::Count];
 		PredefinedUniform m_predefined[PredefinedUniform::Count];
 		uint8_t m_numPredefined;
+
+		uint64_t m_hash;
+		GLuint m_vsh;
+		GLuint m_fsh;
+		bool m_cached;
+		bool m_pending; // Linking asynchronously, see BGFX_CONFIG_RENDERER_OPENGL_ASYNC_PROGRAM.
 	};
 
 	struct TimerQueryGL
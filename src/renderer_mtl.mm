@@ -2406,6 +2406,15 @@ namespace bgfx { namespace mtl
 				uint16_t texFormat = 0;
 				bx::read(&reader, texFormat);
 			}
+
+			if (!isShaderVerLess(magic, 12) )
+			{
+				uint32_t nameHash = 0;
+				bx::read(&reader, nameHash);
+
+				uint8_t predefined = 0;
+				bx::read(&reader, predefined);
+			}
 		}
 
 		if (isShaderType(magic, 'C'))
@@ -3708,6 +3717,7 @@ namespace bgfx { namespace mtl
 		bool wireframe = !!(_render->m_debug&BGFX_DEBUG_WIREFRAME);
 
 		ProgramHandle currentProgram = BGFX_INVALID_HANDLE;
+		uint16_t currentGroup = UINT16_MAX;
 		SortKey key;
 		uint16_t view = UINT16_MAX;
 		FrameBufferHandle fbh = { BGFX_CONFIG_MAX_FRAME_BUFFERS };
@@ -4290,8 +4300,18 @@ namespace bgfx { namespace mtl
 
 				bool programChanged = false;
 				bool constantsChanged = draw.m_uniformBegin < draw.m_uniformEnd;
+
+				// Pipeline constant buffer is committed on every draw, it's enough to
+				// update cached uniform values when group changes.
+				if (draw.m_uniformGroup[UniformSet::Group] != currentGroup)
+				{
+					rendererUpdateUniformGroup(this, draw.m_uniformGroup[UniformSet::Group]);
+				}
+
 				rendererUpdateUniforms(this, _render->m_submitUniforms[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
+				currentGroup = draw.m_uniformGroup[UniformSet::Group];
+
 				bool vertexStreamChanged = hasVertexStreamChanged(currentState, draw);
 
 				if (key.m_program.idx != currentProgram.idx
@@ -4,9 +4,140 @@
  */
 
 #include "bgfx_p.h"
+#include "renderer.h"
 
 namespace bgfx { namespace noop
 {
+	static char s_viewName[BGFX_CONFIG_MAX_VIEWS][BGFX_CONFIG_MAX_VIEW_NAME];
+
+	struct PrimInfo
+	{
+		uint32_t m_min;
+		uint32_t m_div;
+		uint32_t m_sub;
+	};
+
+	static const PrimInfo s_primInfo[] =
+	{
+		{ 3, 3, 0 },
+		{ 3, 1, 2 },
+		{ 2, 2, 0 },
+		{ 2, 1, 1 },
+		{ 1, 1, 0 },
+		{ 0, 0, 0 },
+	};
+	BX_STATIC_ASSERT(Topology::Count == BX_COUNTOF(s_primInfo)-1);
+
+	struct BufferNOOP
+	{
+		void create(uint32_t _size, uint16_t _flags, VertexLayoutHandle _layoutHandle)
+		{
+			m_size         = _size;
+			m_flags        = _flags;
+			m_layoutHandle = _layoutHandle;
+		}
+
+		void destroy()
+		{
+			m_size = 0;
+		}
+
+		uint32_t m_size;
+		uint16_t m_flags;
+		VertexLayoutHandle m_layoutHandle;
+	};
+
+	struct ShaderNOOP
+	{
+		ShaderNOOP()
+			: m_numPredefined(0)
+		{
+			bx::memSet(m_constantBuffer, 0, sizeof(m_constantBuffer) );
+		}
+
+		void create(const Memory* _mem);
+		void destroy();
+
+		UniformBuffer* m_constantBuffer[UniformSet::Count];
+		PredefinedUniform m_predefined[PredefinedUniform::Count];
+		uint8_t m_numPredefined;
+	};
+
+	struct ProgramNOOP
+	{
+		void create(const ShaderNOOP* _vsh, const ShaderNOOP* _gsh, const ShaderNOOP* _fsh)
+		{
+			m_shader[0] = _vsh;
+			m_shader[1] = _gsh;
+			m_shader[2] = _fsh;
+			m_numPredefined = 0;
+
+			for (uint32_t ii = 0; ii < BX_COUNTOF(m_shader); ++ii)
+			{
+				const ShaderNOOP* shader = m_shader[ii];
+				if (NULL != shader)
+				{
+					bx::memCopy(&m_predefined[m_numPredefined], shader->m_predefined, shader->m_numPredefined*sizeof(PredefinedUniform) );
+					m_numPredefined += shader->m_numPredefined;
+				}
+			}
+		}
+
+		void destroy()
+		{
+			m_numPredefined = 0;
+			m_shader[0] = NULL;
+			m_shader[1] = NULL;
+			m_shader[2] = NULL;
+		}
+
+		const ShaderNOOP* m_shader[3];
+		PredefinedUniform m_predefined[PredefinedUniform::Count*3];
+		uint8_t m_numPredefined;
+	};
+
+	// Stands in for GPU timer when replaying frame, views are timed on CPU.
+	struct TimerQueryNOOP
+	{
+		struct Result
+		{
+			void reset()
+			{
+				m_begin     = 0;
+				m_end       = 0;
+				m_frequency = bx::getHPFrequency();
+				m_pending   = 0;
+			}
+
+			uint64_t m_begin;
+			uint64_t m_end;
+			uint64_t m_frequency;
+			uint32_t m_pending;
+		};
+
+		TimerQueryNOOP()
+		{
+			for (uint32_t ii = 0; ii < BX_COUNTOF(m_result); ++ii)
+			{
+				m_result[ii].reset();
+			}
+		}
+
+		uint32_t begin(uint32_t _resultIdx)
+		{
+			Result& result = m_result[_resultIdx];
+			result.m_begin = bx::getHPCounter();
+			return _resultIdx;
+		}
+
+		void end(uint32_t _idx)
+		{
+			m_result[_idx].m_end = bx::getHPCounter();
+		}
+
+		Result m_result[BGFX_CONFIG_MAX_VIEWS+1];
+	};
+
 	struct RendererContextNOOP : public RendererContextI
 	{
 		RendererContextNOOP()
@@ -68,6 +199,9 @@ namespace bgfx { namespace noop
 			g_caps.limits.maxComputeBindings = g_caps.limits.maxTextureSamplers;
 			g_caps.limits.maxFBAttachments   = BGFX_CONFIG_MAX_FRAME_BUFFER_ATTACHMENTS;
 			g_caps.limits.maxVertexStreams   = BGFX_CONFIG_MAX_VERTEX_STREAMS;
+
+			bx::memSet(&m_device, 0, sizeof(m_device) );
+			m_numConstantsChanged = 0;
 		}
 
 		~RendererContextNOOP()
@@ -93,68 +227,88 @@ namespace bgfx { namespace noop
 		{
 		}
 
-		void createIndexBuffer(IndexBufferHandle /*_handle*/, const Memory* /*_mem*/, uint16_t /*_flags*/) override
+		void createIndexBuffer(IndexBufferHandle _handle, const Memory* _mem, uint16_t _flags) override
 		{
+			m_indexBuffers[_handle.idx].create(_mem->size, _flags, BGFX_INVALID_HANDLE);
 		}
 
-		void destroyIndexBuffer(IndexBufferHandle /*_handle*/) override
+		void destroyIndexBuffer(IndexBufferHandle _handle) override
 		{
+			m_indexBuffers[_handle.idx].destroy();
 		}
 
-		void createVertexLayout(VertexLayoutHandle /*_handle*/, const VertexLayout& /*_layout*/) override
+		void createVertexLayout(VertexLayoutHandle _handle, const VertexLayout& _layout) override
 		{
+			bx::memCopy(&m_vertexLayouts[_handle.idx], &_layout, sizeof(VertexLayout) );
 		}
 
 		void destroyVertexLayout(VertexLayoutHandle /*_handle*/) override
 		{
 		}
 
-		void createVertexBuffer(VertexBufferHandle /*_handle*/, const Memory* /*_mem*/, VertexLayoutHandle /*_layoutHandle*/, uint16_t /*_flags*/) override
+		void createVertexBuffer(VertexBufferHandle _handle, const Memory* _mem, VertexLayoutHandle _layoutHandle, uint16_t _flags) override
 		{
+			m_vertexBuffers[_handle.idx].create(_mem->size, _flags, _layoutHandle);
 		}
 
-		void destroyVertexBuffer(VertexBufferHandle /*_handle*/) override
+		void destroyVertexBuffer(VertexBufferHandle _handle) override
 		{
+			m_vertexBuffers[_handle.idx].destroy();
 		}
 
-		void createDynamicIndexBuffer(IndexBufferHandle /*_handle*/, uint32_t /*_size*/, uint16_t /*_flags*/) override
+		void createDynamicIndexBuffer(IndexBufferHandle _handle, uint32_t _size, uint16_t _flags) override
 		{
+			m_indexBuffers[_handle.idx].create(_size, _flags, BGFX_INVALID_HANDLE);
 		}
 
 		void updateDynamicIndexBuffer(IndexBufferHandle /*_handle*/, uint32_t /*_offset*/, uint32_t /*_size*/, const Memory* /*_mem*/) override
 		{
 		}
 
-		void destroyDynamicIndexBuffer(IndexBufferHandle /*_handle*/) override
+		void destroyDynamicIndexBuffer(IndexBufferHandle _handle) override
 		{
+			m_indexBuffers[_handle.idx].destroy();
 		}
 
-		void createDynamicVertexBuffer(VertexBufferHandle /*_handle*/, uint32_t /*_size*/, uint16_t /*_flags*/) override
+		void createDynamicVertexBuffer(VertexBufferHandle _handle, uint32_t _size, uint16_t _flags) override
 		{
+			m_vertexBuffers[_handle.idx].create(_size, _flags, BGFX_INVALID_HANDLE);
 		}
 
 		void updateDynamicVertexBuffer(VertexBufferHandle /*_handle*/, uint32_t /*_offset*/, uint32_t /*_size*/, const Memory* /*_mem*/) override
 		{
 		}
 
-		void destroyDynamicVertexBuffer(VertexBufferHandle /*_handle*/) override
+		void destroyDynamicVertexBuffer(VertexBufferHandle _handle) override
 		{
+			m_vertexBuffers[_handle.idx].destroy();
 		}
 
-		void createShader(ShaderHandle /*_handle*/, const Memory* /*_mem*/) override
+		void createShader(ShaderHandle _handle, const Memory* _mem) override
 		{
+			if (BX_ENABLED(BGFX_CONFIG_RENDERER_NOOP_REPLAY) )
+			{
+				m_shaders[_handle.idx].create(_mem);
+			}
 		}
 
-		void destroyShader(ShaderHandle /*_handle*/) override
+		void destroyShader(ShaderHandle _handle) override
 		{
+			m_shaders[_handle.idx].destroy();
 		}
 
-		void createProgram(ProgramHandle /*_handle*/, ShaderHandle /*_vsh*/, ShaderHandle /*_gsh*/, ShaderHandle /*_fsh*/) override
+		void createProgram(ProgramHandle _handle, ShaderHandle _vsh, ShaderHandle _gsh, ShaderHandle _fsh) override
 		{
+			m_program[_handle.idx].create(
+				  &m_shaders[_vsh.idx]
+				, isValid(_gsh) ? &m_shaders[_gsh.idx] : NULL
+				, isValid(_fsh) ? &m_shaders[_fsh.idx] : NULL
+				);
 		}
 
-		void destroyProgram(ProgramHandle /*_handle*/) override
+		void destroyProgram(ProgramHandle _handle) override
 		{
+			m_program[_handle.idx].destroy();
 		}
 
 		void* createTexture(TextureHandle /*_handle*/, const Memory* /*_mem*/, uint64_t /*_flags*/, uint8_t /*_skip*/) override
@@ -207,24 +361,33 @@ namespace bgfx { namespace noop
 		{
 		}
 
-		void createUniform(UniformHandle /*_handle*/, UniformType::Enum /*_type*/, uint16_t /*_num*/, const char* /*_name*/, UniformSet::Enum /*_freq*/) override
+		void createUniform(UniformHandle _handle, UniformType::Enum _type, uint16_t _num, const char* _name, UniformSet::Enum _freq) override
 		{
+			m_uniforms.createUniform(_handle, _type, _num, _freq);
+			m_uniformReg.add(_handle, _name, _freq);
 		}
 
-		void destroyUniform(UniformHandle /*_handle*/) override
+		void destroyUniform(UniformHandle _handle) override
 		{
+			m_uniforms.destroyUniform(_handle);
+			m_uniformReg.remove(_handle);
 		}
 
 		void requestScreenShot(FrameBufferHandle /*_handle*/, const char* /*_filePath*/) override
 		{
 		}
 
-		void updateViewName(ViewId /*_id*/, const char* /*_name*/) override
+		void updateViewName(ViewId _id, const char* _name) override
 		{
+			bx::strCopy(&s_viewName[_id][BGFX_CONFIG_MAX_VIEW_NAME_RESERVED]
+				, BX_COUNTOF(s_viewName[0]) - BGFX_CONFIG_MAX_VIEW_NAME_RESERVED
+				, _name
+				);
 		}
 
-		void updateUniform(uint16_t /*_loc*/, const void* /*_data*/, uint32_t /*_size*/) override
+		void updateUniform(uint16_t _loc, const void* _data, uint32_t _size) override
 		{
+			m_uniforms.updateUniform(_loc, _data, _size);
 		}
 
 		void invalidateOcclusionQuery(OcclusionQueryHandle /*_handle*/) override
@@ -239,8 +402,78 @@ namespace bgfx { namespace noop
 		{
 		}
 
+		void setShaderUniform(uint8_t _flags, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
+		{
+			uint8_t* scratch = m_vsScratch;
+			if (_flags&kUniformFragmentBit)
+			{
+				scratch = m_fsScratch;
+			}
+			else if (_flags&kUniformGeometryBit)
+			{
+				scratch = m_gsScratch;
+			}
+
+			// Register layout depends on shader profile, don't trust it to fit.
+			if (_regIndex + _numRegs*16 <= sizeof(m_vsScratch) )
+			{
+				bx::memCopy(&scratch[_regIndex], _val, _numRegs*16);
+				m_numConstantsChanged += _numRegs;
+			}
+		}
+
+		void setShaderUniform4f(uint8_t _flags, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
+		{
+			setShaderUniform(_flags, _regIndex, _val, _numRegs);
+		}
+
+		void setShaderUniform4x4f(uint8_t _flags, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
+		{
+			setShaderUniform(_flags, _regIndex, _val, _numRegs);
+		}
+
+		void commitConstants(const ProgramNOOP& _program, UniformSet::Enum _freq)
+		{
+			for (uint32_t ii = 0; ii < BX_COUNTOF(_program.m_shader); ++ii)
+			{
+				const ShaderNOOP* shader = _program.m_shader[ii];
+				if (NULL != shader
+				&&  NULL != shader->m_constantBuffer[_freq])
+				{
+					m_uniforms.commitUniforms(*this, *shader->m_constantBuffer[_freq]);
+				}
+			}
+		}
+
+		void commitShaderConstants()
+		{
+			m_numConstantsChanged = 0;
+		}
+
+		bool isVisible(Frame* _render, OcclusionQueryHandle _handle, bool _visible)
+		{
+			return _visible == (0 != _render->m_occlusion[_handle.idx]);
+		}
+
+		void submitBlit(BlitState& _bs, uint16_t _view)
+		{
+			while (_bs.hasItem(_view) )
+			{
+				const BlitItem& blit = _bs.advance();
+				m_device.m_blit = blit.m_dst.idx;
+			}
+		}
+
+		void submitReplay(Frame* _render);
+
 		void submit(Frame* _render, ClearQuad& /*_clearQuad*/, TextVideoMemBlitter& /*_textVideoMemBlitter*/) override
 		{
+			if (BX_ENABLED(BGFX_CONFIG_RENDERER_NOOP_REPLAY) )
+			{
+				submitReplay(_render);
+				return;
+			}
+
 			const int64_t timerFreq = bx::getHPFrequency();
 			const int64_t timeBegin = bx::getHPCounter();
 
@@ -266,10 +499,593 @@ namespace bgfx { namespace noop
 		void blitRender(TextVideoMemBlitter& /*_blitter*/, uint32_t /*_numIndices*/) override
 		{
 		}
+
+		// Stub device, replay writes here whatever real backend would send to
+		// the driver, so that state diffing can't be optimized out.
+		struct Device
+		{
+			uint64_t m_stateFlags;
+			uint64_t m_stencil;
+			uint32_t m_rgba;
+			uint32_t m_numStreams;
+			uint32_t m_numVertices;
+			uint16_t m_indexBuffer;
+			uint16_t m_program;
+			uint16_t m_frameBuffer;
+			uint16_t m_blit;
+			uint16_t m_bind[BGFX_CONFIG_MAX_TEXTURE_SAMPLERS];
+			Rect     m_viewport;
+			Rect     m_scissor;
+		};
+
+		Device m_device;
+
+		UniformState    m_uniforms;
+		UniformRegistry m_uniformReg;
+		TimerQueryNOOP  m_gpuTimer;
+
+		BufferNOOP   m_indexBuffers[BGFX_CONFIG_MAX_INDEX_BUFFERS];
+		BufferNOOP   m_vertexBuffers[BGFX_CONFIG_MAX_VERTEX_BUFFERS];
+		ShaderNOOP   m_shaders[BGFX_CONFIG_MAX_SHADERS];
+		ProgramNOOP  m_program[BGFX_CONFIG_MAX_PROGRAMS];
+		VertexLayout m_vertexLayouts[BGFX_CONFIG_MAX_VERTEX_LAYOUTS];
+
+		uint8_t  m_vsScratch[64<<10];
+		uint8_t  m_gsScratch[64<<10];
+		uint8_t  m_fsScratch[64<<10];
+		uint32_t m_numConstantsChanged;
 	};
 
 	static RendererContextNOOP* s_renderNOOP;
 
+	void ShaderNOOP::create(const Memory* _mem)
+	{
+		bx::MemoryReader reader(_mem->data, _mem->size);
+
+		uint32_t magic;
+		bx::read(&reader, magic);
+
+		const uint8_t fragmentBit = 0
+			| (isShaderType(magic, 'F') ? kUniformFragmentBit : 0)
+			| (isShaderType(magic, 'G') ? kUniformGeometryBit : 0)
+			;
+
+		uint32_t hashIn;
+		bx::read(&reader, hashIn);
+
+		if (!isShaderVerLess(magic, 6) )
+		{
+			uint32_t hashOut;
+			bx::read(&reader, hashOut);
+		}
+
+		uint16_t count;
+		bx::read(&reader, count);
+
+		m_numPredefined = 0;
+
+		for (uint32_t ii = 0; ii < count; ++ii)
+		{
+			uint8_t nameSize = 0;
+			bx::read(&reader, nameSize);
+
+			char name[256] = { '\0' };
+			bx::read(&reader, &name, nameSize);
+			name[nameSize] = '\0';
+
+			uint8_t type = 0;
+			bx::read(&reader, type);
+
+			uint8_t num = 0;
+			bx::read(&reader, num);
+
+			uint16_t regIndex = 0;
+			bx::read(&reader, regIndex);
+
+			uint16_t regCount = 0;
+			bx::read(&reader, regCount);
+
+			if (!isShaderVerLess(magic, 8) )
+			{
+				uint16_t texInfo = 0;
+				bx::read(&reader, texInfo);
+			}
+
+			if (!isShaderVerLess(magic, 10) )
+			{
+				uint16_t texFormat = 0;
+				bx::read(&reader, texFormat);
+			}
+
+			uint32_t nameHash;
+			PredefinedUniform::Enum predefined;
+			readUniformReflection(&reader, magic, name, nameHash, predefined);
+
+			if (PredefinedUniform::Count != predefined)
+			{
+				m_predefined[m_numPredefined].m_loc   = regIndex;
+				m_predefined[m_numPredefined].m_count = regCount;
+				m_predefined[m_numPredefined].m_type  = uint8_t(predefined|fragmentBit);
+				m_numPredefined++;
+			}
+			else if (0 == (kUniformSamplerBit & type) )
+			{
+				const UniformRegInfo* info = s_renderNOOP->m_uniformReg.find(nameHash);
+
+				if (NULL != info)
+				{
+					const UniformSet::Enum freq = info->m_freq;
+					if (NULL == m_constantBuffer[freq])
+					{
+						m_constantBuffer[freq] = UniformBuffer::create(1024);
+					}
+
+					m_constantBuffer[freq]->writeUniformHandle( (UniformType::Enum)(type|fragmentBit), regIndex, info->m_handle, regCount);
+				}
+			}
+		}
+
+		for (uint32_t ii = 0; ii < UniformSet::Count; ++ii)
+		{
+			if (NULL != m_constantBuffer[ii])
+			{
+				m_constantBuffer[ii]->finish();
+			}
+		}
+	}
+
+	void ShaderNOOP::destroy()
+	{
+		for (uint32_t ii = 0; ii < UniformSet::Count; ++ii)
+		{
+			if (NULL != m_constantBuffer[ii])
+			{
+				UniformBuffer::destroy(m_constantBuffer[ii]);
+				m_constantBuffer[ii] = NULL;
+			}
+		}
+
+		m_numPredefined = 0;
+	}
+
+	void RendererContextNOOP::submitReplay(Frame* _render)
+	{
+		const int64_t timeBegin = bx::getHPCounter();
+
+		_render->sort();
+
+		RenderDraw currentState;
+		currentState.clear();
+		currentState.m_stateFlags = BGFX_STATE_NONE;
+		currentState.m_stencil    = packStencil(BGFX_STENCIL_NONE, BGFX_STENCIL_NONE);
+
+		uint32_t currentNumVertices = 0;
+
+		RenderBind currentBind;
+		currentBind.clear();
+
+		static ViewState viewState;
+		viewState.reset(_render);
+
+		uint16_t currentGroup = UINT16_MAX;
+		ProgramHandle currentProgram = BGFX_INVALID_HANDLE;
+		SortKey key;
+		uint16_t view = UINT16_MAX;
+		FrameBufferHandle fbh = { BGFX_CONFIG_MAX_FRAME_BUFFERS };
+
+		BlitState bs(_render);
+
+		uint8_t primIndex = uint8_t( (_render->m_debug&BGFX_DEBUG_WIREFRAME ? BGFX_STATE_PT_LINES : 0) >> BGFX_STATE_PT_SHIFT);
+		PrimInfo prim = s_primInfo[primIndex];
+
+		bool wasCompute = false;
+		bool viewHasScissor = false;
+		Rect viewScissorRect;
+		viewScissorRect.clear();
+
+		const uint32_t maxComputeBindings = g_caps.limits.maxComputeBindings;
+		const uint32_t maxTextureSamplers = g_caps.limits.maxTextureSamplers;
+
+		uint32_t statsNumPrimsRendered[BX_COUNTOF(s_primInfo)] = {};
+		uint32_t statsKeyType[2] = {};
+
+		Profiler<TimerQueryNOOP> profiler(
+			  _render
+			, m_gpuTimer
+			, s_viewName
+			);
+
+		rendererUpdateUniforms(this, _render->m_frameUniforms, 0, UINT32_MAX);
+		_render->m_frameUniforms->reset();
+
+		if (0 == (_render->m_debug&BGFX_DEBUG_IFH) )
+		{
+			viewState.m_rect = _render->m_view[0].m_rect;
+			int32_t numItems = _render->m_numRenderItems;
+
+			for (int32_t item = 0; item < numItems;)
+			{
+				const uint64_t encodedKey = _render->m_sortKeys[item];
+				const bool isCompute = key.decode(encodedKey, _render->m_viewRemap);
+				statsKeyType[isCompute]++;
+
+				const bool viewChanged = 0
+					|| key.m_view != view
+					|| item == numItems
+					;
+
+				const uint32_t itemIdx       = _render->m_sortValues[item];
+				const RenderItem& renderItem = _render->m_renderItem[itemIdx];
+				const RenderBind& renderBind = _render->m_renderItemBind[itemIdx];
+				++item;
+
+				if (viewChanged)
+				{
+					view = key.m_view;
+					currentProgram = BGFX_INVALID_HANDLE;
+
+					if (item > 1)
+					{
+						profiler.end();
+					}
+
+					profiler.begin(view);
+
+					if (_render->m_view[view].m_fbh.idx != fbh.idx)
+					{
+						fbh = _render->m_view[view].m_fbh;
+						m_device.m_frameBuffer = fbh.idx;
+					}
+
+					viewState.m_rect = _render->m_view[view].m_rect;
+
+					const Rect& scissorRect = _render->m_view[view].m_scissor;
+					viewHasScissor  = !scissorRect.isZero();
+					viewScissorRect = viewHasScissor ? scissorRect : viewState.m_rect;
+
+					m_device.m_viewport = viewState.m_rect;
+
+					submitBlit(bs, view);
+
+					if (UINT32_MAX != _render->m_view[view].m_uniformBegin)
+					{
+						rendererUpdateUniforms(this
+							, _render->m_viewUniforms
+							, _render->m_view[view].m_uniformBegin
+							, _render->m_view[view].m_uniformEnd
+							);
+						_render->m_viewUniforms->reset();
+					}
+				}
+
+				if (isCompute)
+				{
+					wasCompute = true;
+
+					const RenderCompute& compute = renderItem.compute;
+
+					bool programChanged = false;
+					bool constantsChanged = compute.m_uniformBegin < compute.m_uniformEnd;
+					rendererUpdateUniforms(this, _render->m_submitUniforms[compute.m_uniformIdx], compute.m_uniformBegin, compute.m_uniformEnd);
+
+					if (key.m_program.idx != currentProgram.idx)
+					{
+						currentProgram = key.m_program;
+						m_device.m_program = currentProgram.idx;
+
+						programChanged =
+							constantsChanged = true;
+					}
+
+					if (isValid(currentProgram) )
+					{
+						const ProgramNOOP& program = m_program[currentProgram.idx];
+
+						if (constantsChanged)
+						{
+							commitConstants(program, UniformSet::Submit);
+						}
+
+						viewState.setPredefined<4>(*this, view, program, _render, compute, programChanged || viewChanged);
+
+						if (constantsChanged
+						||  program.m_numPredefined > 0)
+						{
+							commitShaderConstants();
+						}
+					}
+
+					for (uint8_t stage = 0; stage < maxComputeBindings; ++stage)
+					{
+						m_device.m_bind[stage] = renderBind.m_bind[stage].m_idx;
+					}
+
+					continue;
+				}
+
+				bool resetState = viewChanged || wasCompute;
+
+				if (wasCompute)
+				{
+					currentProgram = BGFX_INVALID_HANDLE;
+				}
+
+				const RenderDraw& draw = renderItem.draw;
+
+				const bool hasOcclusionQuery = 0 != (draw.m_stateFlags & BGFX_STATE_INTERNAL_OCCLUSION_QUERY);
+				{
+					const bool occluded = true
+						&& isValid(draw.m_occlusionQuery)
+						&& !hasOcclusionQuery
+						&& !isVisible(_render, draw.m_occlusionQuery, 0 != (draw.m_submitFlags&BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE) )
+						;
+
+					if (occluded
+					||  _render->m_frameCache.isZeroArea(viewScissorRect, draw.m_scissor) )
+					{
+						if (resetState)
+						{
+							currentState.clear();
+							currentState.m_scissor = !draw.m_scissor;
+							currentBind.clear();
+						}
+
+						continue;
+					}
+				}
+
+				const uint64_t newFlags = draw.m_stateFlags;
+				uint64_t changedFlags = currentState.m_stateFlags ^ draw.m_stateFlags;
+				changedFlags |= currentState.m_rgba != draw.m_rgba ? BGFX_STATE_BLEND_MASK : 0;
+				currentState.m_stateFlags = newFlags;
+
+				const uint64_t newStencil = draw.m_stencil;
+				uint64_t changedStencil = currentState.m_stencil ^ draw.m_stencil;
+				currentState.m_stencil = newStencil;
+
+				if (resetState)
+				{
+					wasCompute = false;
+
+					currentState.clear();
+					currentState.m_scissor = !draw.m_scissor;
+					changedFlags = BGFX_STATE_MASK;
+					changedStencil = packStencil(BGFX_STENCIL_MASK, BGFX_STENCIL_MASK);
+					currentState.m_stateFlags = newFlags;
+					currentState.m_stencil    = newStencil;
+
+					currentBind.clear();
+				}
+
+				if (0 != changedFlags)
+				{
+					m_device.m_stateFlags = newFlags;
+
+					if (BGFX_STATE_ALPHA_REF_MASK & changedFlags)
+					{
+						uint32_t ref = (newFlags&BGFX_STATE_ALPHA_REF_MASK)>>BGFX_STATE_ALPHA_REF_SHIFT;
+						viewState.m_alphaRef = ref/255.0f;
+					}
+
+					const uint64_t pt = newFlags&BGFX_STATE_PT_MASK;
+					primIndex = uint8_t(pt>>BGFX_STATE_PT_SHIFT);
+					prim = s_primInfo[primIndex];
+				}
+
+				if (0 != changedStencil)
+				{
+					m_device.m_stencil = newStencil;
+				}
+
+				if (BGFX_STATE_BLEND_MASK & changedFlags)
+				{
+					m_device.m_rgba = draw.m_rgba;
+					currentState.m_rgba = draw.m_rgba;
+				}
+
+				uint16_t scissor = draw.m_scissor;
+				if (currentState.m_scissor != scissor)
+				{
+					currentState.m_scissor = scissor;
+
+					if (UINT16_MAX == scissor)
+					{
+						m_device.m_scissor = viewScissorRect;
+					}
+					else
+					{
+						m_device.m_scissor.setIntersect(viewScissorRect, _render->m_frameCache.m_rectCache.m_cache[scissor]);
+					}
+				}
+
+				bool programChanged = false;
+				bool constantsChanged = draw.m_uniformBegin < draw.m_uniformEnd;
+				bool groupChanged = draw.m_uniformGroup[UniformSet::Group] != currentGroup;
+				if (groupChanged)
+				{
+					rendererUpdateUniformGroup(this, draw.m_uniformGroup[UniformSet::Group]);
+				}
+
+				rendererUpdateUniforms(this, _render->m_submitUniforms[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
+
+				currentGroup = draw.m_uniformGroup[UniformSet::Group];
+
+				if (key.m_program.idx != currentProgram.idx)
+				{
+					currentProgram = key.m_program;
+					m_device.m_program = currentProgram.idx;
+
+					programChanged =
+					groupChanged =
+						constantsChanged = true;
+				}
+
+				if (isValid(currentProgram) )
+				{
+					const ProgramNOOP& program = m_program[currentProgram.idx];
+
+					if (programChanged)
+					{
+						commitConstants(program, UniformSet::Frame);
+						commitConstants(program, UniformSet::View);
+					}
+
+					if (groupChanged)
+					{
+						commitConstants(program, UniformSet::Group);
+					}
+
+					if (constantsChanged)
+					{
+						commitConstants(program, UniformSet::Submit);
+					}
+
+					viewState.setPredefined<4>(*this, view, program, _render, draw, programChanged || viewChanged);
+
+					if (constantsChanged
+					||  programChanged
+					||  program.m_numPredefined > 0)
+					{
+						commitShaderConstants();
+					}
+				}
+
+				for (uint8_t stage = 0; stage < maxTextureSamplers; ++stage)
+				{
+					const Binding& bind = renderBind.m_bind[stage];
+					Binding& current = currentBind.m_bind[stage];
+					if (current.m_idx          != bind.m_idx
+					||  current.m_type         != bind.m_type
+					||  current.m_samplerFlags != bind.m_samplerFlags
+					||  programChanged)
+					{
+						m_device.m_bind[stage] = bind.m_idx;
+					}
+
+					current = bind;
+				}
+
+				if (programChanged
+				||  hasVertexStreamChanged(currentState, draw) )
+				{
+					currentState.m_streamMask             = draw.m_streamMask;
+					currentState.m_instanceDataBuffer.idx = draw.m_instanceDataBuffer.idx;
+					currentState.m_instanceDataOffset     = draw.m_instanceDataOffset;
+					currentState.m_instanceDataStride     = draw.m_instanceDataStride;
+
+					uint32_t numVertices = draw.m_numVertices;
+					uint8_t  numStreams  = 0;
+
+					if (UINT8_MAX != draw.m_streamMask)
+					{
+						for (uint32_t idx = 0, streamMask = draw.m_streamMask
+							; 0 != streamMask
+							; streamMask >>= 1, idx += 1, ++numStreams
+							)
+						{
+							const uint32_t ntz = bx::uint32_cnttz(streamMask);
+							streamMask >>= ntz;
+							idx         += ntz;
+
+							currentState.m_stream[idx].m_layoutHandle = draw.m_stream[idx].m_layoutHandle;
+							currentState.m_stream[idx].m_handle       = draw.m_stream[idx].m_handle;
+							currentState.m_stream[idx].m_startVertex  = draw.m_stream[idx].m_startVertex;
+
+							const BufferNOOP& vb = m_vertexBuffers[draw.m_stream[idx].m_handle.idx];
+							const uint16_t layoutIdx = isValid(draw.m_stream[idx].m_layoutHandle)
+								? draw.m_stream[idx].m_layoutHandle.idx
+								: vb.m_layoutHandle.idx
+								;
+							const uint32_t stride = kInvalidHandle != layoutIdx
+								? bx::max<uint32_t>(m_vertexLayouts[layoutIdx].m_stride, 1)
+								: 1
+								;
+
+							numVertices = bx::uint32_min(UINT32_MAX == draw.m_numVertices
+								? vb.m_size/stride
+								: draw.m_numVertices
+								, numVertices
+								);
+						}
+					}
+
+					currentNumVertices    = numVertices;
+					m_device.m_numStreams = numStreams;
+				}
+
+				if (currentState.m_indexBuffer.idx != draw.m_indexBuffer.idx
+				||  currentState.isIndex16() != draw.isIndex16() )
+				{
+					currentState.m_indexBuffer = draw.m_indexBuffer;
+					currentState.m_submitFlags = draw.m_submitFlags;
+					m_device.m_indexBuffer = draw.m_indexBuffer.idx;
+				}
+
+				if (0 != currentState.m_streamMask)
+				{
+					uint32_t numIndices        = 0;
+					uint32_t numPrimsSubmitted = 0;
+
+					if (isValid(draw.m_indirectBuffer) )
+					{
+						// Primitive count of indirect draws is known only to GPU.
+					}
+					else if (isValid(draw.m_indexBuffer) )
+					{
+						if (UINT32_MAX == draw.m_numIndices)
+						{
+							const BufferNOOP& ib = m_indexBuffers[draw.m_indexBuffer.idx];
+							const uint32_t indexSize = 0 == (ib.m_flags & BGFX_BUFFER_INDEX32) ? 2 : 4;
+							numIndices        = ib.m_size/indexSize;
+							numPrimsSubmitted = numIndices/prim.m_div - prim.m_sub;
+						}
+						else if (prim.m_min <= draw.m_numIndices)
+						{
+							numIndices        = draw.m_numIndices;
+							numPrimsSubmitted = numIndices/prim.m_div - prim.m_sub;
+						}
+					}
+					else
+					{
+						numPrimsSubmitted = currentNumVertices/prim.m_div - prim.m_sub;
+					}
+
+					if (hasOcclusionQuery)
+					{
+						_render->m_occlusion[draw.m_occlusionQuery.idx] = 0 < numPrimsSubmitted ? 1 : 0;
+					}
+
+					m_device.m_numVertices = 0 < numIndices ? numIndices : currentNumVertices;
+					statsNumPrimsRendered[primIndex] += numPrimsSubmitted*draw.m_numInstances;
+				}
+			}
+
+			submitBlit(bs, BGFX_CONFIG_MAX_VIEWS);
+
+			if (0 < _render->m_numRenderItems)
+			{
+				profiler.end();
+			}
+		}
+
+		const int64_t timeEnd = bx::getHPCounter();
+
+		Stats& perfStats = _render->m_perfStats;
+		perfStats.cpuTimeBegin  = timeBegin;
+		perfStats.cpuTimeEnd    = timeEnd;
+		perfStats.cpuTimerFreq  = bx::getHPFrequency();
+		perfStats.gpuTimeBegin  = timeBegin;
+		perfStats.gpuTimeEnd    = timeEnd;
+		perfStats.gpuTimerFreq  = bx::getHPFrequency();
+		perfStats.numDraw       = statsKeyType[0];
+		perfStats.numCompute    = statsKeyType[1];
+		perfStats.numBlit       = _render->m_numBlitItems;
+		perfStats.maxGpuLatency = 0;
+		bx::memCopy(perfStats.numPrims, statsNumPrimsRendered, sizeof(perfStats.numPrims) );
+		perfStats.gpuMemoryMax  = -INT64_MAX;
+		perfStats.gpuMemoryUsed = -INT64_MAX;
+	}
+
 	RendererContextI* rendererCreate(const Init& _init)
 	{
 		BX_UNUSED(_init);
@@ -858,6 +858,20 @@ VK_IMPORT_DEVICE
 		}
 	}
 
+	// Header of whole pipeline cache blob stored through CallbackI. Driver
+	// pipeline cache data follows header.
+	struct PipelineCacheHeader
+	{
+		uint32_t magic;
+		uint32_t vendorId;
+		uint32_t deviceId;
+		uint32_t driverVersion;
+		uint8_t  uuid[VK_UUID_SIZE];
+		uint32_t dataSize;
+	};
+
+	static const uint32_t kPipelineCacheMagic = BX_MAKEFOURCC('V', 'K', 'P', 0x1);
+
 	void setMemoryBarrier(
 		  VkCommandBuffer _commandBuffer
 		, VkPipelineStageFlags _srcStages
@@ -1811,13 +1825,7 @@ VK_IMPORT_DEVICE
 					goto error;
 				}
 
-				VkPipelineCacheCreateInfo pcci;
-				pcci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-				pcci.pNext = NULL;
-				pcci.flags = 0;
-				pcci.initialDataSize = 0;
-				pcci.pInitialData    = NULL;
-				result = vkCreatePipelineCache(m_device, &pcci, m_allocatorCb, &m_pipelineCache);
+				result = createPipelineCache();
 
 				if (VK_SUCCESS != result)
 				{
@@ -1967,6 +1975,7 @@ VK_IMPORT_DEVICE
 				m_textures[ii].destroy();
 			}
 
+			savePipelineCache();
 			vkDestroy(m_pipelineCache);
 			vkDestroy(m_descriptorPool);
 
@@ -3340,6 +3349,7 @@ VK_IMPORT_DEVICE
 			cpci.basePipelineIndex  = 0;
 
 			VK_CHECK(vkCreateComputePipelines(m_device, m_pipelineCache, 1, &cpci, m_allocatorCb, &pipeline) );
+			m_pipelineCacheDirty = true;
 
 			m_pipelineStateCache.add(hash, pipeline);
 
@@ -3537,10 +3547,43 @@ VK_IMPORT_DEVICE
 			graphicsPipeline.basePipelineHandle = VK_NULL_HANDLE;
 			graphicsPipeline.basePipelineIndex  = 0;
 
-			uint32_t length = g_callback->cacheReadSize(hash);
-			bool cached = length > 0;
+			VK_CHECK(vkCreateGraphicsPipelines(
+				  m_device
+				, m_pipelineCache
+				, 1
+				, &graphicsPipeline
+				, m_allocatorCb
+				, &pipeline
+				) );
+			m_pipelineCacheDirty = true;
 
-			void* cachedData = NULL;
+			m_pipelineStateCache.add(hash, pipeline);
+
+			return pipeline;
+		}
+
+		uint64_t getPipelineCacheId() const
+		{
+			bx::HashMurmur2A murmur;
+			murmur.begin();
+			murmur.add(m_deviceProperties.vendorID);
+			murmur.add(m_deviceProperties.deviceID);
+			return (uint64_t(kPipelineCacheMagic)<<32) | murmur.end();
+		}
+
+		bool isPipelineCacheCompatible(const PipelineCacheHeader& _header) const
+		{
+			return kPipelineCacheMagic == _header.magic
+				&& m_deviceProperties.vendorID      == _header.vendorId
+				&& m_deviceProperties.deviceID      == _header.deviceId
+				&& m_deviceProperties.driverVersion == _header.driverVersion
+				&& 0 == bx::memCmp(m_deviceProperties.pipelineCacheUUID, _header.uuid, VK_UUID_SIZE)
+				;
+		}
+
+		VkResult createPipelineCache()
+		{
+			m_pipelineCacheDirty = false;
 
 			VkPipelineCacheCreateInfo pcci;
 			pcci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
@@ -3549,55 +3592,88 @@ VK_IMPORT_DEVICE
 			pcci.initialDataSize = 0;
 			pcci.pInitialData    = NULL;
 
-			if (cached)
+			const uint64_t id = getPipelineCacheId();
+			const uint32_t length = g_callback->cacheReadSize(id);
+
+			void* cachedData = NULL;
+
+			if (sizeof(PipelineCacheHeader) < length)
 			{
 				cachedData = BX_ALLOC(g_allocator, length);
-				if (g_callback->cacheRead(hash, cachedData, length) )
+				if (g_callback->cacheRead(id, cachedData, length) )
 				{
-					BX_TRACE("Loading cached pipeline state (size %d).", length);
 					bx::MemoryReader reader(cachedData, length);
 
-					pcci.initialDataSize = (size_t)reader.remaining();
-					pcci.pInitialData    = reader.getDataPtr();
+					PipelineCacheHeader header;
+					bx::read(&reader, header);
+
+					if (isPipelineCacheCompatible(header)
+					&&  header.dataSize == reader.remaining() )
+					{
+						BX_TRACE("Loading cached pipeline state (size %d).", header.dataSize);
+						pcci.initialDataSize = header.dataSize;
+						pcci.pInitialData    = reader.getDataPtr();
+					}
+					else
+					{
+						BX_TRACE("Cached pipeline state is not compatible with device, ignoring it.");
+						m_pipelineCacheDirty = true;
+					}
 				}
 			}
 
-			VkPipelineCache cache;
-			VK_CHECK(vkCreatePipelineCache(m_device, &pcci, m_allocatorCb, &cache) );
+			VkResult result = vkCreatePipelineCache(m_device, &pcci, m_allocatorCb, &m_pipelineCache);
 
-			VK_CHECK(vkCreateGraphicsPipelines(
-				  m_device
-				, cache
-				, 1
-				, &graphicsPipeline
-				, m_allocatorCb
-				, &pipeline
-				) );
-			m_pipelineStateCache.add(hash, pipeline);
+			if (VK_SUCCESS != result
+			&&  0 != pcci.initialDataSize)
+			{
+				BX_TRACE("vkCreatePipelineCache with cached data failed %d: %s.", result, getName(result) );
+				pcci.initialDataSize = 0;
+				pcci.pInitialData    = NULL;
+				result = vkCreatePipelineCache(m_device, &pcci, m_allocatorCb, &m_pipelineCache);
+				m_pipelineCacheDirty = true;
+			}
+
+			if (NULL != cachedData)
+			{
+				BX_FREE(g_allocator, cachedData);
+			}
+
+			return result;
+		}
+
+		void savePipelineCache()
+		{
+			if (!m_pipelineCacheDirty)
+			{
+				return;
+			}
 
 			size_t dataSize;
-			VK_CHECK(vkGetPipelineCacheData(m_device, cache, &dataSize, NULL) );
+			VK_CHECK(vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, NULL) );
 
 			if (0 < dataSize)
 			{
-				if (length < dataSize)
-				{
-					cachedData = BX_REALLOC(g_allocator, cachedData, dataSize);
-				}
+				const uint32_t size = uint32_t(sizeof(PipelineCacheHeader) + dataSize);
+				uint8_t* data = (uint8_t*)BX_ALLOC(g_allocator, size);
 
-				VK_CHECK(vkGetPipelineCacheData(m_device, cache, &dataSize, cachedData) );
-				g_callback->cacheWrite(hash, cachedData, (uint32_t)dataSize);
-			}
+				PipelineCacheHeader& header = *(PipelineCacheHeader*)data;
+				header.magic         = kPipelineCacheMagic;
+				header.vendorId      = m_deviceProperties.vendorID;
+				header.deviceId      = m_deviceProperties.deviceID;
+				header.driverVersion = m_deviceProperties.driverVersion;
+				bx::memCopy(header.uuid, m_deviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
 
-			VK_CHECK(vkMergePipelineCaches(m_device, m_pipelineCache, 1, &cache) );
-			vkDestroy(cache);
+				VK_CHECK(vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, &data[sizeof(PipelineCacheHeader)]) );
+				header.dataSize = uint32_t(dataSize);
 
-			if (NULL != cachedData)
-			{
-				BX_FREE(g_allocator, cachedData);
+				BX_TRACE("Saving pipeline state cache (size %d).", header.dataSize);
+				g_callback->cacheWrite(getPipelineCacheId(), data, uint32_t(sizeof(PipelineCacheHeader) + dataSize) );
+
+				BX_FREE(g_allocator, data);
 			}
 
-			return pipeline;
+			m_pipelineCacheDirty = false;
 		}
 
 		void allocDescriptorSet(const ProgramVK& program, const RenderBind& renderBind, ScratchBufferVK& scratchBuffer)
@@ -4132,6 +4208,7 @@ VK_IMPORT_DEVICE
 		VkQueue  m_queueCompute;
 		VkDescriptorPool m_descriptorPool;
 		VkPipelineCache  m_pipelineCache;
+		bool             m_pipelineCacheDirty;
 
 		TimerQueryVK m_gpuTimer;
 
@@ -4562,6 +4639,10 @@ VK_DESTROY
 					bx::read(&reader, texFormat);
 				}
 
+				uint32_t nameHash;
+				PredefinedUniform::Enum predefined;
+				readUniformReflection(&reader, magic, name, nameHash, predefined);
+
 				const char* kind = "invalid";
 
 				BX_UNUSED(num);
@@ -4584,7 +4665,6 @@ VK_DESTROY
 
 				if (UINT16_MAX != regIndex)
 				{
-					PredefinedUniform::Enum predefined = nameToPredefinedUniformEnum(name);
 					if (PredefinedUniform::Count != predefined)
 					{
 						kind = "predefined";
@@ -4637,7 +4717,7 @@ VK_DESTROY
 
 						const uint16_t stage = regIndex - reverseShift; // regIndex is used for image/sampler binding index
 
-						const UniformRegInfo* info = s_renderVK->m_uniformReg.find(name);
+						const UniformRegInfo* info = s_renderVK->m_uniformReg.find(nameHash);
 						const UniformSet::Enum freq = info->m_freq;
 						BX_ASSERT(NULL != info, "User defined uniform '%s' is not found, it won't be set.", name);
 
@@ -4662,7 +4742,7 @@ VK_DESTROY
 					}
 					else
 					{
-						const UniformRegInfo* info = s_renderVK->m_uniformReg.find(name);
+						const UniformRegInfo* info = s_renderVK->m_uniformReg.find(nameHash);
 						BX_ASSERT(NULL != info, "User defined uniform '%s' is not found, it won't be set.", name);
 
 						if (NULL != info)
@@ -7483,6 +7563,7 @@ VK_DESTROY
 
 		uint16_t currentSamplerStateIdx = kInvalidHandle;
 		ProgramHandle currentProgram    = BGFX_INVALID_HANDLE;
+		uint16_t currentGroup           = UINT16_MAX;
 		uint32_t currentBindHash        = 0;
 		uint32_t currentDslHash         = 0;
 		bool     hasPredefined          = false;
@@ -7869,8 +7950,16 @@ VK_DESTROY
 				}
 
 				const bool submitConstants = draw.m_uniformBegin < draw.m_uniformEnd;
+				const bool groupChanged = draw.m_uniformGroup[UniformSet::Group] != currentGroup;
+				if (groupChanged)
+				{
+					rendererUpdateUniformGroup(this, draw.m_uniformGroup[UniformSet::Group]);
+				}
+
 				rendererUpdateUniforms(this, _render->m_submitUniforms[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
+				currentGroup = draw.m_uniformGroup[UniformSet::Group];
+
 				if (0 != draw.m_streamMask)
 				{
 					currentState.m_streamMask = draw.m_streamMask;
@@ -8006,27 +8095,41 @@ VK_DESTROY
 					bool programChanged = currentProgram.idx != key.m_program.idx;
 					bool constantsChanged = false;
 					if (submitConstants
+					||  groupChanged
 					||  programChanged
 					||  BGFX_STATE_ALPHA_REF_MASK & changedFlags)
 					{
 						currentProgram = key.m_program;
 						ProgramVK& program = m_program[currentProgram.idx];
 
-						UniformBuffer* vcb = program.m_vsh->m_constantBuffer[UniformSet::Submit];
-						if (NULL != vcb)
+						auto commitConstants = [&](UniformSet::Enum _freq)
 						{
-							m_uniforms.commitUniforms(*this, *vcb);
-						}
+							UniformBuffer* vcb = program.m_vsh->m_constantBuffer[_freq];
+							if (NULL != vcb)
+							{
+								m_uniforms.commitUniforms(*this, *vcb);
+							}
 
-						if (NULL != program.m_fsh)
-						{
-							UniformBuffer* fcb = program.m_fsh->m_constantBuffer[UniformSet::Submit];
-							if (NULL != fcb)
+							if (NULL != program.m_fsh)
 							{
-								m_uniforms.commitUniforms(*this, *fcb);
+								UniformBuffer* fcb = program.m_fsh->m_constantBuffer[_freq];
+								if (NULL != fcb)
+								{
+									m_uniforms.commitUniforms(*this, *fcb);
+								}
 							}
+						};
+
+						// Scratch is shared between programs, group values must be written
+						// again when program changes.
+						if (groupChanged
+						||  programChanged)
+						{
+							commitConstants(UniformSet::Group);
 						}
 
+						commitConstants(UniformSet::Submit);
+
 						hasPredefined = 0 < program.m_numPredefined;
 						constantsChanged = true;
 					}
@@ -2485,7 +2485,10 @@ namespace bgfx { namespace webgpu
 
 				const char* kind = "invalid";
 
-				PredefinedUniform::Enum predefined = nameToPredefinedUniformEnum(name);
+				uint32_t nameHash;
+				PredefinedUniform::Enum predefined;
+				readUniformReflection(&reader, magic, name, nameHash, predefined);
+
 				if (PredefinedUniform::Count != predefined)
 				{
 					kind = "predefined";
@@ -2532,7 +2535,7 @@ namespace bgfx { namespace webgpu
 				}
 				else if (UniformType::Sampler == (~kUniformMask & type))
 				{
-					const UniformRegInfo* info = s_renderWgpu->m_uniformReg.find(name);
+					const UniformRegInfo* info = s_renderWgpu->m_uniformReg.find(nameHash);
 					BX_ASSERT(NULL != info, "User defined uniform '%s' is not found, it won't be set.", name);
 
 					const uint8_t reverseShift = kSpirvBindShift;
@@ -2592,7 +2595,7 @@ namespace bgfx { namespace webgpu
 				}
 				else
 				{
-					const UniformRegInfo* info = s_renderWgpu->m_uniformReg.find(name);
+					const UniformRegInfo* info = s_renderWgpu->m_uniformReg.find(nameHash);
 					BX_ASSERT(NULL != info, "User defined uniform '%s' is not found, it won't be set.", name);
 
 					const UniformSet::Enum freq = info->m_freq;
@@ -4465,6 +4468,11 @@ namespace bgfx { namespace webgpu
 				bool constantsChanged = false;
 				bool submitConstants = draw.m_uniformBegin < draw.m_uniformEnd;
 				bool groupChanged = draw.m_uniformGroup[UniformSet::Group] != currentGroup;
+				if (groupChanged)
+				{
+					rendererUpdateUniformGroup(this, draw.m_uniformGroup[UniformSet::Group]);
+				}
+
 				rendererUpdateUniforms(this, _render->m_submitUniforms[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
 				currentGroup = draw.m_uniformGroup[UniformSet::Group];
@@ -4567,6 +4575,7 @@ namespace bgfx { namespace webgpu
 					}
 
 					programChanged =
+					groupChanged =
 						constantsChanged = true;
 				}
 
@@ -4596,11 +4605,6 @@ namespace bgfx { namespace webgpu
 					if (programChanged)
 					{
 						commitConstants(*this, UniformSet::Frame);
-						constantsChanged = true;
-					}
-
-					if (programChanged)
-					{
 						commitConstants(*this, UniformSet::View);
 						constantsChanged = true;
 					}
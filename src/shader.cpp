@@ -271,6 +271,15 @@ namespace bgfx
 					uint16_t texFormat = 0;
 					bx::read(_reader, texFormat, _err);
 				}
+
+				if (!isShaderVerLess(magic, 12) )
+				{
+					uint32_t nameHash = 0;
+					bx::read(_reader, nameHash, _err);
+
+					uint8_t predefined = 0;
+					bx::read(_reader, predefined, _err);
+				}
 			}
 
 			uint32_t shaderSize;
@@ -6,6 +6,7 @@
 #include <bx/allocator.h>
 #include <bx/debug.h>
 #include <bx/math.h>
+#include <bx/simd_t.h>
 #include <bx/sort.h>
 #include <bx/uint32_t.h>
 
@@ -297,6 +298,8 @@ namespace bgfx
 	typedef float (*KeyFn)(float, float, float);
 	typedef float (*DistanceFn)(const float*, const void*, uint32_t, uint32_t);
 
+	// Computes keys for triangles [_begin, _num). Triangle ii is _order[ii] when previous
+	// order is given, otherwise ii. Triangle index is written to _values.
 	template<typename IndexT, DistanceFn dfn, KeyFn kfn, uint32_t xorBits>
 	inline void calcSortKeys(
 		  uint32_t* _keys
@@ -305,15 +308,17 @@ namespace bgfx
 		, const void* _vertices
 		, uint32_t _stride
 		, const IndexT* _indices
+		, const uint32_t* _order
+		, uint32_t _begin
 		, uint32_t _num
 		)
 	{
-		for (uint32_t ii = 0; ii < _num; ++ii)
+		for (uint32_t ii = _begin; ii < _num; ++ii)
 		{
-			const uint32_t idx0 = _indices[0];
-			const uint32_t idx1 = _indices[1];
-			const uint32_t idx2 = _indices[2];
-			_indices += 3;
+			const uint32_t face = NULL == _order ? ii : _order[ii];
+			const uint32_t idx0 = _indices[face*3+0];
+			const uint32_t idx1 = _indices[face*3+1];
+			const uint32_t idx2 = _indices[face*3+2];
 
 			float distance0 = dfn(_dirOrPos, _vertices, _stride, idx0);
 			float distance1 = dfn(_dirOrPos, _vertices, _stride, idx1);
@@ -321,8 +326,147 @@ namespace bgfx
 
 			uint32_t ui = bx::floatToBits(kfn(distance0, distance1, distance2) );
 			_keys[ii]   = bx::floatFlip(ui) ^ xorBits;
-			_values[ii] = ii;
+			_values[ii] = face;
+		}
+	}
+
+	struct SortKey
+	{
+		enum Enum
+		{
+			Min,
+			Avg,
+			Max,
+		};
+	};
+
+	// Same as calcSortKeys for 4 triangles at the time. Vertex positions are gathered into
+	// SoA registers, distance and key reduction are computed with the same operations in the
+	// same order as scalar version. Returns number of processed triangles, the rest must be
+	// processed with scalar version.
+	template<typename IndexT, bool DistanceT, SortKey::Enum KeyT, uint32_t xorBits>
+	inline uint32_t calcSortKeysSimd(
+		  uint32_t* _keys
+		, uint32_t* _values
+		, const float _dirOrPos[3]
+		, const void* _vertices
+		, uint32_t _stride
+		, const IndexT* _indices
+		, const uint32_t* _order
+		, uint32_t _num
+		)
+	{
+		using namespace bx;
+
+		const simd128_t dirOrPosX = simd_splat<simd128_t>(_dirOrPos[0]);
+		const simd128_t dirOrPosY = simd_splat<simd128_t>(_dirOrPos[1]);
+		const simd128_t dirOrPosZ = simd_splat<simd128_t>(_dirOrPos[2]);
+		const simd128_t third     = simd_splat<simd128_t>(3.0f);
+
+		BX_ALIGN_DECL_16(float key[4]);
+
+		const uint32_t num = _num & ~3;
+
+		for (uint32_t ii = 0; ii < num; ii += 4)
+		{
+			uint32_t face[4];
+			for (uint32_t jj = 0; jj < 4; ++jj)
+			{
+				face[jj] = NULL == _order ? ii+jj : _order[ii+jj];
+			}
+
+			simd128_t distance[3];
+
+			for (uint32_t corner = 0; corner < 3; ++corner)
+			{
+				const Vec3 v0 = vertexPos(_vertices, _stride, _indices[face[0]*3+corner]);
+				const Vec3 v1 = vertexPos(_vertices, _stride, _indices[face[1]*3+corner]);
+				const Vec3 v2 = vertexPos(_vertices, _stride, _indices[face[2]*3+corner]);
+				const Vec3 v3 = vertexPos(_vertices, _stride, _indices[face[3]*3+corner]);
+
+				const simd128_t xx = simd_ld<simd128_t>(v0.x, v1.x, v2.x, v3.x);
+				const simd128_t yy = simd_ld<simd128_t>(v0.y, v1.y, v2.y, v3.y);
+				const simd128_t zz = simd_ld<simd128_t>(v0.z, v1.z, v2.z, v3.z);
+
+				if (DistanceT)
+				{
+					const simd128_t dx = simd_sub(dirOrPosX, xx);
+					const simd128_t dy = simd_sub(dirOrPosY, yy);
+					const simd128_t dz = simd_sub(dirOrPosZ, zz);
+					distance[corner] = simd_sqrt(simd_add(simd_add(simd_mul(dx, dx), simd_mul(dy, dy) ), simd_mul(dz, dz) ) );
+				}
+				else
+				{
+					distance[corner] = simd_add(simd_add(simd_mul(xx, dirOrPosX), simd_mul(yy, dirOrPosY) ), simd_mul(zz, dirOrPosZ) );
+				}
+			}
+
+			const simd128_t result = SortKey::Min == KeyT ? simd_min(simd_min(distance[0], distance[1]), distance[2])
+				: SortKey::Avg == KeyT ? simd_div(simd_add(simd_add(distance[0], distance[1]), distance[2]), third)
+				:                        simd_max(simd_max(distance[0], distance[1]), distance[2])
+				;
+
+			simd_st(key, result);
+
+			for (uint32_t jj = 0; jj < 4; ++jj)
+			{
+				_keys[ii+jj]   = floatFlip(floatToBits(key[jj]) ) ^ xorBits;
+				_values[ii+jj] = face[jj];
+			}
+		}
+
+		return num;
+	}
+
+	template<typename IndexT, DistanceFn dfn, KeyFn kfn, bool DistanceT, SortKey::Enum KeyT, uint32_t xorBits>
+	inline void calcSortKeysFast(
+		  uint32_t* _keys
+		, uint32_t* _values
+		, const float _dirOrPos[3]
+		, const void* _vertices
+		, uint32_t _stride
+		, const IndexT* _indices
+		, const uint32_t* _order
+		, uint32_t _num
+		)
+	{
+		const uint32_t num = calcSortKeysSimd<IndexT, DistanceT, KeyT, xorBits>(_keys, _values, _dirOrPos, _vertices, _stride, _indices, _order, _num);
+		calcSortKeys<IndexT, dfn, kfn, xorBits>(_keys, _values, _dirOrPos, _vertices, _stride, _indices, _order, num, _num);
+	}
+
+	// Incremental sort gives up after this many element moves per triangle, at which point
+	// radix sort is cheaper.
+	static const uint32_t kSortMaxMovesPerTriangle = 4;
+
+	// Sorts nearly sorted keys in place. Returns false when move budget is exceeded, keys
+	// and values are left as valid, partially sorted, permutation.
+	static bool insertionSort(uint32_t* _keys, uint32_t* _values, uint32_t _num, uint32_t _maxMoves)
+	{
+		uint32_t moves = 0;
+
+		for (uint32_t ii = 1; ii < _num; ++ii)
+		{
+			const uint32_t key   = _keys[ii];
+			const uint32_t value = _values[ii];
+
+			uint32_t jj = ii;
+			for (; 0 < jj && _keys[jj-1] > key; --jj)
+			{
+				_keys[jj]   = _keys[jj-1];
+				_values[jj] = _values[jj-1];
+			}
+
+			_keys[jj]   = key;
+			_values[jj] = value;
+
+			moves += ii - jj;
+			if (moves > _maxMoves)
+			{
+				return false;
+			}
 		}
+
+		return true;
 	}
 
 	template<typename IndexT>
@@ -339,28 +483,36 @@ namespace bgfx
 		, const void* _vertices
 		, uint32_t    _stride
 		, const IndexT* _indices
+		, bool        _incremental
 		)
 	{
 		using namespace bx;
 
+		// In incremental mode _values holds previous order, keys are computed in that order.
+		const uint32_t* order = _incremental ? _values : NULL;
+
 		switch (_sort)
 		{
 		default:
-		case TopologySort::DirectionFrontToBackMin: calcSortKeys<IndexT, distanceDir, fmin3, 0         >(_keys, _values, _dir, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DirectionFrontToBackAvg: calcSortKeys<IndexT, distanceDir, favg3, 0         >(_keys, _values, _dir, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DirectionFrontToBackMax: calcSortKeys<IndexT, distanceDir, fmax3, 0         >(_keys, _values, _dir, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DirectionBackToFrontMin: calcSortKeys<IndexT, distanceDir, fmin3, UINT32_MAX>(_keys, _values, _dir, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DirectionBackToFrontAvg: calcSortKeys<IndexT, distanceDir, favg3, UINT32_MAX>(_keys, _values, _dir, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DirectionBackToFrontMax: calcSortKeys<IndexT, distanceDir, fmax3, UINT32_MAX>(_keys, _values, _dir, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DistanceFrontToBackMin:  calcSortKeys<IndexT, distancePos, fmin3, 0         >(_keys, _values, _pos, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DistanceFrontToBackAvg:  calcSortKeys<IndexT, distancePos, favg3, 0         >(_keys, _values, _pos, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DistanceFrontToBackMax:  calcSortKeys<IndexT, distancePos, fmax3, 0         >(_keys, _values, _pos, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DistanceBackToFrontMin:  calcSortKeys<IndexT, distancePos, fmin3, UINT32_MAX>(_keys, _values, _pos, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DistanceBackToFrontAvg:  calcSortKeys<IndexT, distancePos, favg3, UINT32_MAX>(_keys, _values, _pos, _vertices, _stride, _indices, _num); break;
-		case TopologySort::DistanceBackToFrontMax:  calcSortKeys<IndexT, distancePos, fmax3, UINT32_MAX>(_keys, _values, _pos, _vertices, _stride, _indices, _num); break;
+		case TopologySort::DirectionFrontToBackMin: calcSortKeysFast<IndexT, distanceDir, fmin3, false, SortKey::Min, 0         >(_keys, _values, _dir, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DirectionFrontToBackAvg: calcSortKeysFast<IndexT, distanceDir, favg3, false, SortKey::Avg, 0         >(_keys, _values, _dir, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DirectionFrontToBackMax: calcSortKeysFast<IndexT, distanceDir, fmax3, false, SortKey::Max, 0         >(_keys, _values, _dir, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DirectionBackToFrontMin: calcSortKeysFast<IndexT, distanceDir, fmin3, false, SortKey::Min, UINT32_MAX>(_keys, _values, _dir, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DirectionBackToFrontAvg: calcSortKeysFast<IndexT, distanceDir, favg3, false, SortKey::Avg, UINT32_MAX>(_keys, _values, _dir, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DirectionBackToFrontMax: calcSortKeysFast<IndexT, distanceDir, fmax3, false, SortKey::Max, UINT32_MAX>(_keys, _values, _dir, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DistanceFrontToBackMin:  calcSortKeysFast<IndexT, distancePos, fmin3, true,  SortKey::Min, 0         >(_keys, _values, _pos, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DistanceFrontToBackAvg:  calcSortKeysFast<IndexT, distancePos, favg3, true,  SortKey::Avg, 0         >(_keys, _values, _pos, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DistanceFrontToBackMax:  calcSortKeysFast<IndexT, distancePos, fmax3, true,  SortKey::Max, 0         >(_keys, _values, _pos, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DistanceBackToFrontMin:  calcSortKeysFast<IndexT, distancePos, fmin3, true,  SortKey::Min, UINT32_MAX>(_keys, _values, _pos, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DistanceBackToFrontAvg:  calcSortKeysFast<IndexT, distancePos, favg3, true,  SortKey::Avg, UINT32_MAX>(_keys, _values, _pos, _vertices, _stride, _indices, order, _num); break;
+		case TopologySort::DistanceBackToFrontMax:  calcSortKeysFast<IndexT, distancePos, fmax3, true,  SortKey::Max, UINT32_MAX>(_keys, _values, _pos, _vertices, _stride, _indices, order, _num); break;
 		}
 
-		radixSort(_keys, _tempKeys, _values, _tempValues, _num);
+		if (!_incremental
+		||  !insertionSort(_keys, _values, _num, _num*kSortMaxMovesPerTriangle) )
+		{
+			radixSort(_keys, _tempKeys, _values, _tempValues, _num);
+		}
 
 		IndexT* sorted = _dst;
 
@@ -378,31 +530,24 @@ namespace bgfx
 		}
 	}
 
-	void topologySortTriList(
+	static void topologySortTriList(
 		  TopologySort::Enum  _sort
 		, void*       _dst
-		, uint32_t    _dstSize
 		, const float _dir[3]
 		, const float _pos[3]
 		, const void* _vertices
 		, uint32_t    _stride
 		, const void* _indices
-		, uint32_t    _numIndices
 		, bool        _index32
-		, bx::AllocatorI* _allocator
+		, uint32_t*   _temp
+		, uint32_t    _num
+		, bool        _incremental
 		)
 	{
-		uint32_t indexSize = _index32
-			? sizeof(uint32_t)
-			: sizeof(uint16_t)
-			;
-		uint32_t  num  = bx::uint32_min(_numIndices*indexSize, _dstSize)/(indexSize*3);
-		uint32_t* temp = (uint32_t*)BX_ALLOC(_allocator, sizeof(uint32_t)*num*4);
-
-		uint32_t* keys       = &temp[num*0];
-		uint32_t* values     = &temp[num*1];
-		uint32_t* tempKeys   = &temp[num*2];
-		uint32_t* tempValues = &temp[num*3];
+		uint32_t* keys       = &_temp[_num*0];
+		uint32_t* values     = &_temp[_num*1];
+		uint32_t* tempKeys   = &_temp[_num*2];
+		uint32_t* tempValues = &_temp[_num*3];
 
 		if (_index32)
 		{
@@ -413,12 +558,13 @@ namespace bgfx
 					, values
 					, tempKeys
 					, tempValues
-					, num
+					, _num
 					, _dir
 					, _pos
 					, _vertices
 					, _stride
 					, (const uint32_t*)_indices
+					, _incremental
 					);
 		}
 		else
@@ -430,16 +576,79 @@ namespace bgfx
 					, values
 					, tempKeys
 					, tempValues
-					, num
+					, _num
 					, _dir
 					, _pos
 					, _vertices
 					, _stride
 					, (const uint16_t*)_indices
+					, _incremental
 					);
 		}
+	}
+
+	void topologySortTriList(
+		  TopologySort::Enum  _sort
+		, void*       _dst
+		, uint32_t    _dstSize
+		, const float _dir[3]
+		, const float _pos[3]
+		, const void* _vertices
+		, uint32_t    _stride
+		, const void* _indices
+		, uint32_t    _numIndices
+		, bool        _index32
+		, bx::AllocatorI* _allocator
+		)
+	{
+		uint32_t indexSize = _index32
+			? sizeof(uint32_t)
+			: sizeof(uint16_t)
+			;
+		uint32_t  num  = bx::uint32_min(_numIndices*indexSize, _dstSize)/(indexSize*3);
+		uint32_t* temp = (uint32_t*)BX_ALLOC(_allocator, sizeof(uint32_t)*num*4);
+
+		topologySortTriList(_sort, _dst, _dir, _pos, _vertices, _stride, _indices, _index32, temp, num, false);
 
 		BX_FREE(_allocator, temp);
 	}
 
+	void topologySortTriList(
+		  TopologySort::Enum  _sort
+		, void*       _dst
+		, uint32_t    _dstSize
+		, const float _dir[3]
+		, const float _pos[3]
+		, const void* _vertices
+		, uint32_t    _stride
+		, const void* _indices
+		, uint32_t    _numIndices
+		, bool        _index32
+		, TopologySortScratch& _scratch
+		, bx::AllocatorI* _allocator
+		)
+	{
+		uint32_t indexSize = _index32
+			? sizeof(uint32_t)
+			: sizeof(uint16_t)
+			;
+		uint32_t num = bx::uint32_min(_numIndices*indexSize, _dstSize)/(indexSize*3);
+
+		if (_scratch.size < sizeof(uint32_t)*num*4)
+		{
+			BX_TRACE("Topology sort scratch is too small (%d, required %d).", _scratch.size, uint32_t(sizeof(uint32_t)*num*4) );
+			_scratch.num = 0;
+			topologySortTriList(_sort, _dst, _dstSize, _dir, _pos, _vertices, _stride, _indices, _numIndices, _index32, _allocator);
+			return;
+		}
+
+		topologySortTriList(_sort, _dst, _dir, _pos, _vertices, _stride, _indices, _index32, (uint32_t*)_scratch.data, num, num == _scratch.num);
+		_scratch.num = num;
+	}
+
+	uint32_t topologySortScratchSize(uint32_t _numIndices)
+	{
+		return sizeof(uint32_t)*(_numIndices/3)*4;
+	}
+
 } //namespace bgfx
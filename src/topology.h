@@ -51,6 +51,25 @@ namespace bgfx
 		, bx::AllocatorI* _allocator
 		);
 
+	///
+	void topologySortTriList(
+		  TopologySort::Enum _sort
+		, void* _dst
+		, uint32_t _dstSize
+		, const float _dir[3]
+		, const float _pos[3]
+		, const void* _vertices
+		, uint32_t _stride
+		, const void* _indices
+		, uint32_t _numIndices
+		, bool _index32
+		, TopologySortScratch& _scratch
+		, bx::AllocatorI* _allocator
+		);
+
+	///
+	uint32_t topologySortScratchSize(uint32_t _numIndices);
+
 } // namespace bgfx
 
 #endif // BGFX_TOPOLOGY_H_HEADER_GUARD
@@ -5,9 +5,12 @@
 
 #include <bx/debug.h>
 #include <bx/hash.h>
+#include <bx/math.h>
 #include <bx/readerwriter.h>
+#include <bx/simd_t.h>
 #include <bx/sort.h>
 #include <bx/string.h>
+#include <bx/thread.h>
 #include <bx/uint32_t.h>
 
 #include "vertexlayout.h"
@@ -620,6 +623,216 @@ namespace bgfx
 		}
 	}
 
+	/// Number of vertices converted per strip by vertexConvert. Unpacked strip
+	/// is stored on stack as float4 per vertex.
+	static constexpr uint32_t kConvertStripSize = 64;
+
+	typedef void (*UnpackStripFn)(float* _output, const uint8_t* _data, uint32_t _stride, uint32_t _num);
+	typedef void (*PackStripFn)(uint8_t* _data, uint32_t _stride, float* _input, uint32_t _num);
+
+	// Strip kernels match vertexUnpack/vertexPack (with normalized input) bit for bit.
+	// Integer to float scale/bias is done 4-wide, one vertex per SIMD register.
+
+	static void unpackStripScale(float* _output, uint32_t _num, float _bias, float _scale)
+	{
+		using namespace bx;
+
+		const simd128_t bias  = simd_splat<simd128_t>(_bias);
+		const simd128_t scale = simd_splat<simd128_t>(_scale);
+
+		for (uint32_t ii = 0; ii < _num; ++ii, _output += 4)
+		{
+			const simd128_t value = simd_ld<simd128_t>(_output);
+			simd_st(_output, simd_div(simd_sub(value, bias), scale) );
+		}
+	}
+
+	static void packStripScale(float* _input, uint32_t _num, float _scale, float _bias)
+	{
+		using namespace bx;
+
+		const simd128_t scale = simd_splat<simd128_t>(_scale);
+		const simd128_t bias  = simd_splat<simd128_t>(_bias);
+
+		for (uint32_t ii = 0; ii < _num; ++ii, _input += 4)
+		{
+			const simd128_t value = simd_ld<simd128_t>(_input);
+			simd_st(_input, simd_add(simd_mul(value, scale), bias) );
+		}
+	}
+
+	// Unused components are widened to bias value, so that they end up as 0.0f
+	// after unpackStripScale.
+	template<typename Ty, uint8_t NumT>
+	static void unpackStripWiden(float* _output, const uint8_t* _data, uint32_t _stride, uint32_t _num, float _bias)
+	{
+		for (uint32_t ii = 0; ii < _num; ++ii, _data += _stride, _output += 4)
+		{
+			const Ty* packed = (const Ty*)_data;
+			_output[0] =            float(packed[0]);
+			_output[1] = 1 < NumT ? float(packed[1]) : _bias;
+			_output[2] = 2 < NumT ? float(packed[2]) : _bias;
+			_output[3] = 3 < NumT ? float(packed[3]) : _bias;
+		}
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void unpackStripUint8(float* _output, const uint8_t* _data, uint32_t _stride, uint32_t _num)
+	{
+		const float bias  = AsIntT ? 128.0f : 0.0f;
+		const float scale = AsIntT ? 127.0f : 255.0f;
+		unpackStripWiden<uint8_t, NumT>(_output, _data, _stride, _num, bias);
+		unpackStripScale(_output, _num, bias, scale);
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void unpackStripUint10(float* _output, const uint8_t* _data, uint32_t _stride, uint32_t _num)
+	{
+		const float bias  = AsIntT ? 512.0f : 0.0f;
+		const float scale = AsIntT ? 511.0f : 1023.0f;
+
+		float* output = _output;
+		for (uint32_t ii = 0; ii < _num; ++ii, _data += _stride, output += 4)
+		{
+			const uint32_t packed = *(const uint32_t*)_data;
+			output[0] =            float( (packed      ) & 0x3ff);
+			output[1] = 1 < NumT ? float( (packed >> 10) & 0x3ff) : bias;
+			output[2] = 2 < NumT ? float( (packed >> 20) & 0x3ff) : bias;
+			output[3] = bias;
+		}
+
+		unpackStripScale(_output, _num, bias, scale);
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void unpackStripInt16(float* _output, const uint8_t* _data, uint32_t _stride, uint32_t _num)
+	{
+		const float bias  = AsIntT ? 0.0f     : -32768.0f;
+		const float scale = AsIntT ? 32767.0f :  65535.0f;
+		unpackStripWiden<int16_t, NumT>(_output, _data, _stride, _num, bias);
+		unpackStripScale(_output, _num, bias, scale);
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void unpackStripHalf(float* _output, const uint8_t* _data, uint32_t _stride, uint32_t _num)
+	{
+		for (uint32_t ii = 0; ii < _num; ++ii, _data += _stride, _output += 4)
+		{
+			const uint16_t* packed = (const uint16_t*)_data;
+			_output[0] =            bx::halfToFloat(packed[0]);
+			_output[1] = 1 < NumT ? bx::halfToFloat(packed[1]) : 0.0f;
+			_output[2] = 2 < NumT ? bx::halfToFloat(packed[2]) : 0.0f;
+			_output[3] = 3 < NumT ? bx::halfToFloat(packed[3]) : 0.0f;
+		}
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void unpackStripFloat(float* _output, const uint8_t* _data, uint32_t _stride, uint32_t _num)
+	{
+		for (uint32_t ii = 0; ii < _num; ++ii, _data += _stride, _output += 4)
+		{
+			const float* packed = (const float*)_data;
+			_output[0] =            packed[0];
+			_output[1] = 1 < NumT ? packed[1] : 0.0f;
+			_output[2] = 2 < NumT ? packed[2] : 0.0f;
+			_output[3] = 3 < NumT ? packed[3] : 0.0f;
+		}
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void packStripUint8(uint8_t* _data, uint32_t _stride, float* _input, uint32_t _num)
+	{
+		packStripScale(_input, _num, AsIntT ? 127.0f : 255.0f, AsIntT ? 128.0f : 0.0f);
+
+		for (uint32_t ii = 0; ii < _num; ++ii, _data += _stride, _input += 4)
+		{
+			uint8_t* packed = (uint8_t*)_data;
+			                 packed[0] = uint8_t(_input[0]);
+			if (1 < NumT) {  packed[1] = uint8_t(_input[1]); }
+			if (2 < NumT) {  packed[2] = uint8_t(_input[2]); }
+			if (3 < NumT) {  packed[3] = uint8_t(_input[3]); }
+		}
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void packStripUint10(uint8_t* _data, uint32_t _stride, float* _input, uint32_t _num)
+	{
+		packStripScale(_input, _num, AsIntT ? 511.0f : 1023.0f, AsIntT ? 512.0f : 0.0f);
+
+		for (uint32_t ii = 0; ii < _num; ++ii, _data += _stride, _input += 4)
+		{
+			uint32_t packed = uint32_t(_input[0]);
+			if (1 < NumT) { packed <<= 10; packed |= uint32_t(_input[1]); }
+			if (2 < NumT) { packed <<= 10; packed |= uint32_t(_input[2]); }
+			*(uint32_t*)_data = packed;
+		}
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void packStripInt16(uint8_t* _data, uint32_t _stride, float* _input, uint32_t _num)
+	{
+		packStripScale(_input, _num, AsIntT ? 32767.0f : 65535.0f, AsIntT ? 0.0f : -32768.0f);
+
+		for (uint32_t ii = 0; ii < _num; ++ii, _data += _stride, _input += 4)
+		{
+			int16_t* packed = (int16_t*)_data;
+			                 packed[0] = int16_t(_input[0]);
+			if (1 < NumT) {  packed[1] = int16_t(_input[1]); }
+			if (2 < NumT) {  packed[2] = int16_t(_input[2]); }
+			if (3 < NumT) {  packed[3] = int16_t(_input[3]); }
+		}
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void packStripHalf(uint8_t* _data, uint32_t _stride, float* _input, uint32_t _num)
+	{
+		for (uint32_t ii = 0; ii < _num; ++ii, _data += _stride, _input += 4)
+		{
+			uint16_t* packed = (uint16_t*)_data;
+			                 packed[0] = bx::halfFromFloat(_input[0]);
+			if (1 < NumT) {  packed[1] = bx::halfFromFloat(_input[1]); }
+			if (2 < NumT) {  packed[2] = bx::halfFromFloat(_input[2]); }
+			if (3 < NumT) {  packed[3] = bx::halfFromFloat(_input[3]); }
+		}
+	}
+
+	template<uint8_t NumT, bool AsIntT>
+	static void packStripFloat(uint8_t* _data, uint32_t _stride, float* _input, uint32_t _num)
+	{
+		for (uint32_t ii = 0; ii < _num; ++ii, _data += _stride, _input += 4)
+		{
+			bx::memCopy(_data, _input, NumT*sizeof(float) );
+		}
+	}
+
+#define BGFX_STRIP_KERNEL(_name)                                         \
+	{                                                                    \
+		{ _name<1, false>, _name<2, false>, _name<3, false>, _name<4, false> }, \
+		{ _name<1, true>,  _name<2, true>,  _name<3, true>,  _name<4, true>  }, \
+	}
+
+	static const UnpackStripFn s_unpackStrip[AttribType::Count][2][4] =
+	{
+		BGFX_STRIP_KERNEL(unpackStripUint8),
+		BGFX_STRIP_KERNEL(unpackStripUint10),
+		BGFX_STRIP_KERNEL(unpackStripInt16),
+		BGFX_STRIP_KERNEL(unpackStripHalf),
+		BGFX_STRIP_KERNEL(unpackStripFloat),
+	};
+	BX_STATIC_ASSERT(BX_COUNTOF(s_unpackStrip) == AttribType::Count);
+
+	static const PackStripFn s_packStrip[AttribType::Count][2][4] =
+	{
+		BGFX_STRIP_KERNEL(packStripUint8),
+		BGFX_STRIP_KERNEL(packStripUint10),
+		BGFX_STRIP_KERNEL(packStripInt16),
+		BGFX_STRIP_KERNEL(packStripHalf),
+		BGFX_STRIP_KERNEL(packStripFloat),
+	};
+	BX_STATIC_ASSERT(BX_COUNTOF(s_packStrip) == AttribType::Count);
+
+#undef BGFX_STRIP_KERNEL
+
 	void vertexConvert(const VertexLayout& _destLayout, void* _destData, const VertexLayout& _srcLayout, const void* _srcData, uint32_t _num)
 	{
 		if (_destLayout.m_hash == _srcLayout.m_hash)
@@ -642,6 +855,8 @@ namespace bgfx
 			uint32_t src;
 			uint32_t dest;
 			uint32_t size;
+			UnpackStripFn unpack;
+			PackStripFn pack;
 		};
 
 		ConvertOp convertOp[Attrib::Count];
@@ -668,6 +883,14 @@ namespace bgfx
 				{
 					cop.src = _srcLayout.getOffset(attr);
 					cop.op = _destLayout.m_attributes[attr] == _srcLayout.m_attributes[attr] ? ConvertOp::Copy : ConvertOp::Convert;
+
+					if (ConvertOp::Convert == cop.op)
+					{
+						cop.pack = s_packStrip[type][asInt][num-1];
+
+						_srcLayout.decode(attr, num, type, normalized, asInt);
+						cop.unpack = s_unpackStrip[type][asInt][num-1];
+					}
 				}
 				else
 				{
@@ -680,16 +903,18 @@ namespace bgfx
 
 		if (0 < numOps)
 		{
-			const uint8_t* src = (const uint8_t*)_srcData;
-			uint32_t srcStride = _srcLayout.getStride();
+			const uint32_t srcStride  = _srcLayout.getStride();
+			const uint32_t destStride = _destLayout.getStride();
 
-			uint8_t* dest = (uint8_t*)_destData;
-			uint32_t destStride = _destLayout.getStride();
+			BX_ALIGN_DECL_16(float) unpacked[kConvertStripSize*4];
 
-			float unpacked[4];
-
-			for (uint32_t ii = 0; ii < _num; ++ii)
+			for (uint32_t ii = 0; ii < _num; ii += kConvertStripSize)
 			{
+				const uint32_t num = bx::min(kConvertStripSize, _num-ii);
+
+				const uint8_t* src  = (const uint8_t*)_srcData + ii*srcStride;
+				      uint8_t* dest = (uint8_t*)_destData + ii*destStride;
+
 				for (uint32_t jj = 0; jj < numOps; ++jj)
 				{
 					const ConvertOp& cop = convertOp[jj];
@@ -697,22 +922,25 @@ namespace bgfx
 					switch (cop.op)
 					{
 					case ConvertOp::Set:
-						bx::memSet(dest + cop.dest, 0, cop.size);
+						for (uint32_t kk = 0; kk < num; ++kk)
+						{
+							bx::memSet(dest + kk*destStride + cop.dest, 0, cop.size);
+						}
 						break;
 
 					case ConvertOp::Copy:
-						bx::memCopy(dest + cop.dest, src + cop.src, cop.size);
+						for (uint32_t kk = 0; kk < num; ++kk)
+						{
+							bx::memCopy(dest + kk*destStride + cop.dest, src + kk*srcStride + cop.src, cop.size);
+						}
 						break;
 
 					case ConvertOp::Convert:
-						vertexUnpack(unpacked, cop.attr, _srcLayout, src);
-						vertexPack(unpacked, true, cop.attr, _destLayout, dest);
+						cop.unpack(unpacked, src + cop.src, srcStride, num);
+						cop.pack(dest + cop.dest, destStride, unpacked, num);
 						break;
 					}
 				}
-
-				src += srcStride;
-				dest += destStride;
 			}
 		}
 	}
@@ -767,62 +995,263 @@ namespace bgfx
 		return IndexT(numVertices);
 	}
 
+	/// Vertices per thread below which weldVertices doesn't bother spawning threads.
+	static constexpr uint32_t kWeldMinVerticesPerThread = 32<<10;
+
+	/// Maximum number of threads used by weldVertices.
+	static constexpr uint32_t kWeldMaxThreads = 4;
+
+	struct WeldPrepare
+	{
+		const VertexLayout* srcLayout;
+		const void*         srcData;
+		const VertexLayout* layout;
+		void*               data;
+		int32_t*            cell;
+		float               invCellSize;
+		uint32_t            begin;
+		uint32_t            end;
+	};
+
+	// Converts range of vertices into float layout, and quantizes position into
+	// grid cell with size of epsilon.
+	static void weldPrepare(const WeldPrepare& _prepare)
+	{
+		const uint32_t srcStride = _prepare.srcLayout->getStride();
+		const uint32_t stride    = _prepare.layout->getStride();
+
+		uint8_t* data = (uint8_t*)_prepare.data + _prepare.begin*stride;
+
+		vertexConvert(
+			  *_prepare.layout
+			, data
+			, *_prepare.srcLayout
+			, (const uint8_t*)_prepare.srcData + _prepare.begin*srcStride
+			, _prepare.end - _prepare.begin
+			);
+
+		int32_t* cell = _prepare.cell + _prepare.begin*3;
+
+		for (uint32_t ii = _prepare.begin; ii < _prepare.end; ++ii, data += stride, cell += 3)
+		{
+			const float* pos = (const float*)data;
+			cell[0] = int32_t(bx::clamp(bx::floor(pos[0]*_prepare.invCellSize), -1073741824.0f, 1073741824.0f) );
+			cell[1] = int32_t(bx::clamp(bx::floor(pos[1]*_prepare.invCellSize), -1073741824.0f, 1073741824.0f) );
+			cell[2] = int32_t(bx::clamp(bx::floor(pos[2]*_prepare.invCellSize), -1073741824.0f, 1073741824.0f) );
+		}
+	}
+
+#if BX_CONFIG_SUPPORTS_THREADING
+	static int32_t weldPrepareThread(bx::Thread* _self, void* _userData)
+	{
+		BX_UNUSED(_self);
+		weldPrepare(*(const WeldPrepare*)_userData);
+		return bx::kExitSuccess;
+	}
+#endif // BX_CONFIG_SUPPORTS_THREADING
+
+	inline uint32_t weldCellHash(int32_t _x, int32_t _y, int32_t _z)
+	{
+		return uint32_t(_x)*73856093u ^ uint32_t(_y)*19349663u ^ uint32_t(_z)*83492791u;
+	}
+
 	template<typename IndexT>
-	static IndexT weldVertices(IndexT* _output, const VertexLayout& _layout, const void* _data, uint32_t _num, float _epsilon, bx::AllocatorI* _allocator)
+	static IndexT weldVertices(IndexT* _output, const VertexLayout& _layout, const void* _data, uint32_t _num, float _epsilon, const float* _attribEpsilon, bx::AllocatorI* _allocator)
 	{
-		const uint32_t hashSize = bx::uint32_nextpow2(_num);
-		const uint32_t hashMask = hashSize-1;
-		const float epsilonSq = _epsilon*_epsilon;
+		if (0.0f >= _epsilon
+		||  !_layout.has(Attrib::Position) )
+		{
+			for (uint32_t ii = 0; ii < _num; ++ii)
+			{
+				_output[ii] = IndexT(ii);
+			}
 
-		uint32_t numVertices = 0;
+			return IndexT(_num);
+		}
+
+		// Position and all attributes compared within tolerance are converted to float once,
+		// so that comparison doesn't need to unpack vertices on every hash chain step.
+		uint32_t numAttribs = 0;
+		uint8_t  attribOffset[Attrib::Count];
+		uint8_t  attribNum[Attrib::Count];
+		float    attribEpsilonSq[Attrib::Count];
+
+		VertexLayout layout;
+		layout.begin();
+		layout.add(Attrib::Position, 3, AttribType::Float);
+
+		if (NULL != _attribEpsilon)
+		{
+			for (uint32_t ii = 0; ii < Attrib::Count; ++ii)
+			{
+				const Attrib::Enum attr = Attrib::Enum(ii);
+
+				if (Attrib::Position != attr
+				&&  0.0f <= _attribEpsilon[ii]
+				&&  _layout.has(attr) )
+				{
+					uint8_t num;
+					AttribType::Enum type;
+					bool normalized;
+					bool asInt;
+					_layout.decode(attr, num, type, normalized, asInt);
+					layout.add(attr, num, AttribType::Float);
+
+					attribOffset[numAttribs]    = uint8_t(layout.getOffset(attr)/sizeof(float) );
+					attribNum[numAttribs]       = num;
+					attribEpsilonSq[numAttribs] = _attribEpsilon[ii]*_attribEpsilon[ii];
+					++numAttribs;
+				}
+			}
+		}
+
+		layout.end();
+
+		const uint32_t stride    = layout.getStride()/sizeof(float);
+		const uint32_t hashSize  = bx::uint32_nextpow2(_num);
+		const uint32_t hashMask  = hashSize-1;
+		const float    epsilonSq = _epsilon*_epsilon;
+
+		const uint32_t size = 0
+			+ layout.getSize(_num)
+			+ sizeof(int32_t)*3*_num
+			+ sizeof(uint32_t)*(hashSize + _num)
+			;
+		uint8_t* mem = (uint8_t*)BX_ALLOC(_allocator, size);
+
+		float*    data      = (float*)mem;
+		int32_t*  cell      = (int32_t*)(mem + layout.getSize(_num) );
+		uint32_t* hashTable = (uint32_t*)(cell + 3*_num);
+		uint32_t* next      = hashTable + hashSize;
 
-		const uint32_t size = sizeof(IndexT)*(hashSize + _num);
-		IndexT* hashTable = (IndexT*)BX_ALLOC(_allocator, size);
-		bx::memSet(hashTable, 0xff, size);
+		bx::memSet(hashTable, 0xff, sizeof(uint32_t)*hashSize);
 
-		IndexT* next = hashTable + hashSize;
+		WeldPrepare prepare[kWeldMaxThreads];
+
+		const uint32_t numThreads = bx::clamp<uint32_t>(_num/kWeldMinVerticesPerThread, 1, kWeldMaxThreads);
+
+		for (uint32_t ii = 0; ii < numThreads; ++ii)
+		{
+			WeldPrepare& wp = prepare[ii];
+			wp.srcLayout   = &_layout;
+			wp.srcData     = _data;
+			wp.layout      = &layout;
+			wp.data        = data;
+			wp.cell        = cell;
+			wp.invCellSize = 1.0f/_epsilon;
+			wp.begin       = uint32_t(uint64_t(_num)* ii   /numThreads);
+			wp.end         = uint32_t(uint64_t(_num)*(ii+1)/numThreads);
+		}
+
+#if BX_CONFIG_SUPPORTS_THREADING
+		bx::Thread thread[kWeldMaxThreads-1];
+
+		for (uint32_t ii = 1; ii < numThreads; ++ii)
+		{
+			if (!thread[ii-1].init(weldPrepareThread, &prepare[ii], 0, "bgfx - weld") )
+			{
+				weldPrepare(prepare[ii]);
+			}
+		}
+
+		weldPrepare(prepare[0]);
+
+		for (uint32_t ii = 1; ii < numThreads; ++ii)
+		{
+			if (thread[ii-1].isRunning() )
+			{
+				thread[ii-1].shutdown();
+			}
+		}
+#else
+		for (uint32_t ii = 0; ii < numThreads; ++ii)
+		{
+			weldPrepare(prepare[ii]);
+		}
+#endif // BX_CONFIG_SUPPORTS_THREADING
+
+		// Matching vertex is within epsilon, which means it's in the same or neighbouring cell.
+		// Picking lowest index of all matches gives the same result as brute force welding.
+		uint32_t numVertices = 0;
 
 		for (uint32_t ii = 0; ii < _num; ++ii)
 		{
-			float pos[4];
-			vertexUnpack(pos, Attrib::Position, _layout, _data, ii);
-			uint32_t hashValue = bx::hash<bx::HashMurmur2A>(pos, 3*sizeof(float) ) & hashMask;
+			const float*   vertex = data + ii*stride;
+			const int32_t* xyz    = cell + ii*3;
+
+			uint32_t match = UINT32_MAX;
 
-			IndexT offset = hashTable[hashValue];
-			for (; IndexT(-1) != offset; offset = next[offset])
+			for (int32_t zz = -1; zz <= 1; ++zz)
+			for (int32_t yy = -1; yy <= 1; ++yy)
+			for (int32_t xx = -1; xx <= 1; ++xx)
 			{
-				float test[4];
-				vertexUnpack(test, Attrib::Position, _layout, _data, _output[offset]);
+				const uint32_t hashValue = weldCellHash(xyz[0]+xx, xyz[1]+yy, xyz[2]+zz) & hashMask;
 
-				if (sqLength(test, pos) < epsilonSq)
+				for (uint32_t offset = hashTable[hashValue]; UINT32_MAX != offset; offset = next[offset])
 				{
-					_output[ii] = _output[offset];
-					break;
+					if (offset > match)
+					{
+						continue;
+					}
+
+					const float* test = data + offset*stride;
+
+					if (sqLength(test, vertex) >= epsilonSq)
+					{
+						continue;
+					}
+
+					bool equal = true;
+
+					for (uint32_t jj = 0; jj < numAttribs && equal; ++jj)
+					{
+						const uint32_t attrOffset = attribOffset[jj];
+
+						float distSq = 0.0f;
+						for (uint32_t kk = 0, num = attribNum[jj]; kk < num; ++kk)
+						{
+							const float diff = test[attrOffset+kk] - vertex[attrOffset+kk];
+							distSq += diff*diff;
+						}
+
+						equal = distSq <= attribEpsilonSq[jj];
+					}
+
+					if (equal)
+					{
+						match = offset;
+					}
 				}
 			}
 
-			if (IndexT(-1) == offset)
+			if (UINT32_MAX == match)
 			{
+				const uint32_t hashValue = weldCellHash(xyz[0], xyz[1], xyz[2]) & hashMask;
+
 				_output[ii] = IndexT(ii);
 				next[ii] = hashTable[hashValue];
-				hashTable[hashValue] = IndexT(ii);
+				hashTable[hashValue] = ii;
 				numVertices++;
 			}
+			else
+			{
+				_output[ii] = IndexT(match);
+			}
 		}
 
-		BX_FREE(_allocator, hashTable);
+		BX_FREE(_allocator, mem);
 
 		return IndexT(numVertices);
 	}
 
-	uint32_t weldVertices(void* _output, const VertexLayout& _layout, const void* _data, uint32_t _num, bool _index32, float _epsilon, bx::AllocatorI* _allocator)
+	uint32_t weldVertices(void* _output, const VertexLayout& _layout, const void* _data, uint32_t _num, bool _index32, float _epsilon, bx::AllocatorI* _allocator, const float* _attribEpsilon)
 	{
 		if (_index32)
 		{
-			return weldVertices( (uint32_t*)_output, _layout, _data, _num, _epsilon, _allocator);
+			return weldVertices( (uint32_t*)_output, _layout, _data, _num, _epsilon, _attribEpsilon, _allocator);
 		}
 
-		return weldVertices( (uint16_t*)_output, _layout, _data, _num, _epsilon, _allocator);
+		return weldVertices( (uint16_t*)_output, _layout, _data, _num, _epsilon, _attribEpsilon, _allocator);
 	}
 
 } // namespace bgfx
@@ -35,8 +35,11 @@ namespace bgfx
 	///
 	int32_t read(bx::ReaderI* _reader, bgfx::VertexLayout& _layout, bx::Error* _err = NULL);
 
-	///
-	uint32_t weldVertices(void* _output, const VertexLayout& _layout, const void* _data, uint32_t _num, bool _index32, float _epsilon, bx::AllocatorI* _allocator);
+	/// Weld vertices within _epsilon position distance. When _attribEpsilon is not NULL it
+	/// must point to Attrib::Count tolerances, and attributes with non-negative tolerance
+	/// must also be within tolerance (inclusive) for vertices to be welded. Tolerance 0 requires
+	/// exact match, negative tolerance ignores attribute.
+	uint32_t weldVertices(void* _output, const VertexLayout& _layout, const void* _data, uint32_t _num, bool _index32, float _epsilon, bx::AllocatorI* _allocator, const float* _attribEpsilon = NULL);
 
 } // namespace bgfx
 
@@ -0,0 +1,941 @@
+/*
+ * Copyright 2011-2021 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx#license-bsd-2-clause
+ */
+
+#include <bx/bx.h>
+#include <bx/commandline.h>
+#include <bx/hash.h>
+#include <bx/math.h>
+#include <bx/readerwriter.h>
+#include <bx/rng.h>
+#include <bx/string.h>
+#include <bx/thread.h>
+#include <bx/timer.h>
+#include <bgfx/bgfx.h>
+
+#include "entry/entry.h"
+#include "bounds.h"
+#include "bvh.h"
+
+#include "../../src/shader.h"
+
+#define BGFX_BENCH_VERSION_MAJOR 1
+#define BGFX_BENCH_VERSION_MINOR 0
+
+bool checkInternals();
+
+namespace
+{
+
+struct Phase
+{
+	enum Enum
+	{
+		Transform,
+		Uniform,
+		Submit,
+
+		Count
+	};
+};
+
+struct PosVertex
+{
+	float m_x;
+	float m_y;
+	float m_z;
+};
+
+static const PosVertex s_triVertices[] =
+{
+	{ -1.0f, -1.0f, 0.0f },
+	{  1.0f, -1.0f, 0.0f },
+	{  0.0f,  1.0f, 0.0f },
+};
+
+static const uint16_t s_triIndices[] = { 0, 1, 2 };
+
+constexpr uint32_t kMaxThreads = 8;
+constexpr uint32_t kNumViews   = 4;
+
+static void writeUniform(bx::WriterI* _writer, const char* _name, bgfx::UniformType::Enum _type, uint8_t _num, uint16_t _regIndex, uint16_t _regCount)
+{
+	const uint8_t nameSize = uint8_t(bx::strLen(_name) );
+	bx::write(_writer, nameSize);
+	bx::write(_writer, _name, nameSize);
+	bx::write(_writer, uint8_t(_type) );
+	bx::write(_writer, _num);
+	bx::write(_writer, _regIndex);
+	bx::write(_writer, _regCount);
+}
+
+// Minimal shader binary, header and uniform table only. It's enough for noop
+// renderer to build constant buffers and replay uniform commits.
+static bgfx::ShaderHandle createBenchShader(char _type)
+{
+	uint8_t data[256];
+	bx::StaticMemoryBlockWriter writer(data, sizeof(data) );
+
+	bx::write(&writer, uint32_t(BX_MAKEFOURCC(_type, 'S', 'H', 5) ) );
+	bx::write(&writer, uint32_t(0xbe4c0001) ); // Same hash for in/out, so shaders link.
+	bx::write(&writer, uint16_t(2) );
+	writeUniform(&writer, "u_modelViewProj", bgfx::UniformType::Mat4, 1,  0, 4);
+	writeUniform(&writer, "u_bench",         bgfx::UniformType::Vec4, 4, 64, 4);
+	bx::write(&writer, uint32_t(0) );
+
+	return bgfx::createShader(bgfx::copy(data, uint32_t(bx::seek(&writer) ) ) );
+}
+
+// Shader binary with one predefined and _numUniforms user uniforms. Version 12 binary
+// stores name hash and predefined uniform enum per uniform, with older binaries runtime
+// computes them from uniform name.
+static const bgfx::Memory* createReflectionShaderMem(uint8_t _version, uint32_t _salt, uint32_t _numUniforms)
+{
+	uint8_t data[4<<10];
+	bx::StaticMemoryBlockWriter writer(data, sizeof(data) );
+
+	bx::write(&writer, uint32_t(BX_MAKEFOURCC('V', 'S', 'H', _version) ) );
+	bx::write(&writer, _salt); // Input/output hash, makes every shader binary unique.
+	bx::write(&writer, _salt);
+	bx::write(&writer, uint16_t(_numUniforms+1) );
+
+	for (uint32_t ii = 0; ii <= _numUniforms; ++ii)
+	{
+		char temp[32];
+		const char* name = "u_modelViewProj";
+		bgfx::PredefinedUniform::Enum predefined = bgfx::PredefinedUniform::ModelViewProj;
+
+		if (0 != ii)
+		{
+			bx::snprintf(temp, sizeof(temp), "u_reflect%d", ii-1);
+			name       = temp;
+			predefined = bgfx::PredefinedUniform::Count;
+		}
+
+		writeUniform(&writer
+			, name
+			, 0 == ii ? bgfx::UniformType::Mat4 : bgfx::UniformType::Vec4
+			, 1
+			, uint16_t(ii*4)
+			, 0 == ii ? 4 : 1
+			);
+		bx::write(&writer, uint16_t(0) ); // Texture component type and dimension.
+		bx::write(&writer, uint16_t(0) ); // Texture format.
+
+		if (12 <= _version)
+		{
+			bx::write(&writer, bx::hash<bx::HashMurmur2A>(name) );
+			bx::write(&writer, uint8_t(predefined) );
+		}
+	}
+
+	bx::write(&writer, uint32_t(0) );
+
+	return bgfx::copy(data, uint32_t(bx::seek(&writer) ) );
+}
+
+static void benchCreateShader(uint32_t _numShaders, uint32_t _numUniforms, uint32_t _numIterations)
+{
+	bx::AllocatorI* allocator = entry::getAllocator();
+
+	const bgfx::Memory** mem = (const bgfx::Memory**)BX_ALLOC(allocator, _numShaders*sizeof(bgfx::Memory*) );
+	bgfx::ShaderHandle* shaders = (bgfx::ShaderHandle*)BX_ALLOC(allocator, _numShaders*sizeof(bgfx::ShaderHandle) );
+
+	const double toMs = 1000.0/double(bx::getHPFrequency() );
+
+	bx::printf("version\tshaders\tuniforms\tcreate\tframe\tus/shader\n");
+
+	static const uint8_t s_version[] = { 11, 12 };
+
+	for (uint32_t vv = 0; vv < BX_COUNTOF(s_version); ++vv)
+	{
+		int64_t createTime = 0;
+		int64_t frameTime  = 0;
+
+		for (uint32_t jj = 0; jj < _numIterations; ++jj)
+		{
+			// Binaries are built up front, only createShader and command execution on
+			// render side are measured.
+			for (uint32_t ii = 0; ii < _numShaders; ++ii)
+			{
+				mem[ii] = createReflectionShaderMem(s_version[vv], (jj<<16) | ii, _numUniforms);
+			}
+
+			int64_t timeBegin = bx::getHPCounter();
+			for (uint32_t ii = 0; ii < _numShaders; ++ii)
+			{
+				shaders[ii] = bgfx::createShader(mem[ii]);
+			}
+			createTime += bx::getHPCounter() - timeBegin;
+
+			timeBegin = bx::getHPCounter();
+			bgfx::frame();
+			frameTime += bx::getHPCounter() - timeBegin;
+
+			for (uint32_t ii = 0; ii < _numShaders; ++ii)
+			{
+				bgfx::destroy(shaders[ii]);
+			}
+
+			// Destroyed handles are recycled once frame ring drains.
+			bgfx::frame();
+			bgfx::frame();
+		}
+
+		const double createMs = double(createTime)*toMs/double(_numIterations);
+		const double frameMs  = double(frameTime)*toMs/double(_numIterations);
+
+		bx::printf("%d\t%d\t%d\t%.3f\t%.3f\t%.3f\n"
+			, s_version[vv]
+			, _numShaders
+			, _numUniforms+1
+			, createMs
+			, frameMs
+			, (createMs+frameMs)*1000.0/double(_numShaders)
+			);
+	}
+
+	BX_FREE(allocator, shaders);
+	BX_FREE(allocator, mem);
+}
+
+struct Bench
+{
+	bgfx::ProgramHandle      m_program;
+	bgfx::VertexBufferHandle m_vbh;
+	bgfx::IndexBufferHandle  m_ibh;
+	bgfx::UniformHandle      m_uniform;
+
+	Phase::Enum m_phase;
+	uint32_t    m_numDraws;
+	uint32_t    m_numThreads;
+};
+
+struct Worker
+{
+	static int32_t threadFunc(bx::Thread* _thread, void* _userData);
+
+	void run()
+	{
+		const Bench& bench = *m_bench;
+		const uint32_t begin = bench.m_numDraws*m_idx/bench.m_numThreads;
+		const uint32_t end   = bench.m_numDraws*(m_idx+1)/bench.m_numThreads;
+
+		float mtx[16];
+		bx::mtxIdentity(mtx);
+
+		float value[16];
+		bx::memSet(value, 0, sizeof(value) );
+
+		bgfx::Encoder* encoder = bgfx::begin(true);
+		if (NULL == encoder)
+		{
+			return;
+		}
+
+		const int64_t timeBegin = bx::getHPCounter();
+
+		switch (bench.m_phase)
+		{
+		case Phase::Transform:
+			for (uint32_t ii = begin; ii < end; ++ii)
+			{
+				mtx[12] = float(ii);
+				encoder->setTransform(mtx);
+			}
+			encoder->discard();
+			break;
+
+		case Phase::Uniform:
+			for (uint32_t ii = begin; ii < end; ++ii)
+			{
+				value[0] = float(ii);
+				encoder->setUniform(bench.m_uniform, value, 4);
+			}
+			encoder->discard();
+			break;
+
+		default:
+			for (uint32_t ii = begin; ii < end; ++ii)
+			{
+				mtx[12]  = float(ii);
+				value[0] = float(ii);
+
+				encoder->setTransform(mtx);
+				encoder->setUniform(bench.m_uniform, value, 4);
+				encoder->setVertexBuffer(0, bench.m_vbh);
+				encoder->setIndexBuffer(bench.m_ibh);
+				encoder->setState(0 == (ii&1) ? BGFX_STATE_DEFAULT : BGFX_STATE_DEFAULT|BGFX_STATE_BLEND_ALPHA);
+				encoder->submit(bgfx::ViewId(ii%kNumViews), bench.m_program, bx::hash<bx::HashMurmur2A>(ii) );
+			}
+			break;
+		}
+
+		m_elapsed += bx::getHPCounter() - timeBegin;
+		m_calls   += end - begin;
+
+		bgfx::end(encoder);
+	}
+
+	Bench*        m_bench;
+	bx::Thread    m_thread;
+	bx::Semaphore m_start;
+	bx::Semaphore m_done;
+	int64_t       m_elapsed;
+	uint32_t      m_calls;
+	uint32_t      m_idx;
+	bool          m_exit;
+};
+
+int32_t Worker::threadFunc(bx::Thread* _thread, void* _userData)
+{
+	BX_UNUSED(_thread);
+
+	Worker* worker = (Worker*)_userData;
+
+	for (;;)
+	{
+		worker->m_start.wait();
+
+		if (worker->m_exit)
+		{
+			break;
+		}
+
+		worker->run();
+		worker->m_done.post();
+	}
+
+	return bx::kExitSuccess;
+}
+
+struct Result
+{
+	double m_ns[Phase::Count];
+	double m_sortMs;
+	double m_renderMs;
+	double m_swapMs;
+	uint32_t m_numDraw;
+};
+
+static void runPhase(Bench& _bench, Worker* _worker, Phase::Enum _phase, uint32_t _numFrames, Result& _result)
+{
+	_bench.m_phase = _phase;
+
+	for (uint32_t ii = 0; ii < _bench.m_numThreads; ++ii)
+	{
+		_worker[ii].m_elapsed = 0;
+		_worker[ii].m_calls   = 0;
+	}
+
+	int64_t frameTime  = 0;
+	int64_t sortTime   = 0;
+	int64_t renderTime = 0;
+	uint32_t numDraw   = 0;
+
+	for (uint32_t frame = 0; frame < _numFrames; ++frame)
+	{
+		for (uint32_t ii = 0; ii < _bench.m_numThreads; ++ii)
+		{
+			_worker[ii].m_start.post();
+		}
+
+		for (uint32_t ii = 0; ii < _bench.m_numThreads; ++ii)
+		{
+			_worker[ii].m_done.wait();
+		}
+
+		const int64_t timeBegin = bx::getHPCounter();
+		bgfx::frame();
+		frameTime += bx::getHPCounter() - timeBegin;
+
+		const bgfx::Stats* stats = bgfx::getStats();
+		sortTime   += stats->cpuTimeSort;
+		renderTime += stats->cpuTimeEnd - stats->cpuTimeBegin;
+		numDraw     = bx::max(numDraw, stats->numDraw);
+	}
+
+	int64_t  elapsed = 0;
+	uint64_t calls   = 0;
+
+	for (uint32_t ii = 0; ii < _bench.m_numThreads; ++ii)
+	{
+		elapsed += _worker[ii].m_elapsed;
+		calls   += _worker[ii].m_calls;
+	}
+
+	const double toNs = 1000000000.0/double(bx::getHPFrequency() );
+	const double toMs = 1000.0/double(bx::getHPFrequency() );
+
+	// Per call cost as seen by single encoder thread.
+	_result.m_ns[_phase] = double(elapsed)*toNs/double(bx::max<uint64_t>(calls, 1) );
+
+	if (Phase::Submit == _phase)
+	{
+		// Render time includes sort, report only backend part of it.
+		_result.m_sortMs   = double(sortTime)*toMs/double(_numFrames);
+		_result.m_renderMs = double(renderTime-sortTime)*toMs/double(_numFrames);
+		_result.m_swapMs   = double(frameTime-renderTime)*toMs/double(_numFrames);
+		_result.m_numDraw  = numDraw;
+	}
+}
+
+struct ConvertCase
+{
+	const char*             m_name;
+	bgfx::AttribType::Enum m_type;
+	uint8_t                 m_num;
+	bool                    m_normalized;
+	bool                    m_asInt;
+};
+
+static const ConvertCase s_convertCases[] =
+{
+	{ "half3",     bgfx::AttribType::Half,   3, false, false },
+	{ "int16x2n",  bgfx::AttribType::Int16,  2, true,  true  },
+	{ "uint10x3n", bgfx::AttribType::Uint10, 3, true,  true  },
+	{ "uint8x4n",  bgfx::AttribType::Uint8,  4, true,  false },
+};
+
+// Per vertex, per attribute unpack/pack, the way vertexConvert used to work.
+static void vertexConvertRef(const bgfx::VertexLayout& _destLayout, void* _destData, const bgfx::VertexLayout& _srcLayout, const void* _srcData, uint32_t _num)
+{
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		for (uint32_t attr = 0; attr < bgfx::Attrib::Count; ++attr)
+		{
+			if (_destLayout.has(bgfx::Attrib::Enum(attr) ) )
+			{
+				float unpacked[4];
+				bgfx::vertexUnpack(unpacked, bgfx::Attrib::Enum(attr), _srcLayout, _srcData, ii);
+				bgfx::vertexPack(unpacked, true, bgfx::Attrib::Enum(attr), _destLayout, _destData, ii);
+			}
+		}
+	}
+}
+
+static void benchVertexConvert(uint32_t _numVertices, uint32_t _numIterations)
+{
+	bgfx::VertexLayout srcLayout;
+	srcLayout
+		.begin()
+		.add(bgfx::Attrib::Position,  3, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::Normal,    3, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::Color0,    4, bgfx::AttribType::Float)
+		.end();
+
+	const uint32_t srcSize = srcLayout.getSize(_numVertices);
+	float* srcData = (float*)BX_ALLOC(entry::getAllocator(), srcSize);
+
+	const uint32_t numFloats = srcSize/sizeof(float);
+	for (uint32_t ii = 0; ii < numFloats; ++ii)
+	{
+		srcData[ii] = float(bx::hash<bx::HashMurmur2A>(ii) & 0xffff) / 65535.0f;
+	}
+
+	// Destination attributes are never wider than float source.
+	uint8_t* refData  = (uint8_t*)BX_ALLOC(entry::getAllocator(), srcSize);
+	uint8_t* destData = (uint8_t*)BX_ALLOC(entry::getAllocator(), srcSize);
+
+	const double toMs = 1000.0/double(bx::getHPFrequency() );
+
+	bx::printf("type\tvertices\tref\tconvert\tspeedup\tmatch\n");
+
+	for (uint32_t ii = 0; ii < BX_COUNTOF(s_convertCases); ++ii)
+	{
+		const ConvertCase& cc = s_convertCases[ii];
+
+		bgfx::VertexLayout destLayout;
+		destLayout
+			.begin()
+			.add(bgfx::Attrib::Position,  3,        cc.m_type, cc.m_normalized, cc.m_asInt)
+			.add(bgfx::Attrib::Normal,    3,        cc.m_type, cc.m_normalized, cc.m_asInt)
+			.add(bgfx::Attrib::TexCoord0, 2,        cc.m_type, cc.m_normalized, cc.m_asInt)
+			.add(bgfx::Attrib::Color0,    cc.m_num, cc.m_type, cc.m_normalized, cc.m_asInt)
+			.end();
+
+		const uint32_t destSize = destLayout.getSize(_numVertices);
+		bx::memSet(refData,  0, destSize);
+		bx::memSet(destData, 0, destSize);
+
+		int64_t refTime = 0;
+		int64_t time    = 0;
+
+		for (uint32_t jj = 0; jj < _numIterations; ++jj)
+		{
+			int64_t timeBegin = bx::getHPCounter();
+			vertexConvertRef(destLayout, refData, srcLayout, srcData, _numVertices);
+			refTime += bx::getHPCounter() - timeBegin;
+
+			timeBegin = bx::getHPCounter();
+			bgfx::vertexConvert(destLayout, destData, srcLayout, srcData, _numVertices);
+			time += bx::getHPCounter() - timeBegin;
+		}
+
+		const double refMs = double(refTime)*toMs/double(_numIterations);
+		const double ms    = double(time)*toMs/double(_numIterations);
+
+		bx::printf("%s\t%d\t%.3f\t%.3f\t%.2fx\t%s\n"
+			, cc.m_name
+			, _numVertices
+			, refMs
+			, ms
+			, refMs/bx::max(ms, 0.000001)
+			, 0 == bx::memCmp(refData, destData, destSize) ? "yes" : "NO"
+			);
+	}
+
+	BX_FREE(entry::getAllocator(), destData);
+	BX_FREE(entry::getAllocator(), refData);
+	BX_FREE(entry::getAllocator(), srcData);
+}
+
+static bool cullSphereRef(const bx::Plane* _planes, const Sphere& _sphere)
+{
+	for (uint32_t ii = 0; ii < 6; ++ii)
+	{
+		if (bx::distance(_planes[ii], _sphere.center) < -_sphere.radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool cullAabbRef(const bx::Plane* _planes, const Aabb& _aabb)
+{
+	const bx::Vec3 center  = getCenter(_aabb);
+	const bx::Vec3 extents = getExtents(_aabb);
+
+	for (uint32_t ii = 0; ii < 6; ++ii)
+	{
+		const bx::Plane& plane = _planes[ii];
+		const float radius = bx::dot(bx::abs(plane.normal), extents);
+		if (bx::distance(plane, center) + radius < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void benchCull(uint32_t _num, uint32_t _numThreads, uint32_t _numIterations)
+{
+	bx::AllocatorI* allocator = entry::getAllocator();
+
+	Sphere*   spheres = (Sphere*)BX_ALLOC(allocator, _num*sizeof(Sphere) );
+	Aabb*     aabbs   = (Aabb*)BX_ALLOC(allocator, _num*sizeof(Aabb) );
+	const uint32_t numWords = (_num+31)/32;
+	uint32_t* refMask = (uint32_t*)BX_ALLOC(allocator, numWords*sizeof(uint32_t) );
+	uint32_t* mask    = (uint32_t*)BX_ALLOC(allocator, numWords*sizeof(uint32_t) );
+
+	bx::RngMwc rng;
+	for (uint32_t ii = 0; ii < _num; ++ii)
+	{
+		const bx::Vec3 center =
+		{
+			(bx::frnd(&rng)*2.0f - 1.0f)*100.0f,
+			(bx::frnd(&rng)*2.0f - 1.0f)*100.0f,
+			(bx::frnd(&rng)*2.0f - 1.0f)*100.0f,
+		};
+		const float radius = bx::frnd(&rng)*2.0f + 0.1f;
+
+		spheres[ii].center = center;
+		spheres[ii].radius = radius;
+		toAabb(aabbs[ii], center, { radius, radius, radius });
+	}
+
+	float view[16];
+	bx::mtxLookAt(view, { 0.0f, 0.0f, -50.0f }, { 0.0f, 0.0f, 0.0f });
+
+	float proj[16];
+	bx::mtxProj(proj, 60.0f, 16.0f/9.0f, 0.1f, 200.0f, false);
+
+	float viewProj[16];
+	bx::mtxMul(viewProj, view, proj);
+
+	bx::Plane planes[6];
+	buildFrustumPlanes(planes, viewProj);
+
+	const double toMs = 1000.0/double(bx::getHPFrequency() );
+
+	bx::printf("shape\tnum\tthreads\tref\tcull\tspeedup\tmatch\n");
+
+	for (uint32_t shape = 0; shape < 2; ++shape)
+	{
+		for (uint32_t numThreads = 1; numThreads <= _numThreads; numThreads *= 2)
+		{
+			int64_t refTime = 0;
+			int64_t time    = 0;
+
+			for (uint32_t jj = 0; jj < _numIterations; ++jj)
+			{
+				int64_t timeBegin = bx::getHPCounter();
+				bx::memSet(refMask, 0, numWords*sizeof(uint32_t) );
+				for (uint32_t ii = 0; ii < _num; ++ii)
+				{
+					const bool visible = 0 == shape
+						? cullSphereRef(planes, spheres[ii])
+						: cullAabbRef(planes, aabbs[ii])
+						;
+					refMask[ii/32] |= uint32_t(visible) << (ii%32);
+				}
+				refTime += bx::getHPCounter() - timeBegin;
+
+				timeBegin = bx::getHPCounter();
+				if (0 == shape)
+				{
+					cullSpheres(mask, planes, 6, spheres, _num, numThreads);
+				}
+				else
+				{
+					cullAabbs(mask, planes, 6, aabbs, _num, numThreads);
+				}
+				time += bx::getHPCounter() - timeBegin;
+			}
+
+			const double refMs = double(refTime)*toMs/double(_numIterations);
+			const double ms    = double(time)*toMs/double(_numIterations);
+
+			bx::printf("%s\t%d\t%d\t%.3f\t%.3f\t%.2fx\t%s\n"
+				, 0 == shape ? "sphere" : "aabb"
+				, _num
+				, numThreads
+				, refMs
+				, ms
+				, refMs/bx::max(ms, 0.000001)
+				, 0 == bx::memCmp(refMask, mask, numWords*sizeof(uint32_t) ) ? "yes" : "NO"
+				);
+		}
+	}
+
+	BX_FREE(allocator, mask);
+	BX_FREE(allocator, refMask);
+	BX_FREE(allocator, aabbs);
+	BX_FREE(allocator, spheres);
+}
+
+static void benchBvh(uint32_t _numTriangles, uint32_t _numRays)
+{
+	bx::AllocatorI* allocator = entry::getAllocator();
+
+	// Triangle soup of small triangles scattered in a box, similar to scene geometry.
+	Triangle* triangles = (Triangle*)BX_ALLOC(allocator, _numTriangles*sizeof(Triangle) );
+
+	bx::RngMwc rng;
+	for (uint32_t ii = 0; ii < _numTriangles; ++ii)
+	{
+		const bx::Vec3 center =
+		{
+			(bx::frnd(&rng)*2.0f - 1.0f)*100.0f,
+			(bx::frnd(&rng)*2.0f - 1.0f)*100.0f,
+			(bx::frnd(&rng)*2.0f - 1.0f)*100.0f,
+		};
+
+		triangles[ii].v0 = bx::add(center, bx::mul(bx::randUnitSphere(&rng), 2.0f) );
+		triangles[ii].v1 = bx::add(center, bx::mul(bx::randUnitSphere(&rng), 2.0f) );
+		triangles[ii].v2 = bx::add(center, bx::mul(bx::randUnitSphere(&rng), 2.0f) );
+	}
+
+	const double toMs = 1000.0/double(bx::getHPFrequency() );
+
+	Bvh bvh;
+
+	int64_t timeBegin = bx::getHPCounter();
+	bvh.build(triangles, _numTriangles);
+	const double buildMs = double(bx::getHPCounter() - timeBegin)*toMs;
+
+	timeBegin = bx::getHPCounter();
+	bvh.refit(triangles);
+	const double refitMs = double(bx::getHPCounter() - timeBegin)*toMs;
+
+	int64_t refTime = 0;
+	int64_t time    = 0;
+	uint32_t numMatch = 0;
+
+	for (uint32_t ii = 0; ii < _numRays; ++ii)
+	{
+		Ray ray;
+		ray.pos = bx::mul(bx::randUnitSphere(&rng), 200.0f);
+		ray.dir = bx::normalize(bx::sub(bx::mul(bx::randUnitSphere(&rng), 50.0f), ray.pos) );
+
+		timeBegin = bx::getHPCounter();
+
+		uint32_t refIdx  = UINT32_MAX;
+		float    refDist = bx::kFloatMax;
+		for (uint32_t jj = 0; jj < _numTriangles; ++jj)
+		{
+			Hit hit;
+			if (intersect(ray, triangles[jj], &hit) )
+			{
+				const float dist = bx::dot(bx::sub(hit.pos, ray.pos), ray.dir);
+				if (dist < refDist)
+				{
+					refDist = dist;
+					refIdx  = jj;
+				}
+			}
+		}
+
+		refTime += bx::getHPCounter() - timeBegin;
+
+		timeBegin = bx::getHPCounter();
+		const uint32_t idx = bvh.intersect(ray);
+		time += bx::getHPCounter() - timeBegin;
+
+		numMatch += refIdx == idx;
+	}
+
+	uint32_t overlapIdx[256];
+
+	timeBegin = bx::getHPCounter();
+	uint32_t numOverlap = 0;
+	for (uint32_t ii = 0; ii < _numRays; ++ii)
+	{
+		Sphere sphere;
+		sphere.center = bx::mul(bx::randUnitSphere(&rng), 100.0f);
+		sphere.radius = 5.0f;
+		numOverlap += bvh.overlap(sphere, overlapIdx, BX_COUNTOF(overlapIdx) );
+	}
+	const double overlapMs = double(bx::getHPCounter() - timeBegin)*toMs;
+
+	bx::printf("triangles\t%d\n", _numTriangles);
+	bx::printf("nodes\t%d (%d bytes)\n", uint32_t(bvh.m_nodes.size() ), uint32_t(bvh.m_nodes.size()*sizeof(BvhNode) ) );
+	bx::printf("build\t%.3f ms\n", buildMs);
+	bx::printf("refit\t%.3f ms\n", refitMs);
+	bx::printf("ray brute force\t%.3f us/ray\n", double(refTime)*toMs*1000.0/double(_numRays) );
+	bx::printf("ray bvh\t%.3f us/ray\n", double(time)*toMs*1000.0/double(_numRays) );
+	bx::printf("ray match\t%d/%d\n", numMatch, _numRays);
+	bx::printf("sphere overlap\t%.3f us/query (%d hits)\n", overlapMs*1000.0/double(_numRays), numOverlap);
+
+	BX_FREE(allocator, triangles);
+}
+
+static void help(const char* _error = NULL)
+{
+	if (NULL != _error)
+	{
+		bx::printf("Error:\n%s\n\n", _error);
+	}
+
+	bx::printf(
+		  "bgfx-bench, bgfx submission front-end benchmark, version %d.%d.%d.\n"
+		  "Copyright 2011-2021 Branimir Karadzic. All rights reserved.\n"
+		  "License: https://github.com/bkaradzic/bgfx#license-bsd-2-clause\n\n"
+		, BGFX_BENCH_VERSION_MAJOR
+		, BGFX_BENCH_VERSION_MINOR
+		, BGFX_API_VERSION
+		);
+
+	bx::printf(
+		  "Usage: bgfx-bench [options]\n"
+		  "\n"
+		  "Options:\n"
+		  "  -h, --help               Help.\n"
+		  "  -v, --version            Version information only.\n"
+		  "      --frames <num>       Number of measured frames per configuration (default 32).\n"
+		  "      --threads <num>      Maximum number of encoder threads (default 8).\n"
+		  "      --vertex-convert <num>  Benchmark vertexConvert with <num> vertices and exit.\n"
+		  "      --cull <num>         Benchmark batch frustum culling of <num> shapes and exit,\n"
+		  "                           --threads sets maximum number of culling threads.\n"
+		  "      --bvh <num>          Benchmark BVH build, ray cast and overlap queries over <num>\n"
+		  "                           triangles against brute force and exit.\n"
+		  "      --shaders <num>      Benchmark createShader of <num> shaders, with shader binary\n"
+		  "                           uniform reflection (version 12) and without it, and exit.\n"
+		  "      --check              Check library internals (uniform groups, mesh loader) and exit.\n"
+
+		  "\n"
+		  "Columns:\n"
+		  "  transform  ns per setTransform call (MatrixCache::add).\n"
+		  "  uniform    ns per setUniform call (UniformBuffer write).\n"
+		  "  submit     ns per fully set up draw call, per encoder thread.\n"
+		  "  sort       ms per frame spent sorting draw calls on render side (Frame::sort).\n"
+		  "  render     ms per frame on render side excluding sort (backend). Needs\n"
+		  "             bgfx built with BGFX_CONFIG_RENDERER_NOOP_REPLAY=1.\n"
+		  "  swap       ms per frame spent in bgfx::frame outside of sort and render\n"
+		  "             (Context::swap).\n"
+
+		  "\n"
+		  "For additional information, see https://github.com/bkaradzic/bgfx\n"
+		);
+}
+
+} // namespace
+
+int _main_(int _argc, char** _argv)
+{
+	bx::CommandLine cmdLine(_argc, _argv);
+
+	if (cmdLine.hasArg('v', "version") )
+	{
+		bx::printf(
+			  "bgfx-bench, bgfx submission front-end benchmark, version %d.%d.%d.\n"
+			, BGFX_BENCH_VERSION_MAJOR
+			, BGFX_BENCH_VERSION_MINOR
+			, BGFX_API_VERSION
+			);
+		return bx::kExitSuccess;
+	}
+
+	if (cmdLine.hasArg('h', "help") )
+	{
+		help();
+		return bx::kExitFailure;
+	}
+
+	uint32_t numVertices = 0;
+	if (cmdLine.hasArg(numVertices, '\0', "vertex-convert") )
+	{
+		benchVertexConvert(bx::max<uint32_t>(numVertices, 1), 8);
+		return bx::kExitSuccess;
+	}
+
+	uint32_t numTriangles = 0;
+	if (cmdLine.hasArg(numTriangles, '\0', "bvh") )
+	{
+		benchBvh(bx::max<uint32_t>(numTriangles, 1), 1024);
+		return bx::kExitSuccess;
+	}
+
+	uint32_t numShapes = 0;
+	if (cmdLine.hasArg(numShapes, '\0', "cull") )
+	{
+		uint32_t numCullThreads = 8;
+		cmdLine.hasArg(numCullThreads, '\0', "threads");
+		benchCull(bx::max<uint32_t>(numShapes, 1), bx::max<uint32_t>(numCullThreads, 1), 16);
+		return bx::kExitSuccess;
+	}
+
+	uint32_t numFrames = 32;
+	cmdLine.hasArg(numFrames, '\0', "frames");
+	numFrames = bx::max<uint32_t>(numFrames, 1);
+
+	uint32_t maxThreads = kMaxThreads;
+	cmdLine.hasArg(maxThreads, '\0', "threads");
+	maxThreads = bx::clamp<uint32_t>(maxThreads, 1, kMaxThreads);
+
+	// Render on this thread, between frames, so that render side timing is not
+	// overlapping with encoder threads.
+	bgfx::renderFrame();
+
+	bgfx::Init init;
+	init.type     = bgfx::RendererType::Noop;
+	init.resolution.width  = 1280;
+	init.resolution.height = 720;
+	init.resolution.reset  = BGFX_RESET_NONE;
+	init.limits.maxEncoders = uint16_t(kMaxThreads+1);
+
+	if (!bgfx::init(init) )
+	{
+		help("Failed to initialize bgfx.");
+		return bx::kExitFailure;
+	}
+
+	if (cmdLine.hasArg('\0', "check") )
+	{
+		const bool match = checkInternals();
+		bgfx::shutdown();
+		return match ? bx::kExitSuccess : bx::kExitFailure;
+	}
+
+	uint32_t numShaders = 0;
+	if (cmdLine.hasArg(numShaders, '\0', "shaders") )
+	{
+		const uint32_t maxShaders = bgfx::getCaps()->limits.maxShaders;
+		benchCreateShader(bx::clamp<uint32_t>(numShaders, 1, maxShaders), 32, 8);
+		bgfx::shutdown();
+		return bx::kExitSuccess;
+	}
+
+	for (uint32_t ii = 0; ii < kNumViews; ++ii)
+	{
+		bgfx::setViewRect(bgfx::ViewId(ii), 0, 0, bgfx::BackbufferRatio::Equal);
+	}
+
+	bgfx::VertexLayout layout;
+	layout
+		.begin()
+		.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+		.end();
+
+	Bench bench;
+	bench.m_vbh     = bgfx::createVertexBuffer(bgfx::makeRef(s_triVertices, sizeof(s_triVertices) ), layout);
+	bench.m_ibh     = bgfx::createIndexBuffer(bgfx::makeRef(s_triIndices, sizeof(s_triIndices) ) );
+	bench.m_program = bgfx::createProgram(createBenchShader('V'), createBenchShader('F'), true);
+	bench.m_uniform = bgfx::createUniform("u_bench", bgfx::UniformType::Vec4, 4);
+
+	const uint32_t maxDrawCalls = bgfx::getCaps()->limits.maxDrawCalls;
+	const uint32_t numDraws[] = { 1<<10, 16<<10, bx::min<uint32_t>(64<<10, maxDrawCalls) };
+
+	Worker worker[kMaxThreads];
+
+	bx::printf("draws\tthreads\ttransform\tuniform\tsubmit\tsort\trender\tswap\n");
+
+	bool replay = true;
+
+	for (uint32_t ii = 0; ii < BX_COUNTOF(numDraws); ++ii)
+	{
+		for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+		{
+			bench.m_numDraws   = numDraws[ii];
+			bench.m_numThreads = numThreads;
+
+			for (uint32_t jj = 0; jj < numThreads; ++jj)
+			{
+				worker[jj].m_bench = &bench;
+				worker[jj].m_idx   = jj;
+				worker[jj].m_exit  = false;
+				worker[jj].m_thread.init(Worker::threadFunc, &worker[jj], 0, "bgfx-bench");
+			}
+
+			Result result;
+			bx::memSet(&result, 0, sizeof(result) );
+
+			// Warm up, to grow uniform buffers and caches to steady state.
+			runPhase(bench, worker, Phase::Submit, 2, result);
+
+			for (uint32_t phase = 0; phase < Phase::Count; ++phase)
+			{
+				runPhase(bench, worker, Phase::Enum(phase), numFrames, result);
+			}
+
+			for (uint32_t jj = 0; jj < numThreads; ++jj)
+			{
+				worker[jj].m_exit = true;
+				worker[jj].m_start.post();
+				worker[jj].m_thread.shutdown();
+			}
+
+			replay &= 0 != result.m_numDraw;
+
+			bx::printf("%d\t%d\t%.2f\t%.2f\t%.2f\t%.3f\t%.3f\t%.3f\n"
+				, bench.m_numDraws
+				, numThreads
+				, result.m_ns[Phase::Transform]
+				, result.m_ns[Phase::Uniform]
+				, result.m_ns[Phase::Submit]
+				, result.m_sortMs
+				, result.m_renderMs
+				, result.m_swapMs
+				);
+		}
+	}
+
+	if (!replay)
+	{
+		bx::printf("\nNote: noop renderer is not replaying frames, render column is not meaningful.\n");
+	}
+
+	bgfx::destroy(bench.m_uniform);
+	bgfx::destroy(bench.m_program);
+	bgfx::destroy(bench.m_ibh);
+	bgfx::destroy(bench.m_vbh);
+
+	bgfx::shutdown();
+
+	return bx::kExitSuccess;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2011-2021 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx#license-bsd-2-clause
+ */
+
+// Checks of library internals, bgfx must be initialized (internal allocator is used).
+#include "../../src/bgfx_p.h"
+
+bool checkMeshLoader();
+
+namespace
+{
+
+struct GroupEntry
+{
+	uint16_t m_loc;
+	uint16_t m_num;
+	float    m_value;
+};
+
+static void replaceGroupUniform(bgfx::UniformBuffer** _uniformBuffer, uint16_t _loc, uint16_t _num, float _value)
+{
+	float value[4*4];
+	for (uint32_t ii = 0; ii < BX_COUNTOF(value); ++ii)
+	{
+		value[ii] = _value;
+	}
+
+	BX_ASSERT(_num <= 4, "Too many elements.");
+	bgfx::UniformBuffer::replaceUniform(_uniformBuffer, bgfx::UniformType::Vec4, _loc, value, _num);
+}
+
+static bool checkGroup(bgfx::UniformBuffer* _uniformBuffer, const GroupEntry* _expected, uint32_t _num)
+{
+	bool match = true;
+
+	_uniformBuffer->reset();
+
+	for (uint32_t ii = 0;; ++ii)
+	{
+		const uint32_t opcode = _uniformBuffer->read();
+
+		if (bgfx::UniformType::End == opcode)
+		{
+			match &= ii == _num;
+			break;
+		}
+
+		bgfx::UniformType::Enum type;
+		uint16_t loc;
+		uint16_t num;
+		uint16_t copy;
+		bgfx::UniformBuffer::decodeOpcode(opcode, type, loc, num, copy);
+
+		const uint32_t size = bgfx::g_uniformTypeSize[type]*num;
+		const char* data = _uniformBuffer->read(size);
+
+		if (ii >= _num
+		||  loc != _expected[ii].m_loc
+		||  num != _expected[ii].m_num)
+		{
+			match = false;
+			continue;
+		}
+
+		for (uint32_t jj = 0; jj < size; jj += sizeof(float) )
+		{
+			float value;
+			bx::memCopy(&value, &data[jj], sizeof(float) );
+			match &= value == _expected[ii].m_value;
+		}
+	}
+
+	_uniformBuffer->reset();
+
+	return match;
+}
+
+static bool checkUniformGroup()
+{
+	bgfx::UniformBuffer* uniformBuffer = bgfx::UniformBuffer::create(64);
+	uniformBuffer->finish();
+
+	bool match = true;
+
+	replaceGroupUniform(&uniformBuffer, 0, 1, 1.0f);
+	replaceGroupUniform(&uniformBuffer, 1, 1, 2.0f);
+	replaceGroupUniform(&uniformBuffer, 2, 1, 3.0f);
+
+	{
+		const GroupEntry expected[] = { { 0, 1, 1.0f }, { 1, 1, 2.0f }, { 2, 1, 3.0f } };
+		match &= checkGroup(uniformBuffer, expected, BX_COUNTOF(expected) );
+	}
+
+	// Updating first of several uniforms must keep entries stored after it.
+	replaceGroupUniform(&uniformBuffer, 0, 1, 4.0f);
+
+	{
+		const GroupEntry expected[] = { { 0, 1, 4.0f }, { 1, 1, 2.0f }, { 2, 1, 3.0f } };
+		match &= checkGroup(uniformBuffer, expected, BX_COUNTOF(expected) );
+	}
+
+	// Different number of elements replaces entry, stale copy must not remain.
+	replaceGroupUniform(&uniformBuffer, 1, 3, 5.0f);
+	replaceGroupUniform(&uniformBuffer, 1, 3, 6.0f);
+
+	{
+		const GroupEntry expected[] = { { 0, 1, 4.0f }, { 2, 1, 3.0f }, { 1, 3, 6.0f } };
+		match &= checkGroup(uniformBuffer, expected, BX_COUNTOF(expected) );
+	}
+
+	// Growing stream past its initial size.
+	for (uint16_t ii = 3; ii < 32; ++ii)
+	{
+		replaceGroupUniform(&uniformBuffer, ii, 4, float(ii) );
+	}
+
+	replaceGroupUniform(&uniformBuffer, 0, 1, 7.0f);
+
+	{
+		GroupEntry expected[32];
+		expected[0] = { 0, 1, 7.0f };
+		expected[1] = { 2, 1, 3.0f };
+		expected[2] = { 1, 3, 6.0f };
+
+		for (uint16_t ii = 3; ii < 32; ++ii)
+		{
+			expected[ii] = { ii, 4, float(ii) };
+		}
+
+		match &= checkGroup(uniformBuffer, expected, BX_COUNTOF(expected) );
+	}
+
+	bgfx::UniformBuffer::destroy(uniformBuffer);
+
+	return match;
+}
+
+} // namespace
+
+bool checkInternals()
+{
+	bool match = true;
+
+	const bool uniformGroup = checkUniformGroup();
+	bx::printf("uniform group\t%s\n", uniformGroup ? "yes" : "NO");
+	match &= uniformGroup;
+
+	const bool meshLoader = checkMeshLoader();
+	bx::printf("mesh loader\t%s\n", meshLoader ? "yes" : "NO");
+	match &= meshLoader;
+
+	return match;
+}
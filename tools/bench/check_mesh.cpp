@@ -0,0 +1,91 @@
+/*
+ * Copyright 2011-2021 Branimir Karadzic. All rights reserved.
+ * License: https://github.com/bkaradzic/bgfx#license-bsd-2-clause
+ */
+
+// Checks of example mesh loader, bgfx must be initialized.
+#include <bx/readerwriter.h>
+#include <bgfx/bgfx.h>
+
+#include "bgfx_utils.h"
+
+namespace bgfx
+{
+	int32_t write(bx::WriterI* _writer, const bgfx::VertexLayout& _layout, bx::Error* _err = NULL);
+}
+
+namespace
+{
+
+static uint32_t numBuffers()
+{
+	// Handles of destroyed buffers are freed on frame.
+	bgfx::frame();
+	bgfx::frame();
+
+	const bgfx::Stats* stats = bgfx::getStats();
+	return stats->numVertexBuffers + stats->numIndexBuffers;
+}
+
+static uint32_t writeTruncatedMesh(uint8_t* _data, uint32_t _size)
+{
+	bx::StaticMemoryBlockWriter writer(_data, _size);
+
+	bgfx::VertexLayout layout;
+	layout
+		.begin()
+		.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+		.end();
+
+	Sphere sphere;
+	Aabb   aabb;
+	Obb    obb;
+	bx::memSet(&sphere, 0, sizeof(sphere) );
+	bx::memSet(&aabb,   0, sizeof(aabb) );
+	bx::memSet(&obb,    0, sizeof(obb) );
+
+	const uint16_t numVertices = 3;
+	float vertices[numVertices*3];
+	bx::memSet(vertices, 0, sizeof(vertices) );
+
+	bx::write(&writer, BX_MAKEFOURCC('V', 'B', ' ', 0x1) );
+	bx::write(&writer, sphere);
+	bx::write(&writer, aabb);
+	bx::write(&writer, obb);
+	bgfx::write(&writer, layout);
+	bx::write(&writer, numVertices);
+	bx::write(&writer, vertices, sizeof(vertices) );
+
+	// Index buffer chunk declares 3 indices, but file ends after the first one.
+	bx::write(&writer, BX_MAKEFOURCC('I', 'B', ' ', 0x0) );
+	bx::write(&writer, uint32_t(3) );
+	bx::write(&writer, uint16_t(0) );
+
+	return uint32_t(bx::seek(&writer) );
+}
+
+} // namespace
+
+bool checkMeshLoader()
+{
+	uint8_t data[1024];
+	const uint32_t size = writeTruncatedMesh(data, sizeof(data) );
+
+	bool match = true;
+
+	for (uint32_t ii = 0; ii < 2; ++ii)
+	{
+		const uint32_t numBefore = numBuffers();
+
+		// Truncated file must not produce group, and group built so far must be released.
+		bx::MemoryReader reader(data, size);
+		Mesh mesh;
+		mesh.load(&reader, 0 != ii);
+		match &= mesh.m_groups.empty();
+		mesh.unload();
+
+		match &= numBefore == numBuffers();
+	}
+
+	return match;
+}
@@ -5,7 +5,10 @@
 
 #include <algorithm>
 
+#include <bx/allocator.h>
+#include <bx/semaphore.h>
 #include <bx/string.h>
+#include <bx/thread.h>
 #include <bgfx/bgfx.h>
 #include "../../src/vertexlayout.h"
 
@@ -47,8 +50,10 @@ namespace stl = tinystl;
 #endif // 0
 
 #include <bx/bx.h>
+#include <bx/cpu.h>
 #include <bx/debug.h>
 #include <bx/commandline.h>
+#include <bx/thread.h>
 #include <bx/timer.h>
 #include <bx/hash.h>
 #include <bx/uint32_t.h>
@@ -152,21 +157,251 @@ struct Mesh
 
 static uint32_t s_obbSteps = 17;
 
+constexpr uint32_t kMaxThreads = 32;
+static uint32_t s_numThreads = 4;
+
+struct Stage
+{
+	enum Enum
+	{
+		Parse,
+		Convert,
+		Weld,
+		Tangents,
+		VertexCache,
+		VertexFetch,
+		Bounds,
+		Compress,
+		Meshlets,
+		Lods,
+		Write,
+
+		Count
+	};
+};
+
+static const char* s_stageName[] =
+{
+	"parse",
+	"convert",
+	"weld",
+	"tangents",
+	"vertex cache",
+	"vertex fetch",
+	"bounds",
+	"compress",
+	"meshlets",
+	"lods",
+	"write",
+};
+BX_STATIC_ASSERT(BX_COUNTOF(s_stageName) == Stage::Count);
+
+// Wall clock time per stage. Bounds, compress, meshlets and LODs run concurrently as jobs
+// of the same parallelFor, those accumulate time of all threads instead.
+static int64_t s_stageElapsed[Stage::Count];
+
+inline void stageAdd(Stage::Enum _stage, int64_t _timeBegin)
+{
+	bx::atomicFetchAndAdd<int64_t>(&s_stageElapsed[_stage], bx::getHPCounter() - _timeBegin);
+}
+
+typedef void (*JobFn)(void* _userData, uint32_t _idx);
+
+struct JobList
+{
+	JobFn    m_fn;
+	void*    m_userData;
+	uint32_t m_num;
+	uint32_t m_next;
+};
+
+static void jobRun(JobList& _list)
+{
+	for (uint32_t idx = bx::atomicFetchAndAdd<uint32_t>(&_list.m_next, 1); idx < _list.m_num; idx = bx::atomicFetchAndAdd<uint32_t>(&_list.m_next, 1) )
+	{
+		_list.m_fn(_list.m_userData, idx);
+	}
+}
+
+// Worker threads are created once for the whole run, and wait for parallelFor to hand
+// them job list. Calling thread always participates, so pool holds s_numThreads-1 workers.
+class JobPool
+{
+public:
+	JobPool(uint32_t _numThreads)
+		: m_list(NULL)
+		, m_numWorkers(0)
+		, m_exit(false)
+	{
+		for (uint32_t ii = 1; ii < _numThreads; ++ii)
+		{
+			if (!m_thread[m_numWorkers].init(workerThread, this, 0, "geometryc - job") )
+			{
+				bx::printf("Failed to create worker thread, using %d threads.\n", m_numWorkers+1);
+				break;
+			}
+
+			++m_numWorkers;
+		}
+	}
+
+	~JobPool()
+	{
+		m_exit = true;
+		m_start.post(m_numWorkers);
+
+		for (uint32_t ii = 0; ii < m_numWorkers; ++ii)
+		{
+			m_thread[ii].shutdown();
+		}
+	}
+
+	uint32_t getNumThreads() const
+	{
+		return m_numWorkers+1;
+	}
+
+	void run(JobList& _list)
+	{
+		const uint32_t numWorkers = bx::min(m_numWorkers, _list.m_num);
+
+		m_list = &_list;
+		m_start.post(numWorkers);
+
+		jobRun(_list);
+
+		for (uint32_t ii = 0; ii < numWorkers; ++ii)
+		{
+			m_done.wait();
+		}
+
+		m_list = NULL;
+	}
+
+private:
+	static int32_t workerThread(bx::Thread* _self, void* _userData)
+	{
+		BX_UNUSED(_self);
+
+		JobPool& pool = *(JobPool*)_userData;
+
+		for (;;)
+		{
+			pool.m_start.wait();
+
+			if (pool.m_exit)
+			{
+				break;
+			}
+
+			jobRun(*pool.m_list);
+			pool.m_done.post();
+		}
+
+		return bx::kExitSuccess;
+	}
+
+	bx::Thread    m_thread[kMaxThreads-1];
+	bx::Semaphore m_start;
+	bx::Semaphore m_done;
+	JobList*      m_list;
+	uint32_t      m_numWorkers;
+	bool          m_exit;
+};
+
+static JobPool* s_jobPool = NULL;
+
+// Runs _fn for indices [0, _num) on up to s_numThreads threads. Jobs write results into
+// their own slots, so output doesn't depend on number of threads or scheduling.
+void parallelFor(uint32_t _num, JobFn _fn, void* _userData)
+{
+	JobList list;
+	list.m_fn       = _fn;
+	list.m_userData = _userData;
+	list.m_num      = _num;
+	list.m_next     = 0;
+
+	if (NULL == s_jobPool)
+	{
+		jobRun(list);
+		return;
+	}
+
+	s_jobPool->run(list);
+}
+
 constexpr uint32_t kChunkVertexBuffer           = BX_MAKEFOURCC('V', 'B', ' ', 0x1);
 constexpr uint32_t kChunkVertexBufferCompressed = BX_MAKEFOURCC('V', 'B', 'C', 0x0);
 constexpr uint32_t kChunkIndexBuffer            = BX_MAKEFOURCC('I', 'B', ' ', 0x0);
 constexpr uint32_t kChunkIndexBufferCompressed  = BX_MAKEFOURCC('I', 'B', 'C', 0x1);
 constexpr uint32_t kChunkPrimitive              = BX_MAKEFOURCC('P', 'R', 'I', 0x0);
+constexpr uint32_t kChunkMeshlet                = BX_MAKEFOURCC('M', 'L', 'T', 0x0);
+constexpr uint32_t kChunkLod                    = BX_MAKEFOURCC('L', 'O', 'D', 0x0);
+
+// 32-bit index mode, vertex count is stored as uint32_t and indices are uint32_t.
+constexpr uint32_t kChunkVertexBuffer32           = BX_MAKEFOURCC('V', 'B', ' ', 0x2);
+constexpr uint32_t kChunkVertexBufferCompressed32 = BX_MAKEFOURCC('V', 'B', 'C', 0x1);
+constexpr uint32_t kChunkIndexBuffer32            = BX_MAKEFOURCC('I', 'B', ' ', 0x1);
+constexpr uint32_t kChunkIndexBufferCompressed32  = BX_MAKEFOURCC('I', 'B', 'C', 0x2);
+
+constexpr uint32_t kMeshletMaxVertices  = 64;
+constexpr uint32_t kMeshletMaxTriangles = 124;
+constexpr float    kMeshletConeWeight   = 0.25f;
+
+// Every LOD level targets half of the previous level index count, simplification stops
+// early once relative error would exceed kLodMaxError, and chain ends at first level that
+// doesn't reduce index count.
+constexpr uint32_t kLodMaxLevels = 8;
+constexpr float    kLodMaxError  = 0.05f;
+
+// Remaps indices of vertices within _epsilon position distance, and with all other attributes
+// within _epsilon, to the first such vertex. Vertices no longer referenced are removed by
+// vertex fetch optimization. Tangents are calculated after welding, and are not compared.
+void weldVertices(uint32_t* _indices, uint32_t _numIndices, const uint8_t* _vertexData, uint32_t _numVertices, const bgfx::VertexLayout& _layout, float _epsilon)
+{
+	float attribEpsilon[bgfx::Attrib::Count];
+	for (uint32_t ii = 0; ii < bgfx::Attrib::Count; ++ii)
+	{
+		attribEpsilon[ii] = _epsilon;
+	}
+
+	attribEpsilon[bgfx::Attrib::Tangent] = -1.0f;
+
+	bx::DefaultAllocator allocator;
+	uint32_t* remap = new uint32_t[_numVertices];
+	bgfx::weldVertices(remap, _layout, _vertexData, _numVertices, true, _epsilon, &allocator, attribEpsilon);
+
+	for (uint32_t ii = 0; ii < _numIndices; ++ii)
+	{
+		_indices[ii] = remap[_indices[ii] ];
+	}
 
-void optimizeVertexCache(uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices)
+	delete [] remap;
+}
+
+void optimizeVertexCache(uint32_t* _indices, uint32_t _numIndices, uint32_t _numVertices)
 {
-	uint16_t* newIndexList = new uint16_t[_numIndices];
+	uint32_t* newIndexList = new uint32_t[_numIndices];
 	meshopt_optimizeVertexCache(newIndexList, _indices, _numIndices, _numVertices);
-	bx::memCopy(_indices, newIndexList, _numIndices * 2);
+	bx::memCopy(_indices, newIndexList, _numIndices * sizeof(uint32_t) );
 	delete[] newIndexList;
 }
 
-uint32_t optimizeVertexFetch(uint16_t* _indices, uint32_t _numIndices, uint8_t* _vertexData, uint32_t _numVertices, uint16_t _stride)
+struct VertexCacheJob
+{
+	uint32_t*             m_indices;
+	uint32_t              m_numVertices;
+	const PrimitiveArray* m_primitives;
+};
+
+void optimizeVertexCacheJob(void* _userData, uint32_t _idx)
+{
+	const VertexCacheJob& job = *(const VertexCacheJob*)_userData;
+	const Primitive& prim = (*job.m_primitives)[_idx];
+	optimizeVertexCache(job.m_indices + prim.m_startIndex, prim.m_numIndices, job.m_numVertices);
+}
+
+uint32_t optimizeVertexFetch(uint32_t* _indices, uint32_t _numIndices, uint8_t* _vertexData, uint32_t _numVertices, uint16_t _stride)
 {
 	unsigned char* newVertices = (unsigned char*)malloc(_numVertices * _stride );
 	size_t vertexCount = meshopt_optimizeVertexFetch(newVertices, _indices, _numIndices, _vertexData, _numVertices, _stride);
@@ -176,39 +411,68 @@ uint32_t optimizeVertexFetch(uint16_t* _indices, uint32_t _numIndices, uint8_t*
 	return uint32_t(vertexCount);
 }
 
-void writeCompressedIndices(bx::WriterI* _writer, const uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices)
+struct Blob
+{
+	stl::vector<uint8_t> m_data;
+	uint32_t             m_uncompressedSize;
+};
+
+void compressIndices(Blob& _blob, const uint32_t* _indices, uint32_t _numIndices, uint32_t _numVertices, uint32_t _indexSize)
 {
+	const int64_t timeBegin = bx::getHPCounter();
+
 	size_t maxSize = meshopt_encodeIndexBufferBound(_numIndices, _numVertices);
-	unsigned char* compressedIndices = (unsigned char*)malloc(maxSize);
-	size_t compressedSize = meshopt_encodeIndexBuffer(compressedIndices, maxSize, _indices, _numIndices);
-	bx::printf("Indices uncompressed: %10d, compressed: %10d, ratio: %0.2f%%\n"
-		, _numIndices*2
-		, (uint32_t)compressedSize
-		, 100.0f - float(compressedSize ) / float(_numIndices*2)*100.0f
-		);
+	_blob.m_data.resize(uint32_t(maxSize) );
+	size_t compressedSize = meshopt_encodeIndexBuffer(_blob.m_data.data(), maxSize, _indices, _numIndices);
+	_blob.m_data.resize(uint32_t(compressedSize) );
+	_blob.m_uncompressedSize = _numIndices*_indexSize;
 
-	bx::write(_writer, (uint32_t)compressedSize);
-	bx::write(_writer, compressedIndices, (uint32_t)compressedSize );
-	free(compressedIndices);
+	stageAdd(Stage::Compress, timeBegin);
 }
 
-void writeCompressedVertices(bx::WriterI* _writer,  const uint8_t* _vertices, uint32_t _numVertices, uint16_t _stride)
+void compressVertices(Blob& _blob, const uint8_t* _vertices, uint32_t _numVertices, uint16_t _stride)
 {
+	const int64_t timeBegin = bx::getHPCounter();
+
 	size_t maxSize = meshopt_encodeVertexBufferBound(_numVertices, _stride);
-	unsigned char* compressedVertices = (unsigned char*)malloc(maxSize);
-	size_t compressedSize = meshopt_encodeVertexBuffer(compressedVertices, maxSize, _vertices, _numVertices, _stride);
-	bx::printf("Vertices uncompressed: %10d, compressed: %10d, ratio: %0.2f%%\n"
-		, _numVertices * _stride
-		, (uint32_t)compressedSize
-		, 100.0f - float(compressedSize) / float(_numVertices * _stride)*100.0f
+	_blob.m_data.resize(uint32_t(maxSize) );
+	size_t compressedSize = meshopt_encodeVertexBuffer(_blob.m_data.data(), maxSize, _vertices, _numVertices, _stride);
+	_blob.m_data.resize(uint32_t(compressedSize) );
+	_blob.m_uncompressedSize = _numVertices*_stride;
+
+	stageAdd(Stage::Compress, timeBegin);
+}
+
+void writeCompressed(bx::WriterI* _writer, const Blob& _blob, const char* _name)
+{
+	const uint32_t compressedSize = uint32_t(_blob.m_data.size() );
+
+	bx::printf("%s uncompressed: %10d, compressed: %10d, ratio: %0.2f%%\n"
+		, _name
+		, _blob.m_uncompressedSize
+		, compressedSize
+		, 100.0f - float(compressedSize) / float(_blob.m_uncompressedSize)*100.0f
 		);
 
-	bx::write(_writer, (uint32_t)compressedSize);
-	bx::write(_writer, compressedVertices, (uint32_t)compressedSize );
-	free(compressedVertices);
+	bx::write(_writer, compressedSize);
+	bx::write(_writer, _blob.m_data.data(), compressedSize);
 }
 
-void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexLayout _layout, const uint16_t* _indices, uint32_t _numIndices)
+constexpr uint32_t kTangentJobSize = 16<<10;
+
+struct TangentJob
+{
+	void*                     m_vertices;
+	const bgfx::VertexLayout* m_layout;
+	const uint32_t*           m_indices;
+	uint32_t                  m_numTriangles;
+	uint32_t                  m_numVertices;
+	float*                    m_triTangents;
+	const uint32_t*           m_vertexTriStart;
+	const uint32_t*           m_vertexTri;
+};
+
+void calcTriangleTangents(void* _userData, uint32_t _idx)
 {
 	struct PosTexcoord
 	{
@@ -222,28 +486,28 @@ void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexLayout _la
 		float m_pad2;
 	};
 
-	float* tangents = new float[6*_numVertices];
-	bx::memSet(tangents, 0, 6*_numVertices*sizeof(float) );
+	const TangentJob& job = *(const TangentJob*)_userData;
+	const bgfx::VertexLayout& layout = *job.m_layout;
 
 	PosTexcoord v0;
 	PosTexcoord v1;
 	PosTexcoord v2;
 
-	for (uint32_t ii = 0, num = _numIndices/3; ii < num; ++ii)
+	for (uint32_t ii = _idx*kTangentJobSize, num = bx::min(ii+kTangentJobSize, job.m_numTriangles); ii < num; ++ii)
 	{
-		const uint16_t* indices = &_indices[ii*3];
+		const uint32_t* indices = &job.m_indices[ii*3];
 		uint32_t i0 = indices[0];
 		uint32_t i1 = indices[1];
 		uint32_t i2 = indices[2];
 
-		bgfx::vertexUnpack(&v0.m_x, bgfx::Attrib::Position, _layout, _vertices, i0);
-		bgfx::vertexUnpack(&v0.m_u, bgfx::Attrib::TexCoord0, _layout, _vertices, i0);
+		bgfx::vertexUnpack(&v0.m_x, bgfx::Attrib::Position, layout, job.m_vertices, i0);
+		bgfx::vertexUnpack(&v0.m_u, bgfx::Attrib::TexCoord0, layout, job.m_vertices, i0);
 
-		bgfx::vertexUnpack(&v1.m_x, bgfx::Attrib::Position, _layout, _vertices, i1);
-		bgfx::vertexUnpack(&v1.m_u, bgfx::Attrib::TexCoord0, _layout, _vertices, i1);
+		bgfx::vertexUnpack(&v1.m_x, bgfx::Attrib::Position, layout, job.m_vertices, i1);
+		bgfx::vertexUnpack(&v1.m_u, bgfx::Attrib::TexCoord0, layout, job.m_vertices, i1);
 
-		bgfx::vertexUnpack(&v2.m_x, bgfx::Attrib::Position, _layout, _vertices, i2);
-		bgfx::vertexUnpack(&v2.m_u, bgfx::Attrib::TexCoord0, _layout, _vertices, i2);
+		bgfx::vertexUnpack(&v2.m_x, bgfx::Attrib::Position, layout, job.m_vertices, i2);
+		bgfx::vertexUnpack(&v2.m_u, bgfx::Attrib::TexCoord0, layout, job.m_vertices, i2);
 
 		const float bax = v1.m_x - v0.m_x;
 		const float bay = v1.m_y - v0.m_y;
@@ -260,35 +524,42 @@ void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexLayout _la
 		const float det = (bau * cav - bav * cau);
 		const float invDet = 1.0f / det;
 
-		const float tx = (bax * cav - cax * bav) * invDet;
-		const float ty = (bay * cav - cay * bav) * invDet;
-		const float tz = (baz * cav - caz * bav) * invDet;
+		float* tangent = &job.m_triTangents[ii*6];
+		tangent[0] = (bax * cav - cax * bav) * invDet;
+		tangent[1] = (bay * cav - cay * bav) * invDet;
+		tangent[2] = (baz * cav - caz * bav) * invDet;
 
-		const float bx = (cax * bau - bax * cau) * invDet;
-		const float by = (cay * bau - bay * cau) * invDet;
-		const float bz = (caz * bau - baz * cau) * invDet;
+		tangent[3] = (cax * bau - bax * cau) * invDet;
+		tangent[4] = (cay * bau - bay * cau) * invDet;
+		tangent[5] = (caz * bau - baz * cau) * invDet;
+	}
+}
 
-		for (uint32_t jj = 0; jj < 3; ++jj)
+void calcVertexTangents(void* _userData, uint32_t _idx)
+{
+	const TangentJob& job = *(const TangentJob*)_userData;
+	const bgfx::VertexLayout& layout = *job.m_layout;
+
+	for (uint32_t ii = _idx*kTangentJobSize, num = bx::min(ii+kTangentJobSize, job.m_numVertices); ii < num; ++ii)
+	{
+		// Sum in the same triangle order as serial scatter would, so result is bit exact.
+		float tangents[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+		for (uint32_t jj = job.m_vertexTriStart[ii], end = job.m_vertexTriStart[ii+1]; jj < end; ++jj)
 		{
-			float* tanu = &tangents[indices[jj]*6];
-			float* tanv = &tanu[3];
-			tanu[0] += tx;
-			tanu[1] += ty;
-			tanu[2] += tz;
-
-			tanv[0] += bx;
-			tanv[1] += by;
-			tanv[2] += bz;
+			const float* tangent = &job.m_triTangents[job.m_vertexTri[jj]*6];
+
+			for (uint32_t kk = 0; kk < 6; ++kk)
+			{
+				tangents[kk] += tangent[kk];
+			}
 		}
-	}
 
-	for (uint32_t ii = 0; ii < _numVertices; ++ii)
-	{
-		const bx::Vec3 tanu = bx::load<bx::Vec3>(&tangents[ii*6]);
-		const bx::Vec3 tanv = bx::load<bx::Vec3>(&tangents[ii*6 + 3]);
+		const bx::Vec3 tanu = bx::load<bx::Vec3>(&tangents[0]);
+		const bx::Vec3 tanv = bx::load<bx::Vec3>(&tangents[3]);
 
 		float nxyzw[4];
-		bgfx::vertexUnpack(nxyzw, bgfx::Attrib::Normal, _layout, _vertices, ii);
+		bgfx::vertexUnpack(nxyzw, bgfx::Attrib::Normal, layout, job.m_vertices, ii);
 
 		const bx::Vec3 normal  = bx::load<bx::Vec3>(nxyzw);
 		const float    ndt     = bx::dot(normal, tanu);
@@ -299,36 +570,478 @@ void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexLayout _la
 		bx::store(tangent, bx::normalize(tmp) );
 		tangent[3] = bx::dot(nxt, tanv) < 0.0f ? -1.0f : 1.0f;
 
-		bgfx::vertexPack(tangent, true, bgfx::Attrib::Tangent, _layout, _vertices, ii);
+		bgfx::vertexPack(tangent, true, bgfx::Attrib::Tangent, layout, job.m_vertices, ii);
 	}
+}
+
+void calcTangents(void* _vertices, uint32_t _numVertices, const bgfx::VertexLayout& _layout, const uint32_t* _indices, uint32_t _numIndices)
+{
+	const uint32_t numTriangles = _numIndices/3;
+
+	// Vertex to triangle adjacency, filled in triangle order.
+	uint32_t* vertexTriStart = new uint32_t[_numVertices+1];
+	uint32_t* vertexTri      = new uint32_t[numTriangles*3];
+	float*    triTangents    = new float[numTriangles*6];
+
+	bx::memSet(vertexTriStart, 0, (_numVertices+1)*sizeof(uint32_t) );
+
+	for (uint32_t ii = 0, num = numTriangles*3; ii < num; ++ii)
+	{
+		++vertexTriStart[_indices[ii]+1];
+	}
+
+	for (uint32_t ii = 0; ii < _numVertices; ++ii)
+	{
+		vertexTriStart[ii+1] += vertexTriStart[ii];
+	}
+
+	uint32_t* fill = new uint32_t[_numVertices];
+	bx::memCopy(fill, vertexTriStart, _numVertices*sizeof(uint32_t) );
+
+	for (uint32_t ii = 0, num = numTriangles*3; ii < num; ++ii)
+	{
+		vertexTri[fill[_indices[ii]]++] = ii/3;
+	}
+
+	delete [] fill;
+
+	TangentJob job;
+	job.m_vertices       = _vertices;
+	job.m_layout         = &_layout;
+	job.m_indices        = _indices;
+	job.m_numTriangles   = numTriangles;
+	job.m_numVertices    = _numVertices;
+	job.m_triTangents    = triTangents;
+	job.m_vertexTriStart = vertexTriStart;
+	job.m_vertexTri      = vertexTri;
 
-	delete [] tangents;
+	parallelFor( (numTriangles+kTangentJobSize-1)/kTangentJobSize, calcTriangleTangents, &job);
+	parallelFor( (_numVertices+kTangentJobSize-1)/kTangentJobSize, calcVertexTangents,   &job);
+
+	delete [] triTangents;
+	delete [] vertexTri;
+	delete [] vertexTriStart;
 }
 
-void write(bx::WriterI* _writer, const void* _vertices, uint32_t _numVertices, uint32_t _stride)
+struct Bounds
+{
+	Sphere m_sphere;
+	Aabb   m_aabb;
+	Obb    m_obb;
+};
+
+void calcBounds(Bounds& _bounds, const void* _vertices, uint32_t _numVertices, uint32_t _stride)
 {
+	const int64_t timeBegin = bx::getHPCounter();
+
 	Sphere maxSphere;
 	calcMaxBoundingSphere(maxSphere, _vertices, _numVertices, _stride);
 
 	Sphere minSphere;
 	calcMinBoundingSphere(minSphere, _vertices, _numVertices, _stride);
 
-	if (minSphere.radius > maxSphere.radius)
+	_bounds.m_sphere = minSphere.radius > maxSphere.radius
+		? maxSphere
+		: minSphere
+		;
+
+	toAabb(_bounds.m_aabb, _vertices, _numVertices, _stride);
+
+	calcObb(_bounds.m_obb, _vertices, _numVertices, _stride, s_obbSteps);
+
+	stageAdd(Stage::Bounds, timeBegin);
+}
+
+void write(bx::WriterI* _writer, const Bounds& _bounds)
+{
+	bx::write(_writer, _bounds.m_sphere);
+	bx::write(_writer, _bounds.m_aabb);
+	bx::write(_writer, _bounds.m_obb);
+}
+
+struct Meshlets
+{
+	stl::vector<meshopt_Meshlet> m_meshlets;
+	stl::vector<meshopt_Bounds>  m_bounds;
+	stl::vector<uint32_t>        m_vertices;
+	stl::vector<uint8_t>         m_triangles;
+};
+
+void buildMeshlets(
+	  Meshlets& _meshlets
+	, const uint8_t* _vertices
+	, uint32_t _numVertices
+	, const bgfx::VertexLayout& _layout
+	, const uint32_t* _indices
+	, uint32_t _numIndices
+	)
+{
+	const int64_t timeBegin = bx::getHPCounter();
+
+	const float* positions = (const float*)(_vertices + _layout.getOffset(bgfx::Attrib::Position) );
+	const uint32_t stride = _layout.getStride();
+
+	const uint32_t maxMeshlets = uint32_t(meshopt_buildMeshletsBound(_numIndices, kMeshletMaxVertices, kMeshletMaxTriangles) );
+	_meshlets.m_meshlets.resize(maxMeshlets);
+	_meshlets.m_vertices.resize(maxMeshlets*kMeshletMaxVertices);
+	_meshlets.m_triangles.resize(maxMeshlets*kMeshletMaxTriangles*3);
+
+	const uint32_t num = uint32_t(meshopt_buildMeshlets(
+		  _meshlets.m_meshlets.data()
+		, _meshlets.m_vertices.data()
+		, _meshlets.m_triangles.data()
+		, _indices
+		, _numIndices
+		, positions
+		, _numVertices
+		, stride
+		, kMeshletMaxVertices
+		, kMeshletMaxTriangles
+		, kMeshletConeWeight
+		) );
+
+	_meshlets.m_meshlets.resize(num);
+	_meshlets.m_bounds.resize(num);
+
+	uint32_t numVertices  = 0;
+	uint32_t numTriangles = 0;
+
+	if (0 < num)
 	{
-		bx::write(_writer, maxSphere);
+		const meshopt_Meshlet& last = _meshlets.m_meshlets[num-1];
+		numVertices  = last.vertex_offset + last.vertex_count;
+		numTriangles = last.triangle_offset + ( (last.triangle_count*3 + 3) & ~3);
 	}
-	else
+
+	_meshlets.m_vertices.resize(numVertices);
+	_meshlets.m_triangles.resize(numTriangles);
+
+	for (uint32_t ii = 0; ii < num; ++ii)
+	{
+		const meshopt_Meshlet& meshlet = _meshlets.m_meshlets[ii];
+
+		_meshlets.m_bounds[ii] = meshopt_computeMeshletBounds(
+			  &_meshlets.m_vertices[meshlet.vertex_offset]
+			, &_meshlets.m_triangles[meshlet.triangle_offset]
+			, meshlet.triangle_count
+			, positions
+			, _numVertices
+			, stride
+			);
+	}
+
+	stageAdd(Stage::Meshlets, timeBegin);
+}
+
+void writeMeshlets(bx::WriterI* _writer, const stl::vector<Meshlets>& _primMeshlets)
+{
+	using namespace bx;
+
+	const uint32_t numPrims = uint32_t(_primMeshlets.size() );
+
+	write(_writer, kChunkMeshlet);
+	write(_writer, uint16_t(numPrims) );
+
+	// Meshlets of each primitive are built separately, so that they can be culled per primitive.
+	uint32_t numMeshlets         = 0;
+	uint32_t numMeshletVertices  = 0;
+	uint32_t numMeshletTriangles = 0;
+
+	for (uint32_t ii = 0; ii < numPrims; ++ii)
 	{
-		bx::write(_writer, minSphere);
+		const uint32_t num = uint32_t(_primMeshlets[ii].m_meshlets.size() );
+		write(_writer, numMeshlets);
+		write(_writer, num);
+		numMeshlets += num;
 	}
 
-	Aabb aabb;
-	toAabb(aabb, _vertices, _numVertices, _stride);
-	bx::write(_writer, aabb);
+	write(_writer, numMeshlets);
+
+	for (uint32_t ii = 0; ii < numPrims; ++ii)
+	{
+		const Meshlets& meshlets = _primMeshlets[ii];
+
+		for (uint32_t jj = 0, num = uint32_t(meshlets.m_meshlets.size() ); jj < num; ++jj)
+		{
+			const meshopt_Meshlet& meshlet = meshlets.m_meshlets[jj];
+			const meshopt_Bounds&  bounds  = meshlets.m_bounds[jj];
+
+			write(_writer, meshlet.vertex_offset   + numMeshletVertices);
+			write(_writer, meshlet.triangle_offset + numMeshletTriangles);
+			write(_writer, meshlet.vertex_count);
+			write(_writer, meshlet.triangle_count);
+			write(_writer, bounds.center, uint32_t(sizeof(bounds.center) ) );
+			write(_writer, bounds.radius);
+			write(_writer, bounds.cone_apex, uint32_t(sizeof(bounds.cone_apex) ) );
+			write(_writer, bounds.cone_axis, uint32_t(sizeof(bounds.cone_axis) ) );
+			write(_writer, bounds.cone_cutoff);
+		}
+
+		numMeshletVertices  += uint32_t(meshlets.m_vertices.size() );
+		numMeshletTriangles += uint32_t(meshlets.m_triangles.size() );
+	}
+
+	write(_writer, numMeshletVertices);
+	for (uint32_t ii = 0; ii < numPrims; ++ii)
+	{
+		const Meshlets& meshlets = _primMeshlets[ii];
+		write(_writer, meshlets.m_vertices.data(), uint32_t(meshlets.m_vertices.size()*sizeof(uint32_t) ) );
+	}
+
+	write(_writer, numMeshletTriangles);
+	for (uint32_t ii = 0; ii < numPrims; ++ii)
+	{
+		const Meshlets& meshlets = _primMeshlets[ii];
+		write(_writer, meshlets.m_triangles.data(), uint32_t(meshlets.m_triangles.size() ) );
+	}
+
+	bx::printf("Meshlets: %10d, vertices: %10d, triangle bytes: %10d\n"
+		, numMeshlets
+		, numMeshletVertices
+		, numMeshletTriangles
+		);
+}
 
-	Obb obb;
-	calcObb(obb, _vertices, _numVertices, _stride, s_obbSteps);
-	bx::write(_writer, obb);
+struct Lods
+{
+	float                 m_error[kLodMaxLevels]; //!< Absolute error, in position units.
+	stl::vector<uint32_t> m_indices[kLodMaxLevels];
+	uint32_t              m_numLods;              //!< Levels that reduce index count.
+};
+
+void buildLods(
+	  Lods& _lods
+	, uint32_t _numLods
+	, float _scale
+	, const uint8_t* _vertices
+	, uint32_t _numVertices
+	, const bgfx::VertexLayout& _layout
+	, const uint32_t* _indices
+	, uint32_t _numIndices
+	)
+{
+	const int64_t timeBegin = bx::getHPCounter();
+
+	const float* positions = (const float*)(_vertices + _layout.getOffset(bgfx::Attrib::Position) );
+	const uint32_t stride = _layout.getStride();
+
+	float    error   = 0.0f;
+	uint32_t target  = _numIndices;
+	uint32_t prevNum = _numIndices;
+
+	_lods.m_numLods = 0;
+
+	// Each level is simplified from full resolution primitive, so that error doesn't
+	// accumulate across levels.
+	for (uint32_t ii = 0; ii < _numLods; ++ii)
+	{
+		target = target/6*3;
+
+		stl::vector<uint32_t>& lod = _lods.m_indices[ii];
+		lod.resize(_numIndices);
+
+		float lodError = 0.0f;
+		const uint32_t num = uint32_t(meshopt_simplify(
+			  lod.data()
+			, _indices
+			, _numIndices
+			, positions
+			, _numVertices
+			, stride
+			, target
+			, kLodMaxError
+			, &lodError
+			) );
+		lod.resize(num);
+
+		meshopt_optimizeVertexCache(lod.data(), lod.data(), num, _numVertices);
+
+		error = bx::max(error, lodError*_scale);
+		_lods.m_error[ii] = error;
+
+		// Level 0 is kept even when it doesn't reduce index count, it's used for this
+		// primitive when other primitives of group still have levels.
+		if (num >= prevNum)
+		{
+			if (0 < ii)
+			{
+				lod.clear();
+			}
+
+			break;
+		}
+
+		prevNum = num;
+		++_lods.m_numLods;
+	}
+
+	stageAdd(Stage::Lods, timeBegin);
+}
+
+inline uint32_t lodLevel(const Lods& _lods, uint32_t _level)
+{
+	return bx::min(_level, bx::max<uint32_t>(_lods.m_numLods, 1) - 1);
+}
+
+void writeLods(bx::WriterI* _writer, const stl::vector<Lods>& _primLods, bool _index32)
+{
+	using namespace bx;
+
+	const uint32_t numPrims = uint32_t(_primLods.size() );
+
+	uint32_t numLods = 0;
+	for (uint32_t jj = 0; jj < numPrims; ++jj)
+	{
+		numLods = bx::max(numLods, _primLods[jj].m_numLods);
+	}
+
+	if (0 == numLods)
+	{
+		return;
+	}
+
+	write(_writer, kChunkLod);
+	write(_writer, uint8_t(numLods) );
+	write(_writer, uint8_t(_index32) );
+	write(_writer, uint16_t(numPrims) );
+
+	// Primitives are simplified separately, level error is the worst error of all its
+	// primitives, and level index buffer is concatenation of its primitives. Primitive
+	// whose chain ended earlier uses its last level.
+	for (uint32_t ii = 0; ii < numLods; ++ii)
+	{
+		float    error      = 0.0f;
+		uint32_t numIndices = 0;
+
+		for (uint32_t jj = 0; jj < numPrims; ++jj)
+		{
+			const uint32_t level = lodLevel(_primLods[jj], ii);
+			error       = bx::max(error, _primLods[jj].m_error[level]);
+			numIndices += uint32_t(_primLods[jj].m_indices[level].size() );
+		}
+
+		write(_writer, error);
+		write(_writer, numIndices);
+
+		uint32_t startIndex = 0;
+		for (uint32_t jj = 0; jj < numPrims; ++jj)
+		{
+			const uint32_t num = uint32_t(_primLods[jj].m_indices[lodLevel(_primLods[jj], ii)].size() );
+			write(_writer, startIndex);
+			write(_writer, num);
+			startIndex += num;
+		}
+
+		for (uint32_t jj = 0; jj < numPrims; ++jj)
+		{
+			const stl::vector<uint32_t>& indices = _primLods[jj].m_indices[lodLevel(_primLods[jj], ii)];
+
+			if (_index32)
+			{
+				write(_writer, indices.data(), uint32_t(indices.size()*sizeof(uint32_t) ) );
+			}
+			else
+			{
+				for (uint32_t kk = 0, num = uint32_t(indices.size() ); kk < num; ++kk)
+				{
+					write(_writer, uint16_t(indices[kk]) );
+				}
+			}
+		}
+
+		bx::printf("LOD %d: %10d indices, error %f\n", ii+1, numIndices, error);
+	}
+}
+
+// Everything derived from welded and optimized group data. Bounds, compression,
+// meshlets and LODs are independent, and are built in parallel before group is written.
+struct Encode
+{
+	const uint8_t*            m_vertices;
+	uint32_t                  m_numVertices;
+	const bgfx::VertexLayout* m_layout;
+	const uint32_t*           m_indices;
+	uint32_t                  m_numIndices;
+	const PrimitiveArray*     m_primitives;
+	bool                      m_compress;
+	bool                      m_index32;
+	bool                      m_meshlets;
+	uint32_t                  m_numLods;
+	float                     m_lodScale;
+
+	Bounds                    m_bounds;
+	stl::vector<Bounds>       m_primBounds;
+	Blob                      m_compressedVertices;
+	Blob                      m_compressedIndices;
+	stl::vector<Meshlets>     m_primMeshlets;
+	stl::vector<Lods>         m_primLods;
+};
+
+void encodeJob(void* _userData, uint32_t _idx)
+{
+	Encode& encode = *(Encode*)_userData;
+
+	const uint32_t numPrims = uint32_t(encode.m_primitives->size() );
+	const uint32_t stride   = encode.m_layout->getStride();
+
+	if (0 == _idx)
+	{
+		calcBounds(encode.m_bounds, encode.m_vertices, encode.m_numVertices, stride);
+	}
+	else if (_idx <= numPrims)
+	{
+		const Primitive& prim = (*encode.m_primitives)[_idx-1];
+		calcBounds(encode.m_primBounds[_idx-1], &encode.m_vertices[prim.m_startVertex*stride], prim.m_numVertices, stride);
+	}
+	else if (_idx == numPrims+1)
+	{
+		if (encode.m_compress)
+		{
+			compressVertices(encode.m_compressedVertices, encode.m_vertices, encode.m_numVertices, uint16_t(stride) );
+		}
+	}
+	else if (_idx == numPrims+2)
+	{
+		if (encode.m_compress)
+		{
+			compressIndices(
+				  encode.m_compressedIndices
+				, encode.m_indices
+				, encode.m_numIndices
+				, encode.m_numVertices
+				, encode.m_index32 ? uint32_t(sizeof(uint32_t) ) : uint32_t(sizeof(uint16_t) )
+				);
+		}
+	}
+	else if (_idx < 2*numPrims+3)
+	{
+		if (encode.m_meshlets)
+		{
+			const Primitive& prim = (*encode.m_primitives)[_idx-numPrims-3];
+			buildMeshlets(
+				  encode.m_primMeshlets[_idx-numPrims-3]
+				, encode.m_vertices
+				, encode.m_numVertices
+				, *encode.m_layout
+				, &encode.m_indices[prim.m_startIndex]
+				, prim.m_numIndices
+				);
+		}
+	}
+	else if (0 < encode.m_numLods)
+	{
+		const Primitive& prim = (*encode.m_primitives)[_idx-2*numPrims-3];
+		buildLods(
+			  encode.m_primLods[_idx-2*numPrims-3]
+			, encode.m_numLods
+			, encode.m_lodScale
+			, encode.m_vertices
+			, encode.m_numVertices
+			, *encode.m_layout
+			, &encode.m_indices[prim.m_startIndex]
+			, prim.m_numIndices
+			);
+	}
 }
 
 void write(
@@ -336,9 +1049,12 @@ void write(
 	, const uint8_t* _vertices
 	, uint32_t _numVertices
 	, const bgfx::VertexLayout& _layout
-	, const uint16_t* _indices
+	, const uint32_t* _indices
 	, uint32_t _numIndices
 	, bool _compress
+	, bool _index32
+	, bool _meshlets
+	, uint32_t _numLods
 	, const stl::string& _material
 	, const PrimitiveArray& _primitives
 	)
@@ -346,50 +1062,114 @@ void write(
 	using namespace bx;
 	using namespace bgfx;
 
+	const uint32_t numPrims = uint32_t(_primitives.size() );
+
+	Encode encode;
+	encode.m_vertices    = _vertices;
+	encode.m_numVertices = _numVertices;
+	encode.m_layout      = &_layout;
+	encode.m_indices     = _indices;
+	encode.m_numIndices  = _numIndices;
+	encode.m_primitives  = &_primitives;
+	encode.m_compress    = _compress;
+	encode.m_index32     = _index32;
+	encode.m_meshlets    = _meshlets;
+	encode.m_primBounds.resize(numPrims);
+	encode.m_numLods     = _numLods;
+	encode.m_lodScale    = 0 < _numLods
+		? meshopt_simplifyScale( (const float*)(_vertices + _layout.getOffset(bgfx::Attrib::Position) ), _numVertices, _layout.getStride() )
+		: 0.0f
+		;
+	encode.m_primMeshlets.resize(_meshlets ? numPrims : 0);
+	encode.m_primLods.resize(0 < _numLods ? numPrims : 0);
+
+	parallelFor(3*numPrims + 3, encodeJob, &encode);
+
+	const int64_t timeBegin = bx::getHPCounter();
+
 	uint32_t stride = _layout.getStride();
 
 	if (_compress)
 	{
-		write(_writer, kChunkVertexBufferCompressed);
-		write(_writer, _vertices, _numVertices, stride);
+		write(_writer, _index32 ? kChunkVertexBufferCompressed32 : kChunkVertexBufferCompressed);
+		write(_writer, encode.m_bounds);
 
 		write(_writer, _layout);
 
-		write(_writer, uint16_t(_numVertices) );
-		writeCompressedVertices(_writer, _vertices, _numVertices, uint16_t(stride) );
+		if (_index32)
+		{
+			write(_writer, _numVertices);
+		}
+		else
+		{
+			write(_writer, uint16_t(_numVertices) );
+		}
+
+		writeCompressed(_writer, encode.m_compressedVertices, "Vertices");
 	}
 	else
 	{
-		write(_writer, kChunkVertexBuffer);
-		write(_writer, _vertices, _numVertices, stride);
+		write(_writer, _index32 ? kChunkVertexBuffer32 : kChunkVertexBuffer);
+		write(_writer, encode.m_bounds);
 
 		write(_writer, _layout);
 
-		write(_writer, uint16_t(_numVertices) );
+		if (_index32)
+		{
+			write(_writer, _numVertices);
+		}
+		else
+		{
+			write(_writer, uint16_t(_numVertices) );
+		}
+
 		write(_writer, _vertices, _numVertices*stride);
 	}
 
 	if (_compress)
 	{
-		write(_writer, kChunkIndexBufferCompressed);
+		write(_writer, _index32 ? kChunkIndexBufferCompressed32 : kChunkIndexBufferCompressed);
 		write(_writer, _numIndices);
-		writeCompressedIndices(_writer, _indices, _numIndices, _numVertices);
+
+		// Encoded stream doesn't depend on index size, only decoder does.
+		writeCompressed(_writer, encode.m_compressedIndices, "Indices");
 	}
 	else
 	{
-		write(_writer, kChunkIndexBuffer);
+		write(_writer, _index32 ? kChunkIndexBuffer32 : kChunkIndexBuffer);
 		write(_writer, _numIndices);
-		write(_writer, _indices, _numIndices*2);
+
+		if (_index32)
+		{
+			write(_writer, _indices, _numIndices*uint32_t(sizeof(uint32_t) ) );
+		}
+		else
+		{
+			for (uint32_t ii = 0; ii < _numIndices; ++ii)
+			{
+				write(_writer, uint16_t(_indices[ii]) );
+			}
+		}
+	}
+
+	if (_meshlets)
+	{
+		writeMeshlets(_writer, encode.m_primMeshlets);
+	}
+
+	if (0 < _numLods)
+	{
+		writeLods(_writer, encode.m_primLods, _index32);
 	}
 
 	write(_writer, kChunkPrimitive);
 	uint16_t nameLen = uint16_t(_material.size() );
 	write(_writer, nameLen);
 	write(_writer, _material.c_str(), nameLen);
-	write(_writer, uint16_t(_primitives.size() ) );
-	for (PrimitiveArray::const_iterator primIt = _primitives.begin(); primIt != _primitives.end(); ++primIt)
+	write(_writer, uint16_t(numPrims) );
+	for (uint32_t ii = 0; ii < numPrims; ++ii)
 	{
-		const Primitive& prim = *primIt;
+		const Primitive& prim = _primitives[ii];
 		nameLen = uint16_t(prim.m_name.size() );
 		write(_writer, nameLen);
 		write(_writer, prim.m_name.c_str(), nameLen);
@@ -397,8 +1177,10 @@ void write(
 		write(_writer, prim.m_numIndices);
 		write(_writer, prim.m_startVertex);
 		write(_writer, prim.m_numVertices);
-		write(_writer, &_vertices[prim.m_startVertex*stride], prim.m_numVertices, stride);
+		write(_writer, encode.m_primBounds[ii]);
 	}
+
+	s_stageElapsed[Stage::Write] += bx::getHPCounter() - timeBegin;
 }
 
 inline uint32_t rgbaToAbgr(uint8_t _r, uint8_t _g, uint8_t _b, uint8_t _a)
@@ -463,29 +1245,51 @@ float mtxDeterminant(const float* _a)
 	return det;
 }
 
-void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
+struct ObjEvent
 {
-	// Reference(s):
-	// - Wavefront .obj file
-	//   https://en.wikipedia.org/wiki/Wavefront_.obj_file
+	enum Enum
+	{
+		Vertex,
+		Name,
+		Material,
+	};
 
-	// Coordinate system is right-handed, but up/forward is not defined, but +Y Up, +Z Forward seems to be a common default
-	_mesh->m_coordinateSystem.m_handness = bx::Handness::Right;
-	_mesh->m_coordinateSystem.m_up = Axis::PositiveY;
-	_mesh->m_coordinateSystem.m_forward = Axis::PositiveZ;
+	Enum        m_type;
+	uint32_t    m_numTriangles;
+	stl::string m_value;
+};
 
-	uint32_t num = 0;
+typedef stl::vector<ObjEvent> ObjEventArray;
 
-	Group group;
-	group.m_startTriangle = 0;
-	group.m_numTriangles = 0;
+// Part of .obj file between line boundaries, parsed independently. Negative (relative)
+// face indices are resolved against chunk local counts, and flagged in m_relative so that
+// merge can offset them by number of elements in preceding chunks.
+struct ObjChunk
+{
+	bx::StringView        m_data;
+	Vec3Array             m_positions;
+	Vec3Array             m_normals;
+	Vec3Array             m_texcoords;
+	TriangleArray         m_triangles;
+	stl::vector<uint16_t> m_relative;
+	ObjEventArray         m_events;
+	uint32_t              m_numLines;
+	uint32_t              m_numParamVertices;
+	bool                  m_hasBc;
+};
+
+constexpr uint32_t kObjChunkSize = 1<<20;
+
+void parseObjChunk(void* _userData, uint32_t _idx)
+{
+	ObjChunk& chunk = ((ObjChunk*)_userData)[_idx];
 
 	char commandLine[2048];
 	uint32_t len = sizeof(commandLine);
 	int argc;
 	char* argv[64];
 
-	for (bx::StringView next(_data, _size); !next.isEmpty(); )
+	for (bx::StringView next(chunk.m_data); !next.isEmpty(); )
 	{
 		next = bx::tokenizeCommandLine(next, commandLine, len, argc, argv, BX_COUNTOF(argv), '\n');
 
@@ -503,15 +1307,17 @@ void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
 				TriIndices triangle;
 				bx::memSet(&triangle, 0, sizeof(TriIndices) );
 
-				const int numNormals   = (int)_mesh->m_normals.size();
-				const int numTexcoords = (int)_mesh->m_texcoords.size();
-				const int numPositions = (int)_mesh->m_positions.size();
+				uint16_t relative[3] = { 0, 0, 0 };
+
+				const int numNormals   = (int)chunk.m_normals.size();
+				const int numTexcoords = (int)chunk.m_texcoords.size();
+				const int numPositions = (int)chunk.m_positions.size();
 				for (uint32_t edge = 0, numEdges = argc-1; edge < numEdges; ++edge)
 				{
 					Index3 index;
 					index.m_texcoord = -1;
 					index.m_normal = -1;
-					if (_hasBc)
+					if (chunk.m_hasBc)
 					{
 						index.m_vbc = edge < 3 ? edge : (1+(edge+1) )&1;
 					}
@@ -520,6 +1326,8 @@ void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
 						index.m_vbc = 0;
 					}
 
+					uint16_t flags = 0;
+
 					{
 						bx::StringView triplet(argv[edge + 1]);
 						bx::StringView vertex(triplet);
@@ -534,6 +1342,7 @@ void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
 								int32_t nn;
 								bx::fromString(&nn, bx::StringView(normal.getPtr() + 1, triplet.getTerm() ) );
 								index.m_normal = (nn < 0) ? nn + numNormals : nn - 1;
+								flags |= (nn < 0) ? 4 : 0;
 							}
 
 							texcoord.set(texcoord.getPtr() + 1, normal.getPtr() );
@@ -546,45 +1355,60 @@ void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
 								int32_t tex;
 								bx::fromString(&tex, texcoord);
 								index.m_texcoord = (tex < 0) ? tex + numTexcoords : tex - 1;
+								flags |= (tex < 0) ? 2 : 0;
 							}
 						}
 
 						int32_t pos;
 						bx::fromString(&pos, vertex);
 						index.m_position = (pos < 0) ? pos + numPositions : pos - 1;
+						flags |= (pos < 0) ? 1 : 0;
 					}
 
 					switch (edge)
 					{
 					case 0:	case 1:	case 2:
 						triangle.m_index[edge] = index;
+						relative[edge] = flags;
 						if (2 == edge)
 						{
-							_mesh->m_triangles.push_back(triangle);
+							chunk.m_triangles.push_back(triangle);
+							chunk.m_relative.push_back(relative[0] | (relative[1]<<3) | (relative[2]<<6) );
 						}
 						break;
 
 					default:
 						triangle.m_index[1] = triangle.m_index[2];
 						triangle.m_index[2] = index;
+						relative[1] = relative[2];
+						relative[2] = flags;
 
-						_mesh->m_triangles.push_back(triangle);
+						chunk.m_triangles.push_back(triangle);
+						chunk.m_relative.push_back(relative[0] | (relative[1]<<3) | (relative[2]<<6) );
 						break;
 					}
 				}
 			}
 			else if (0 == bx::strCmp(argv[0], "g") )
 			{
-				group.m_name = argv[1];
+				ObjEvent event;
+				event.m_type         = ObjEvent::Name;
+				event.m_numTriangles = uint32_t(chunk.m_triangles.size() );
+				event.m_value        = argv[1];
+				chunk.m_events.push_back(event);
 			}
 			else if (*argv[0] == 'v')
 			{
-				group.m_numTriangles = (uint32_t)(_mesh->m_triangles.size() ) - group.m_startTriangle;
-				if (0 < group.m_numTriangles)
+				// Vertex line ends group with triangles, consecutive vertex lines are recorded once.
+				const uint32_t numTriangles = uint32_t(chunk.m_triangles.size() );
+				if (chunk.m_events.empty()
+				||  ObjEvent::Vertex       != chunk.m_events.back().m_type
+				||  numTriangles != chunk.m_events.back().m_numTriangles)
 				{
-					_mesh->m_groups.push_back(group);
-					group.m_startTriangle = (uint32_t)(_mesh->m_triangles.size() );
-					group.m_numTriangles = 0;
+					ObjEvent event;
+					event.m_type         = ObjEvent::Vertex;
+					event.m_numTriangles = numTriangles;
+					chunk.m_events.push_back(event);
 				}
 
 				if (0 == bx::strCmp(argv[0], "vn") )
@@ -594,16 +1418,11 @@ void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
 					bx::fromString(&normal.y, argv[2]);
 					bx::fromString(&normal.z, argv[3]);
 
-					_mesh->m_normals.push_back(normal);
+					chunk.m_normals.push_back(normal);
 				}
 				else if (0 == bx::strCmp(argv[0], "vp") )
 				{
-					static bool once = true;
-					if (once)
-					{
-						once = false;
-						bx::printf("warning: 'parameter space vertices' are unsupported.\n");
-					}
+					++chunk.m_numParamVertices;
 				}
 				else if (0 == bx::strCmp(argv[0], "vt") )
 				{
@@ -627,7 +1446,7 @@ void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
 						break;
 					}
 
-					_mesh->m_texcoords.push_back(texcoord);
+					chunk.m_texcoords.push_back(texcoord);
 				}
 				else
 				{
@@ -655,25 +1474,16 @@ void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
 					pos.y = py;
 					pos.z = pz;
 
-					_mesh->m_positions.push_back(pos);
+					chunk.m_positions.push_back(pos);
 				}
 			}
 			else if (0 == bx::strCmp(argv[0], "usemtl") )
 			{
-				stl::string material(argv[1]);
-
-				if (0 != bx::strCmp(material.c_str(), group.m_material.c_str() ) )
-				{
-					group.m_numTriangles = (uint32_t)(_mesh->m_triangles.size() ) - group.m_startTriangle;
-					if (0 < group.m_numTriangles)
-					{
-						_mesh->m_groups.push_back(group);
-						group.m_startTriangle = (uint32_t)(_mesh->m_triangles.size() );
-						group.m_numTriangles = 0;
-					}
-				}
-
-				group.m_material = material;
+				ObjEvent event;
+				event.m_type         = ObjEvent::Material;
+				event.m_numTriangles = uint32_t(chunk.m_triangles.size() );
+				event.m_value        = argv[1];
+				chunk.m_events.push_back(event);
 			}
 // unsupported tags
 // 				else if (0 == bx::strCmp(argv[0], "mtllib") )
@@ -687,7 +1497,122 @@ void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
 // 				}
 		}
 
-		++num;
+		++chunk.m_numLines;
+	}
+}
+
+void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
+{
+	// Reference(s):
+	// - Wavefront .obj file
+	//   https://en.wikipedia.org/wiki/Wavefront_.obj_file
+
+	// Coordinate system is right-handed, but up/forward is not defined, but +Y Up, +Z Forward seems to be a common default
+	_mesh->m_coordinateSystem.m_handness = bx::Handness::Right;
+	_mesh->m_coordinateSystem.m_up = Axis::PositiveY;
+	_mesh->m_coordinateSystem.m_forward = Axis::PositiveZ;
+
+	// Split file into chunks at line boundaries. Chunk size doesn't depend on number of
+	// threads, and merge is exact, so output is the same for any number of threads.
+	const uint32_t numChunks = bx::max<uint32_t>(1, _size/kObjChunkSize);
+	stl::vector<ObjChunk> chunks;
+	chunks.resize(numChunks);
+
+	const char* ptr = _data;
+	const char* end = _data + _size;
+
+	for (uint32_t ii = 0; ii < numChunks; ++ii)
+	{
+		const char* chunkEnd = ii+1 == numChunks ? end : bx::max(ptr, _data + uint64_t(_size)*(ii+1)/numChunks);
+
+		while (chunkEnd < end
+		&&     '\n' != chunkEnd[-1])
+		{
+			++chunkEnd;
+		}
+
+		ObjChunk& chunk = chunks[ii];
+		chunk.m_data.set(ptr, chunkEnd);
+		chunk.m_numLines         = 0;
+		chunk.m_numParamVertices = 0;
+		chunk.m_hasBc            = _hasBc;
+
+		ptr = chunkEnd;
+	}
+
+	parallelFor(numChunks, parseObjChunk, chunks.data() );
+
+	uint32_t num = 0;
+	uint32_t numParamVertices = 0;
+
+	Group group;
+	group.m_startTriangle = 0;
+	group.m_numTriangles = 0;
+
+	for (uint32_t ii = 0; ii < numChunks; ++ii)
+	{
+		const ObjChunk& chunk = chunks[ii];
+
+		const int32_t positionBase = int32_t(_mesh->m_positions.size() );
+		const int32_t texcoordBase = int32_t(_mesh->m_texcoords.size() );
+		const int32_t normalBase   = int32_t(_mesh->m_normals.size() );
+		const uint32_t triangleBase = uint32_t(_mesh->m_triangles.size() );
+
+		for (ObjEventArray::const_iterator it = chunk.m_events.begin(), itEnd = chunk.m_events.end(); it != itEnd; ++it)
+		{
+			const uint32_t numTriangles = triangleBase + it->m_numTriangles;
+
+			switch (it->m_type)
+			{
+			case ObjEvent::Name:
+				group.m_name = it->m_value;
+				break;
+
+			case ObjEvent::Vertex:
+			case ObjEvent::Material:
+				if (ObjEvent::Vertex == it->m_type
+				||  0 != bx::strCmp(it->m_value.c_str(), group.m_material.c_str() ) )
+				{
+					group.m_numTriangles = numTriangles - group.m_startTriangle;
+					if (0 < group.m_numTriangles)
+					{
+						_mesh->m_groups.push_back(group);
+						group.m_startTriangle = numTriangles;
+						group.m_numTriangles = 0;
+					}
+				}
+
+				if (ObjEvent::Material == it->m_type)
+				{
+					group.m_material = it->m_value;
+				}
+				break;
+			}
+		}
+
+		_mesh->m_positions.insert(_mesh->m_positions.end(), chunk.m_positions.begin(), chunk.m_positions.end() );
+		_mesh->m_texcoords.insert(_mesh->m_texcoords.end(), chunk.m_texcoords.begin(), chunk.m_texcoords.end() );
+		_mesh->m_normals.insert(_mesh->m_normals.end(), chunk.m_normals.begin(), chunk.m_normals.end() );
+
+		for (uint32_t jj = 0, numTriangles = uint32_t(chunk.m_triangles.size() ); jj < numTriangles; ++jj)
+		{
+			TriIndices triangle = chunk.m_triangles[jj];
+			const uint16_t relative = chunk.m_relative[jj];
+
+			for (uint32_t edge = 0; edge < 3; ++edge)
+			{
+				Index3& index = triangle.m_index[edge];
+				const uint16_t flags = relative >> (edge*3);
+				index.m_position += (flags & 1) ? positionBase : 0;
+				index.m_texcoord += (flags & 2) ? texcoordBase : 0;
+				index.m_normal   += (flags & 4) ? normalBase   : 0;
+			}
+
+			_mesh->m_triangles.push_back(triangle);
+		}
+
+		num              += chunk.m_numLines;
+		numParamVertices += chunk.m_numParamVertices;
 	}
 
 	group.m_numTriangles = (uint32_t)(_mesh->m_triangles.size() ) - group.m_startTriangle;
@@ -698,6 +1623,11 @@ void parseObj(char* _data, uint32_t _size, Mesh* _mesh, bool _hasBc)
 		group.m_numTriangles = 0;
 	}
 
+	if (0 < numParamVertices)
+	{
+		bx::printf("warning: 'parameter space vertices' are unsupported.\n");
+	}
+
 	bx::printf("obj parser # %d\n", num);
 }
 
@@ -933,7 +1863,13 @@ void help(const char* _error = NULL)
 		  "           1 - packed 4 bytes.\n"
 		  "      --tangent            Calculate tangent vectors (packing mode is the same as normal).\n"
 		  "      --barycentric        Adds barycentric vertex attribute (packed in bgfx::Attrib::Color1).\n"
+		  "      --weld <num>         Weld vertices with position and all other attributes within <num>.\n"
 		  "  -c, --compress           Compress indices.\n"
+		  "      --index32            Use 32-bit indices, primitive groups are not split at 65533 vertices.\n"
+		  "      --meshlets           Build meshlets with bounds and normal cones for cluster culling.\n"
+		  "      --lods <num>         Number of simplified LOD levels (max 8), each halves index count.\n"
+		  "      --threads <num>      Number of worker threads (default 4). Output doesn't depend on it.\n"
+		  "      --verbose            Print per stage timings.\n"
 		  "      --[l/r]h-up+[y/z]	  Coordinate system. Default is '--lh-up+y' Left-Handed +Y is up.\n"
 
 		  "\n"
@@ -987,6 +1923,21 @@ int main(int _argc, const char* _argv[])
 	}
 
 	bool compress = cmdLine.hasArg('c', "compress");
+	bool index32  = cmdLine.hasArg("index32");
+	bool meshlets = cmdLine.hasArg("meshlets");
+	bool verbose  = cmdLine.hasArg("verbose");
+
+	uint32_t numLods = 0;
+	cmdLine.hasArg(numLods, '\0', "lods");
+	numLods = bx::min(numLods, kLodMaxLevels);
+
+	cmdLine.hasArg(s_numThreads, '\0', "threads");
+	s_numThreads = bx::clamp<uint32_t>(s_numThreads, 1, kMaxThreads);
+
+	// Not destroyed on exit(), process teardown takes worker threads down.
+	JobPool jobPool(s_numThreads);
+	s_jobPool    = &jobPool;
+	s_numThreads = jobPool.getNumThreads();
 
 	cmdLine.hasArg(s_obbSteps, '\0', "obb");
 	s_obbSteps = bx::uint32_min(bx::uint32_max(s_obbSteps, 1), 90);
@@ -1002,6 +1953,16 @@ int main(int _argc, const char* _argv[])
 	bool hasTangent = cmdLine.hasArg("tangent");
 	bool hasBc = cmdLine.hasArg("barycentric");
 
+	float weldEpsilon = 0.0f;
+	const char* weldArg = cmdLine.findOption("weld");
+	if (NULL != weldArg)
+	{
+		if (!bx::fromString(&weldEpsilon, weldArg) )
+		{
+			weldEpsilon = 0.0f;
+		}
+	}
+
 	CoordinateSystem outputCoordinateSystem;
 	outputCoordinateSystem.m_handness = bx::Handness::Left;
 	outputCoordinateSystem.m_forward = Axis::PositiveZ;
@@ -1051,6 +2012,9 @@ int main(int _argc, const char* _argv[])
 	int64_t now = bx::getHPCounter();
 	parseElapsed += now;
 	int64_t convertElapsed = -now;
+	int64_t flushElapsed = 0;
+
+	s_stageElapsed[Stage::Parse] = parseElapsed;
 
 	std::sort(mesh.m_groups.begin(), mesh.m_groups.end(), GroupSortByMaterial() );
 
@@ -1189,7 +2153,7 @@ int main(int _argc, const char* _argv[])
 
 	uint32_t stride = layout.getStride();
 	uint8_t* vertexData = new uint8_t[mesh.m_triangles.size() * 3 * stride];
-	uint16_t* indexData = new uint16_t[mesh.m_triangles.size() * 3];
+	uint32_t* indexData = new uint32_t[mesh.m_triangles.size() * 3];
 	int32_t numVertices = 0;
 	int32_t numIndices = 0;
 
@@ -1198,9 +2162,12 @@ int main(int _argc, const char* _argv[])
 	int32_t writtenIndices = 0;
 
 	uint8_t* vertices = vertexData;
-	uint16_t* indices = indexData;
+	uint32_t* indices = indexData;
 
-	const uint32_t tableSize = 65536 * 2;
+	const uint32_t tableSize = index32
+		? bx::uint32_max(bx::uint32_nextpow2(uint32_t(mesh.m_triangles.size() * 3) ), 65536) * 2
+		: 65536 * 2
+		;
 	const uint32_t hashmod = tableSize - 1;
 	uint32_t* table = new uint32_t[tableSize];
 	bx::memSet(table, 0xff, tableSize * sizeof(uint32_t) );
@@ -1236,8 +2203,10 @@ int main(int _argc, const char* _argv[])
 		{
 			if (0 != bx::strCmp(material.c_str(), groupIt->m_material.c_str() )
 			|| sentinel
-			||  65533 <= numVertices)
+			||  (!index32 && 65533 <= numVertices) )
 			{
+				flushElapsed -= bx::getHPCounter();
+
 				prim.m_numVertices = numVertices - prim.m_startVertex;
 				prim.m_numIndices  = numIndices  - prim.m_startIndex;
 				if (0 < prim.m_numVertices)
@@ -1245,20 +2214,44 @@ int main(int _argc, const char* _argv[])
 					primitives.push_back(prim);
 				}
 
-				if (hasTangent)
+				int64_t timeBegin = bx::getHPCounter();
+
+				if (0.0f < weldEpsilon)
 				{
-					calcTangents(vertexData, uint16_t(numVertices), layout, indexData, numIndices);
+					weldVertices(indexData, numIndices, vertexData, numVertices, layout, weldEpsilon);
 				}
 
-				triReorderElapsed -= bx::getHPCounter();
-				for (PrimitiveArray::const_iterator primIt = primitives.begin(); primIt != primitives.end(); ++primIt)
+				now = bx::getHPCounter();
+				s_stageElapsed[Stage::Weld] += now - timeBegin;
+				timeBegin = now;
+
+				if (hasTangent)
 				{
-					const Primitive& prim1 = *primIt;
-					optimizeVertexCache(indexData + prim1.m_startIndex, prim1.m_numIndices, numVertices);
+					calcTangents(vertexData, numVertices, layout, indexData, numIndices);
 				}
+
+				now = bx::getHPCounter();
+				s_stageElapsed[Stage::Tangents] += now - timeBegin;
+				timeBegin = now;
+
+				triReorderElapsed -= now;
+
+				VertexCacheJob vertexCacheJob;
+				vertexCacheJob.m_indices     = indexData;
+				vertexCacheJob.m_numVertices = numVertices;
+				vertexCacheJob.m_primitives  = &primitives;
+				parallelFor(uint32_t(primitives.size() ), optimizeVertexCacheJob, &vertexCacheJob);
+
+				now = bx::getHPCounter();
+				s_stageElapsed[Stage::VertexCache] += now - timeBegin;
+				timeBegin = now;
+
 				numVertices = optimizeVertexFetch(indexData, numIndices, vertexData, numVertices, uint16_t(stride) );
 
-				triReorderElapsed += bx::getHPCounter();
+				now = bx::getHPCounter();
+				s_stageElapsed[Stage::VertexFetch] += now - timeBegin;
+
+				triReorderElapsed += now;
 
 				if ( numVertices > 0 && numIndices > 0 )
 				{
@@ -1269,6 +2262,9 @@ int main(int _argc, const char* _argv[])
 						  , indexData
 						  , numIndices
 						  , compress
+						  , index32
+						  , meshlets
+						  , numLods
 						  , material
 						  , primitives
 						  );
@@ -1290,6 +2286,8 @@ int main(int _argc, const char* _argv[])
 
 				material = groupIt->m_material;
 
+				flushElapsed += bx::getHPCounter();
+
 				if (sentinel)
 					break;
 			}
@@ -1372,7 +2370,7 @@ int main(int _argc, const char* _argv[])
 					exit(bx::kExitFailure);
 				}
 
-				*indices++ = (uint16_t)vertexIndex;
+				*indices++ = vertexIndex;
 				++numIndices;
 			}
 		}
@@ -1417,5 +2415,28 @@ int main(int _argc, const char* _argv[])
 		, writtenIndices
 		);
 
+	if (verbose)
+	{
+		s_stageElapsed[Stage::Convert] = convertElapsed - flushElapsed;
+
+		bx::printf("\nthreads %d\n", s_numThreads);
+
+		for (uint32_t stage = 0; stage < Stage::Count; ++stage)
+		{
+			const bool threadTime = false
+				|| Stage::Bounds   == stage
+				|| Stage::Compress == stage
+				|| Stage::Meshlets == stage
+				|| Stage::Lods     == stage
+				;
+
+			bx::printf("%-14s %f [s]%s\n"
+				, s_stageName[stage]
+				, double(s_stageElapsed[stage])/bx::getHPFrequency()
+				, threadTime ? " (sum of all threads)" : ""
+				);
+		}
+	}
+
 	return bx::kExitSuccess;
 }
@@ -5,7 +5,12 @@
 
 #include "shaderc.h"
 #include <bx/commandline.h>
+#include <bx/cpu.h>
 #include <bx/filepath.h>
+#include <bx/thread.h>
+#include <bx/timer.h>
+
+#include "../../src/shader.h"
 
 #define MAX_TAGS 256
 extern "C"
@@ -13,12 +18,16 @@ extern "C"
 #include <fpp.h>
 } // extern "C"
 
-#define BGFX_SHADER_BIN_VERSION 11
+#define BGFX_SHADER_BIN_VERSION 12
 #define BGFX_CHUNK_MAGIC_CSH BX_MAKEFOURCC('C', 'S', 'H', BGFX_SHADER_BIN_VERSION)
 #define BGFX_CHUNK_MAGIC_FSH BX_MAKEFOURCC('F', 'S', 'H', BGFX_SHADER_BIN_VERSION)
 #define BGFX_CHUNK_MAGIC_GSH BX_MAKEFOURCC('G', 'S', 'H', BGFX_SHADER_BIN_VERSION)
 #define BGFX_CHUNK_MAGIC_VSH BX_MAKEFOURCC('V', 'S', 'H', BGFX_SHADER_BIN_VERSION)
 
+#define BGFX_CHUNK_MAGIC_SVR BX_MAKEFOURCC('S', 'V', 'R', 0x0)
+
+#define SHADERC_CACHE_MAGIC BX_MAKEFOURCC('S', 'C', 'C', 0)
+
 #define BGFX_SHADERC_VERSION_MAJOR 1
 #define BGFX_SHADERC_VERSION_MINOR 18
 
@@ -322,6 +331,7 @@ namespace bgfx
 			"\t  profile: %s\n"
 			"\t  inputFile: %s\n"
 			"\t  outputFile: %s\n"
+			"\t  cacheDir: %s\n"
 			"\t  disasm: %s\n"
 			"\t  raw: %s\n"
 			"\t  preprocessOnly: %s\n"
@@ -342,6 +352,7 @@ namespace bgfx
 			, profile.c_str()
 			, inputFilePath.c_str()
 			, outputFilePath.c_str()
+			, cacheDir.c_str()
 			, disasm ? "true" : "false"
 			, raw ? "true" : "false"
 			, preprocessOnly ? "true" : "false"
@@ -679,6 +690,14 @@ namespace bgfx
 		}
 	}
 
+	void writeUniformReflection(bx::WriterI* _writer, const Uniform& _uniform)
+	{
+		const uint32_t nameHash   = bx::hash<bx::HashMurmur2A>(_uniform.name.c_str() );
+		const uint8_t  predefined = uint8_t(nameToPredefinedUniformEnum(_uniform.name.c_str() ) );
+		bx::write(_writer, nameHash);
+		bx::write(_writer, predefined);
+	}
+
 	struct Preprocessor
 	{
 		Preprocessor(const char* _filePath, bool _essl)
@@ -971,7 +990,11 @@ namespace bgfx
 			  "  -f <file path>                Input file path.\n"
 			  "  -i <include path>             Include path (for multiple paths use -i multiple times).\n"
 			  "  -o <file path>                Output file path.\n"
+			  "      --manifest <file path>    Compile all shaders listed in manifest file, one source per line:\n"
+			  "                                  <type> <input> <defines|-> <platform>:<profile>=<output> ...\n"
+			  "      --threads <num>           Number of worker threads in manifest mode (default 4).\n"
 			  "      --bin2c [array name]      Generate C header file. If array name is not specified base file name will be used as name.\n"
+			  "      --cache <dir>             Reuse compiled shader when preprocessed source, profile and options match earlier compile.\n"
 			  "      --depends                 Generate makefile style depends file.\n"
 			  "      --platform <platform>     Target platform.\n"
 			  "           android\n"
@@ -1020,6 +1043,10 @@ namespace bgfx
 			  "  -O <level>                    Optimization level (0, 1, 2, 3).\n"
 			  "      --Werror                  Treat warnings as errors.\n"
 
+			  "\n"
+			  "Variants:\n"
+			  "  Shader source can declare variants with '$variant <name> [count]'. All combinations of\n"
+			  "  values are compiled into single binary, and selected at runtime by variant key.\n"
 			  "\n"
 			  "For additional information, see https://github.com/bkaradzic/bgfx\n"
 			);
@@ -1032,7 +1059,200 @@ namespace bgfx
 		return word;
 	}
 
-	bool compileShader(const char* _varying, const char* _comment, char* _shader, uint32_t _shaderLen, Options& _options, bx::FileWriter* _writer)
+	class BufferWriter : public bx::WriterI
+	{
+	public:
+		virtual ~BufferWriter()
+		{
+		}
+
+		virtual int32_t write(const void* _data, int32_t _size, bx::Error*) override
+		{
+			const uint8_t* data = (const uint8_t*)_data;
+			m_buffer.insert(m_buffer.end(), data, data+_size);
+			return _size;
+		}
+
+		std::vector<uint8_t> m_buffer;
+	};
+
+	static uint32_t s_cacheHits;
+	static uint32_t s_cacheMisses;
+	static uint32_t s_cacheTempIdx;
+
+	// Cache entry stores full key next to backend output, so that hash collision can't
+	// return wrong shader.
+	static bool cacheRead(const char* _filePath, const std::string& _key, std::vector<uint8_t>& _outData)
+	{
+		bx::FileReader reader;
+		if (!bx::open(&reader, _filePath) )
+		{
+			return false;
+		}
+
+		bool result = false;
+
+		uint32_t magic   = 0;
+		uint32_t keySize = 0;
+		bx::read(&reader, magic);
+		bx::read(&reader, keySize);
+
+		if (SHADERC_CACHE_MAGIC == magic
+		&&  uint32_t(_key.size() ) == keySize)
+		{
+			std::string key;
+			key.resize(keySize);
+			bx::read(&reader, &key[0], keySize);
+
+			if (key == _key)
+			{
+				uint32_t size = 0;
+				bx::read(&reader, size);
+				_outData.resize(size);
+				result = 0 == size
+					|| int32_t(size) == bx::read(&reader, _outData.data(), size)
+					;
+			}
+		}
+
+		bx::close(&reader);
+
+		return result;
+	}
+
+	static void cacheWrite(const char* _filePath, const std::string& _key, const std::vector<uint8_t>& _data)
+	{
+		// Entry is written to temporary file first, and renamed, so that concurrent shaderc
+		// processes never observe partially written entry.
+		char temp[bx::kMaxFilePath];
+		bx::snprintf(temp, BX_COUNTOF(temp), "%s.%x.%d.tmp"
+			, _filePath
+			, uint32_t(bx::getHPCounter() )
+			, bx::atomicFetchAndAdd<uint32_t>(&s_cacheTempIdx, 1)
+			);
+
+		bx::FileWriter writer;
+		if (bx::open(&writer, temp) )
+		{
+			bx::write(&writer, SHADERC_CACHE_MAGIC);
+			bx::write(&writer, uint32_t(_key.size() ) );
+			bx::write(&writer, _key.c_str(), int32_t(_key.size() ) );
+			bx::write(&writer, uint32_t(_data.size() ) );
+			bx::write(&writer, _data.data(), int32_t(_data.size() ) );
+			bx::close(&writer);
+
+			if (0 != rename(temp, _filePath) )
+			{
+				bx::remove(temp);
+			}
+		}
+	}
+
+	typedef bool (*CompileFn)(const Options& _options, uint32_t _version, const std::string& _code, bx::WriterI* _writer);
+
+	// Runs backend, or when --cache is used, returns output of earlier compile with the same
+	// preprocessed source, profile, options and shaderc version.
+	static bool compileCached(CompileFn _fn, const Options& _options, uint32_t _version, const std::string& _code, const char* _comment, bx::WriterI* _writer)
+	{
+		// Cache stores only what backend writes into shader binary. Disassembly and
+		// intermediate files written next to output require backend to run.
+		const bool sideFiles = false
+			|| _options.keepIntermediate
+			|| (_options.disasm && (_fn == compileGLSLShader || _fn == compileHLSLShader) )
+			;
+
+		if (_options.cacheDir.empty()
+		||  sideFiles)
+		{
+			return _fn(_options, _version, _code, _writer);
+		}
+
+		std::string key;
+		bx::stringPrintf(key
+			, "shaderc %d.%d.%d, bin %d\n"
+			  "%s %s %c %08x O%d %d%d%d%d%d%d%d%d%d\n"
+			, BGFX_SHADERC_VERSION_MAJOR
+			, BGFX_SHADERC_VERSION_MINOR
+			, BGFX_API_VERSION
+			, BGFX_SHADER_BIN_VERSION
+			, _options.platform.c_str()
+			, _options.profile.c_str()
+			, _options.shaderType
+			, _version
+			, _options.optimize ? int32_t(_options.optimizationLevel) : -1
+			, _options.disasm
+			, _options.raw
+			, _options.debugInformation
+			, _options.avoidFlowControl
+			, _options.noPreshader
+			, _options.partialPrecision
+			, _options.preferFlowControl
+			, _options.backwardsCompatibility
+			, _options.warningsAreErrors
+			);
+
+		// Command line comment doesn't change compiled shader, unless debug information
+		// embeds source.
+		const size_t comment = _options.debugInformation
+			? std::string::npos
+			: _code.find(_comment)
+			;
+
+		if (std::string::npos == comment)
+		{
+			key += _code;
+		}
+		else
+		{
+			key.append(_code, 0, comment);
+			key.append(_code, comment + bx::strLen(_comment), std::string::npos);
+		}
+
+		std::string filePath;
+		bx::stringPrintf(filePath, "%s/%08x%08x"
+			, _options.cacheDir.c_str()
+			, bx::hash<bx::HashMurmur2A>(key.c_str(), uint32_t(key.size() ) )
+			, bx::hash<bx::HashCrc32>(key.c_str(), uint32_t(key.size() ) )
+			);
+
+		BufferWriter buffer;
+
+		if (cacheRead(filePath.c_str(), key, buffer.m_buffer) )
+		{
+			bx::atomicFetchAndAdd<uint32_t>(&s_cacheHits, 1);
+			BX_TRACE("Cache hit %s.", filePath.c_str() );
+
+			bx::write(_writer, buffer.m_buffer.data(), int32_t(buffer.m_buffer.size() ) );
+			return true;
+		}
+
+		bx::atomicFetchAndAdd<uint32_t>(&s_cacheMisses, 1);
+
+		const bool compiled = _fn(_options, _version, _code, &buffer);
+		bx::write(_writer, buffer.m_buffer.data(), int32_t(buffer.m_buffer.size() ) );
+
+		if (compiled)
+		{
+			cacheWrite(filePath.c_str(), key, buffer.m_buffer);
+		}
+
+		return compiled;
+	}
+
+	static void printCacheStats(const Options& _options)
+	{
+		if (g_verbose
+		&&  !_options.cacheDir.empty() )
+		{
+			bx::printf("Cache '%s': %d hit(s), %d miss(es).\n"
+				, _options.cacheDir.c_str()
+				, s_cacheHits
+				, s_cacheMisses
+				);
+		}
+	}
+
+	bool compileShader(const char* _varying, const char* _comment, char* _shader, uint32_t _shaderLen, Options& _options, bx::WriterI* _writer)
 	{
 		uint32_t profile_id = 0;
 
@@ -1464,19 +1684,19 @@ namespace bgfx
 			}
 			else if (profile->lang == ShadingLang::Metal)
 			{
-				compiled = compileMetalShader(_options, BX_MAKEFOURCC('M', 'T', 'L', 0), input, _writer);
+				compiled = compileCached(compileMetalShader, _options, BX_MAKEFOURCC('M', 'T', 'L', 0), input, _comment, _writer);
 			}
 			else if (profile->lang == ShadingLang::SpirV)
 			{
-				compiled = compileSPIRVShader(_options, profile->id, input, _writer);
+				compiled = compileCached(compileSPIRVShader, _options, profile->id, input, _comment, _writer);
 			}
 			else if (profile->lang == ShadingLang::PSSL)
 			{
-				compiled = compilePSSLShader(_options, 0, input, _writer);
+				compiled = compileCached(compilePSSLShader, _options, 0, input, _comment, _writer);
 			}
 			else
 			{
-				compiled = compileHLSLShader(_options, profile->id, input, _writer);
+				compiled = compileCached(compileHLSLShader, _options, profile->id, input, _comment, _writer);
 			}
 		}
 		else if ('c' == _options.shaderType) // Compute
@@ -1619,19 +1839,19 @@ namespace bgfx
 
 							if (profile->lang == ShadingLang::Metal)
 							{
-								compiled = compileMetalShader(_options, BX_MAKEFOURCC('M', 'T', 'L', 0), code, _writer);
+								compiled = compileCached(compileMetalShader, _options, BX_MAKEFOURCC('M', 'T', 'L', 0), code, _comment, _writer);
 							}
 							else if (profile->lang == ShadingLang::SpirV)
 							{
-								compiled = compileSPIRVShader(_options, profile->id, code, _writer);
+								compiled = compileCached(compileSPIRVShader, _options, profile->id, code, _comment, _writer);
 							}
 							else if (profile->lang == ShadingLang::PSSL)
 							{
-								compiled = compilePSSLShader(_options, 0, code, _writer);
+								compiled = compileCached(compilePSSLShader, _options, 0, code, _comment, _writer);
 							}
 							else
 							{
-								compiled = compileHLSLShader(_options, profile->id, code, _writer);
+								compiled = compileCached(compileHLSLShader, _options, profile->id, code, _comment, _writer);
 							}
 						}
 					}
@@ -1840,15 +2060,15 @@ namespace bgfx
 
 							if (profile->lang == ShadingLang::SpirV)
 							{
-								compiled = compileSPIRVShader(_options, profile->id, code, _writer);
+								compiled = compileCached(compileSPIRVShader, _options, profile->id, code, _comment, _writer);
 							}
 							else if(profile->lang == ShadingLang::PSSL)
 							{
-								compiled = compilePSSLShader(_options, 0, code, _writer);
+								compiled = compileCached(compilePSSLShader, _options, 0, code, _comment, _writer);
 							}
 							else
 							{
-								compiled = compileHLSLShader(_options, profile->id, code, _writer);
+								compiled = compileCached(compileHLSLShader, _options, profile->id, code, _comment, _writer);
 							}
                         }
                     }
@@ -2672,7 +2892,7 @@ namespace bgfx
 									glsl_profile |= 0x80000000;
 								}
 
-								compiled = compileGLSLShader(_options, glsl_profile, code, _writer);
+								compiled = compileCached(compileGLSLShader, _options, glsl_profile, code, _comment, _writer);
 							}
 						}
 						else
@@ -2682,19 +2902,19 @@ namespace bgfx
 
 							if (profile->lang == ShadingLang::Metal)
 							{
-								compiled = compileMetalShader(_options, BX_MAKEFOURCC('M', 'T', 'L', 0), code, _writer);
+								compiled = compileCached(compileMetalShader, _options, BX_MAKEFOURCC('M', 'T', 'L', 0), code, _comment, _writer);
 							}
 							else if (profile->lang == ShadingLang::SpirV)
 							{
-								compiled = compileSPIRVShader(_options, profile->id, code, _writer);
+								compiled = compileCached(compileSPIRVShader, _options, profile->id, code, _comment, _writer);
 							}
 							else if (profile->lang == ShadingLang::PSSL)
 							{
-								compiled = compilePSSLShader(_options, 0, code, _writer);
+								compiled = compileCached(compilePSSLShader, _options, 0, code, _comment, _writer);
 							}
 							else
 							{
-								compiled = compileHLSLShader(_options, profile->id, code, _writer);
+								compiled = compileCached(compileHLSLShader, _options, profile->id, code, _comment, _writer);
 							}
 						}
 					}
@@ -2721,6 +2941,182 @@ namespace bgfx
 		return compiled;
 	}
 
+	constexpr uint32_t kMaxVariants = 1024;
+
+	struct VariantAxis
+	{
+		std::string name;
+		uint32_t    count;
+		uint32_t    shift;
+	};
+
+	typedef std::vector<VariantAxis> VariantAxisArray;
+
+	// Parses `$variant <name> [count]` declarations. Each declaration adds axis, and all
+	// combinations of axis values are compiled with <name> defined to value in range
+	// [0, count). Count defaults to 2 (keyword, 0 or 1). Variant key packs axis values as
+	// bit fields in declaration order, starting from least significant bit.
+	static bool parseVariants(VariantAxisArray& _outAxes, const char* _shader)
+	{
+		uint32_t shift       = 0;
+		uint32_t numVariants = 1;
+
+		for (bx::StringView parse(_shader); !parse.isEmpty(); )
+		{
+			const bx::StringView eol = bx::strFindEol(parse);
+			bx::StringView str = bx::strLTrimSpace(bx::StringView(parse.getPtr(), eol.getPtr() ) );
+			parse = bx::strFindNl(bx::StringView(eol.getPtr(), parse.getTerm() ) );
+
+			if (str.getLength() <= 8
+			||  0 != bx::strCmp(str, "$variant", 8)
+			||  !bx::isSpace(str.getPtr()[8]) )
+			{
+				continue;
+			}
+
+			str = bx::StringView(str.getPtr() + 8, str.getTerm() );
+			const bx::StringView name  = nextWord(str);
+			const bx::StringView count = nextWord(str);
+
+			VariantAxis axis;
+			axis.name.assign(name.getPtr(), name.getTerm() );
+			axis.count = 2;
+			axis.shift = shift;
+
+			int32_t value = 2;
+			if (name.isEmpty()
+			|| (!count.isEmpty() && (!bx::fromString(&value, count) || value < 2) ) )
+			{
+				bx::printf("Invalid variant declaration, expected '$variant <name> [count]', where count is at least 2.\n");
+				return false;
+			}
+
+			axis.count = uint32_t(value);
+
+			if (axis.count > kMaxVariants/numVariants)
+			{
+				bx::printf("Too many shader variants (max %d).\n", kMaxVariants);
+				return false;
+			}
+
+			numVariants *= axis.count;
+
+			while ( (1u << (shift - axis.shift) ) < axis.count)
+			{
+				++shift;
+			}
+
+			_outAxes.push_back(axis);
+		}
+
+		return true;
+	}
+
+	// Compiles all variants declared in shader source into single binary: variant table,
+	// followed by regular shader binaries of all variants, in order of ascending key.
+	// Sources without variant declarations compile into regular shader binary.
+	static bool compileVariants(const char* _varying, const char* _comment, char* _shader, uint32_t _shaderLen, Options& _options, bx::WriterI* _writer)
+	{
+		VariantAxisArray axes;
+		if (!parseVariants(axes, _shader) )
+		{
+			delete [] _shader;
+			return false;
+		}
+
+		if (axes.empty() )
+		{
+			return compileShader(_varying, _comment, _shader, _shaderLen, _options, _writer);
+		}
+
+		struct Variant
+		{
+			uint32_t key;
+			uint32_t offset;
+			uint32_t size;
+		};
+
+		std::vector<Variant> variants;
+		BufferWriter data;
+
+		uint32_t numVariants = 1;
+		for (uint32_t ii = 0, num = uint32_t(axes.size() ); ii < num; ++ii)
+		{
+			numVariants *= axes[ii].count;
+		}
+
+		// Callers allocate source with zero padding after it, compileShader takes ownership
+		// of source, so each variant gets its own copy.
+		const size_t padding = 16384;
+
+		bool compiled = true;
+
+		for (uint32_t ii = 0; ii < numVariants && compiled; ++ii)
+		{
+			Options options = _options;
+
+			Variant variant;
+			variant.key    = 0;
+			variant.offset = uint32_t(data.m_buffer.size() );
+
+			for (uint32_t jj = 0, num = uint32_t(axes.size() ), idx = ii; jj < num; ++jj)
+			{
+				const VariantAxis& axis = axes[jj];
+				const uint32_t value = idx % axis.count;
+				idx /= axis.count;
+
+				variant.key |= value << axis.shift;
+
+				char define[256];
+				bx::snprintf(define, BX_COUNTOF(define), "%s=%d", axis.name.c_str(), value);
+				options.defines.push_back(define);
+			}
+
+			char* shader = new char[_shaderLen+padding+1];
+			bx::memCopy(shader, _shader, _shaderLen+padding+1);
+
+			compiled = compileShader(_varying, _comment, shader, _shaderLen, options, &data);
+
+			variant.size = uint32_t(data.m_buffer.size() ) - variant.offset;
+			variants.push_back(variant);
+
+			if (!compiled)
+			{
+				bx::printf("Failed to build shader variant 0x%08x.\n", variant.key);
+			}
+		}
+
+		delete [] _shader;
+
+		if (compiled)
+		{
+			uint32_t keyMask = 0;
+			for (uint32_t ii = 0; ii < numVariants; ++ii)
+			{
+				keyMask |= variants[ii].key;
+			}
+
+			const uint32_t headerSize = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint16_t) + numVariants*sizeof(Variant);
+
+			bx::write(_writer, BGFX_CHUNK_MAGIC_SVR);
+			bx::write(_writer, keyMask);
+			bx::write(_writer, uint16_t(numVariants) );
+
+			for (uint32_t ii = 0; ii < numVariants; ++ii)
+			{
+				bx::write(_writer, variants[ii].key);
+				bx::write(_writer, headerSize + variants[ii].offset);
+				bx::write(_writer, variants[ii].size);
+			}
+
+			bx::write(_writer, data.m_buffer.data(), int32_t(data.m_buffer.size() ) );
+
+			BX_TRACE("Compiled %d variants, key mask 0x%08x.", numVariants, keyMask);
+		}
+
+		return compiled;
+	}
+
 	char     _shaderErrorBuffer[UINT16_MAX];
 	uint16_t _shaderErrorBufferPos = 0;
 
@@ -2738,6 +3134,374 @@ namespace bgfx
 		_outputSize = _shaderErrorBufferPos;
 	}
 
+	static void parseDefines(std::vector<std::string>& _outDefines, const char* _defines)
+	{
+		while (NULL != _defines
+		&&    '\0'  != *_defines)
+		{
+			_defines = bx::strLTrimSpace(_defines).getPtr();
+			bx::StringView eol = bx::strFind(_defines, ';');
+			std::string define(_defines, eol.getPtr() );
+			_outDefines.push_back(define.c_str() );
+			_defines = ';' == *eol.getPtr() ? eol.getPtr()+1 : eol.getPtr();
+		}
+	}
+
+	// Options shared by single shader and manifest mode.
+	static void parseOptions(Options& _options, const bx::CommandLine& _cmdLine)
+	{
+		_options.disasm = _cmdLine.hasArg('\0', "disasm");
+
+		const char* platform = _cmdLine.findOption('\0', "platform");
+		if (NULL == platform)
+		{
+			platform = "";
+		}
+
+		_options.platform = platform;
+
+		_options.raw = _cmdLine.hasArg('\0', "raw");
+
+		const char* profile = _cmdLine.findOption('p', "profile");
+
+		if ( NULL != profile)
+		{
+			_options.profile = profile;
+		}
+
+		{
+			_options.debugInformation       = _cmdLine.hasArg('\0', "debug");
+			_options.avoidFlowControl       = _cmdLine.hasArg('\0', "avoid-flow-control");
+			_options.noPreshader            = _cmdLine.hasArg('\0', "no-preshader");
+			_options.partialPrecision       = _cmdLine.hasArg('\0', "partial-precision");
+			_options.preferFlowControl      = _cmdLine.hasArg('\0', "prefer-flow-control");
+			_options.backwardsCompatibility = _cmdLine.hasArg('\0', "backwards-compatibility");
+			_options.warningsAreErrors      = _cmdLine.hasArg('\0', "Werror");
+			_options.keepIntermediate       = _cmdLine.hasArg('\0', "keep-intermediate");
+
+			uint32_t optimization = 3;
+			if (_cmdLine.hasArg(optimization, 'O') )
+			{
+				_options.optimize = true;
+				_options.optimizationLevel = optimization;
+			}
+		}
+
+		const char* cacheDir = _cmdLine.findOption("cache");
+		if (NULL != cacheDir)
+		{
+			_options.cacheDir = cacheDir;
+			bx::makeAll(cacheDir);
+		}
+
+		_options.depends = _cmdLine.hasArg("depends");
+		_options.preprocessOnly = _cmdLine.hasArg("preprocess");
+		const char* includeDir = _cmdLine.findOption('i');
+
+		BX_TRACE("depends: %d", _options.depends);
+		BX_TRACE("preprocessOnly: %d", _options.preprocessOnly);
+		BX_TRACE("includeDir: %s", includeDir);
+
+		for (int ii = 1; NULL != includeDir; ++ii)
+		{
+			_options.includeDirs.push_back(includeDir);
+			includeDir = _cmdLine.findOption(ii, 'i');
+		}
+
+		parseDefines(_options.defines, _cmdLine.findOption("define") );
+	}
+
+	constexpr uint32_t kManifestMaxThreads = 32;
+
+	typedef std::unordered_map<std::string, File*> FileMap;
+
+	static const File* findOrLoad(FileMap& _files, const std::string& _filePath)
+	{
+		FileMap::const_iterator it = _files.find(_filePath);
+		if (it != _files.end() )
+		{
+			return it->second;
+		}
+
+		File* file = new File;
+		file->load(_filePath.c_str() );
+		_files.insert(std::make_pair(_filePath, file) );
+
+		return file;
+	}
+
+	static bx::StringView nextToken(bx::StringView& _parse)
+	{
+		const bx::StringView str = bx::strLTrimSpace(_parse);
+
+		const char* ptr = str.getPtr();
+		for (; ptr != str.getTerm() && !bx::isSpace(*ptr); ++ptr)
+		{
+		}
+
+		_parse = bx::StringView(ptr, str.getTerm() );
+		return bx::StringView(str.getPtr(), ptr);
+	}
+
+	struct ManifestJob
+	{
+		Options     options;
+		std::string comment;
+		const File* shader;
+		const char* varying;
+		bool        compiled;
+	};
+
+	typedef std::vector<ManifestJob> ManifestJobArray;
+
+	struct ManifestJobList
+	{
+		ManifestJob* m_jobs;
+		uint32_t     m_num;
+		uint32_t     m_next;
+	};
+
+	static void compileManifestJob(ManifestJob& _job)
+	{
+		// compileShader takes ownership of shader source, each job gets its own copy of
+		// source that was read once for all targets.
+		const size_t padding = 16384;
+		uint32_t size = _job.shader->getSize();
+		char* data = new char[size+padding+1];
+		bx::memCopy(data, _job.shader->getData(), size);
+
+		// Compiler generates "error X3000: syntax error: unexpected end of file"
+		// if input doesn't have empty line at EOF.
+		data[size] = '\n';
+		bx::memSet(&data[size+1], 0, padding);
+
+		const char* outFilePath = _job.options.outputFilePath.c_str();
+
+		bx::FileWriter writer;
+		if (!bx::open(&writer, outFilePath) )
+		{
+			bx::printf("Unable to open output file '%s'.\n", outFilePath);
+			delete [] data;
+			return;
+		}
+
+		_job.compiled = compileVariants(_job.varying, _job.comment.c_str(), data, size, _job.options, &writer);
+
+		bx::close(&writer);
+
+		if (!_job.compiled)
+		{
+			bx::remove(outFilePath);
+			bx::printf("Failed to build shader '%s'.\n", outFilePath);
+		}
+	}
+
+	static int32_t manifestThread(bx::Thread* _self, void* _userData)
+	{
+		BX_UNUSED(_self);
+
+		ManifestJobList& list = *(ManifestJobList*)_userData;
+
+		for (uint32_t idx = bx::atomicFetchAndAdd<uint32_t>(&list.m_next, 1); idx < list.m_num; idx = bx::atomicFetchAndAdd<uint32_t>(&list.m_next, 1) )
+		{
+			compileManifestJob(list.m_jobs[idx]);
+		}
+
+		return bx::kExitSuccess;
+	}
+
+	// Compiles all shaders listed in manifest file in a single process. Each line that is not
+	// empty, or comment starting with '#', lists one shader source and its targets:
+	//
+	//   <type> <input file> <defines|-> <platform>:<profile>=<output file> ...
+	//
+	// Other options (-i, -O, --depends, --varyingdef, ...) are taken from command line and
+	// apply to all shaders. Shader source and varying.def.sc are read once, glslang built-in
+	// symbol tables are kept alive across shaders, and targets are compiled in parallel.
+	static int compileManifest(const char* _filePath, const bx::CommandLine& _cmdLine)
+	{
+		File manifest;
+		manifest.load(_filePath);
+
+		if (NULL == manifest.getData() )
+		{
+			bx::printf("Unable to open manifest file '%s'.\n", _filePath);
+			return bx::kExitFailure;
+		}
+
+		Options base;
+		parseOptions(base, _cmdLine);
+
+		const char* varyingdef = _cmdLine.findOption("varyingdef");
+
+		FileMap files;
+		ManifestJobArray jobs;
+
+		bool valid = true;
+		int32_t line = 0;
+
+		for (bx::StringView parse(manifest.getData() ); !parse.isEmpty(); ++line)
+		{
+			const bx::StringView eol = bx::strFindEol(parse);
+			bx::StringView str = bx::strLTrimSpace(bx::StringView(parse.getPtr(), eol.getPtr() ) );
+			parse = bx::strFindNl(bx::StringView(eol.getPtr(), parse.getTerm() ) );
+
+			if (str.isEmpty()
+			||  '#' == *str.getPtr() )
+			{
+				continue;
+			}
+
+			const bx::StringView type    = nextToken(str);
+			const bx::StringView input   = nextToken(str);
+			const bx::StringView defines = nextToken(str);
+
+			if (defines.isEmpty() )
+			{
+				bx::printf("%s(%d): Expected '<type> <input file> <defines|-> <platform>:<profile>=<output file> ...'.\n"
+					, _filePath
+					, line+1
+					);
+				valid = false;
+				continue;
+			}
+
+			ManifestJob job;
+			job.options = base;
+			job.options.shaderType = bx::toLower(*type.getPtr() );
+			job.options.inputFilePath.assign(input.getPtr(), input.getTerm() );
+			job.compiled = false;
+
+			if (0 != bx::strCmp(defines, "-") )
+			{
+				const std::string temp(defines.getPtr(), defines.getTerm() );
+				parseDefines(job.options.defines, temp.c_str() );
+			}
+
+			std::string dir;
+			{
+				bx::FilePath fp(job.options.inputFilePath.c_str() );
+				bx::StringView path(fp.getPath() );
+
+				dir.assign(path.getPtr(), path.getTerm() );
+				job.options.includeDirs.push_back(dir);
+			}
+
+			job.shader = findOrLoad(files, job.options.inputFilePath);
+			if (NULL == job.shader->getData() )
+			{
+				bx::printf("%s(%d): Unable to open file '%s'.\n", _filePath, line+1, job.options.inputFilePath.c_str() );
+				valid = false;
+				continue;
+			}
+
+			job.varying = NULL;
+			if ('c' != job.options.shaderType)
+			{
+				const std::string varyingFilePath = NULL != varyingdef ? varyingdef : dir + "varying.def.sc";
+				job.varying = findOrLoad(files, varyingFilePath)->getData();
+				if (NULL         != job.varying
+				&&  *job.varying != '\0')
+				{
+					job.options.dependencies.push_back(varyingFilePath);
+				}
+				else
+				{
+					bx::printf("ERROR: Failed to parse varying def file: \"%s\" No input/output semantics will be generated in the code!\n", varyingFilePath.c_str() );
+				}
+			}
+
+			bx::stringPrintf(job.comment, "// shaderc manifest: %s(%d)\n\n", _filePath, line+1);
+
+			for (bx::StringView target = nextToken(str); !target.isEmpty(); target = nextToken(str) )
+			{
+				const bx::StringView colon  = bx::strFind(target, ':');
+				const bx::StringView assign = bx::strFind(target, '=');
+
+				if (colon.isEmpty()
+				||  assign.isEmpty()
+				||  assign.getPtr() < colon.getPtr()
+				||  assign.getPtr()+1 == target.getTerm() )
+				{
+					bx::printf("%s(%d): Invalid target '%.*s', expected '<platform>:<profile>=<output file>'.\n"
+						, _filePath
+						, line+1
+						, target.getLength()
+						, target.getPtr()
+						);
+					valid = false;
+					continue;
+				}
+
+				jobs.push_back(job);
+
+				Options& options = jobs.back().options;
+				options.platform.assign(target.getPtr(), colon.getPtr() );
+				options.profile.assign(colon.getPtr()+1, assign.getPtr() );
+				options.outputFilePath.assign(assign.getPtr()+1, target.getTerm() );
+			}
+		}
+
+		uint32_t numFailed = 0;
+
+		if (valid)
+		{
+			uint32_t numThreads = 4;
+			_cmdLine.hasArg(numThreads, '\0', "threads");
+			numThreads = bx::min(bx::clamp<uint32_t>(numThreads, 1, kManifestMaxThreads), uint32_t(jobs.size() ) );
+
+			ManifestJobList list;
+			list.m_jobs = jobs.data();
+			list.m_num  = uint32_t(jobs.size() );
+			list.m_next = 0;
+
+			// Holding process reference keeps built-in symbol tables that glslang otherwise
+			// rebuilds for every SPIR-V and Metal shader.
+			initGlslang();
+
+			bx::Thread thread[kManifestMaxThreads];
+
+			for (uint32_t ii = 1; ii < numThreads; ++ii)
+			{
+				thread[ii].init(manifestThread, &list, 0, "shaderc - job");
+			}
+
+			manifestThread(NULL, &list);
+
+			for (uint32_t ii = 1; ii < numThreads; ++ii)
+			{
+				if (thread[ii].isRunning() )
+				{
+					thread[ii].shutdown();
+				}
+			}
+
+			shutdownGlslang();
+
+			for (uint32_t ii = 0, num = uint32_t(jobs.size() ); ii < num; ++ii)
+			{
+				numFailed += !jobs[ii].compiled;
+			}
+
+			BX_TRACE("Compiled %d shaders on %d threads, %d failed.", uint32_t(jobs.size() ), numThreads, numFailed);
+			printCacheStats(base);
+		}
+
+		for (FileMap::iterator it = files.begin(), itEnd = files.end(); it != itEnd; ++it)
+		{
+			delete it->second;
+		}
+
+		if (valid
+		&&  0 == numFailed)
+		{
+			return bx::kExitSuccess;
+		}
+
+		bx::printf("Failed to build %d of %d shaders.\n", numFailed, uint32_t(jobs.size() ) );
+		return bx::kExitFailure;
+	}
+
 	int compileShader(int _argc, const char* _argv[])
 	{
 		bx::CommandLine cmdLine(_argc, _argv);
@@ -2761,6 +3525,12 @@ namespace bgfx
 
 		g_verbose = cmdLine.hasArg("verbose");
 
+		const char* manifest = cmdLine.findOption("manifest");
+		if (NULL != manifest)
+		{
+			return compileManifest(manifest, cmdLine);
+		}
+
 		const char* filePath = cmdLine.findOption('f');
 		if (NULL == filePath)
 		{
@@ -2787,42 +3557,7 @@ namespace bgfx
 		options.outputFilePath = outFilePath;
 		options.shaderType = bx::toLower(type[0]);
 
-		options.disasm = cmdLine.hasArg('\0', "disasm");
-
-		const char* platform = cmdLine.findOption('\0', "platform");
-		if (NULL == platform)
-		{
-			platform = "";
-		}
-
-		options.platform = platform;
-
-		options.raw = cmdLine.hasArg('\0', "raw");
-
-		const char* profile = cmdLine.findOption('p', "profile");
-
-		if ( NULL != profile)
-		{
-			options.profile = profile;
-		}
-
-		{
-			options.debugInformation       = cmdLine.hasArg('\0', "debug");
-			options.avoidFlowControl       = cmdLine.hasArg('\0', "avoid-flow-control");
-			options.noPreshader            = cmdLine.hasArg('\0', "no-preshader");
-			options.partialPrecision       = cmdLine.hasArg('\0', "partial-precision");
-			options.preferFlowControl      = cmdLine.hasArg('\0', "prefer-flow-control");
-			options.backwardsCompatibility = cmdLine.hasArg('\0', "backwards-compatibility");
-			options.warningsAreErrors      = cmdLine.hasArg('\0', "Werror");
-			options.keepIntermediate       = cmdLine.hasArg('\0', "keep-intermediate");
-
-			uint32_t optimization = 3;
-			if (cmdLine.hasArg(optimization, 'O') )
-			{
-				options.optimize = true;
-				options.optimizationLevel = optimization;
-			}
-		}
+		parseOptions(options, cmdLine);
 
 		bx::StringView bin2c;
 		if (cmdLine.hasArg("bin2c") )
@@ -2858,20 +3593,6 @@ namespace bgfx
 			}
 		}
 
-		options.depends = cmdLine.hasArg("depends");
-		options.preprocessOnly = cmdLine.hasArg("preprocess");
-		const char* includeDir = cmdLine.findOption('i');
-
-		BX_TRACE("depends: %d", options.depends);
-		BX_TRACE("preprocessOnly: %d", options.preprocessOnly);
-		BX_TRACE("includeDir: %s", includeDir);
-
-		for (int ii = 1; NULL != includeDir; ++ii)
-		{
-			options.includeDirs.push_back(includeDir);
-			includeDir = cmdLine.findOption(ii, 'i');
-		}
-
 		std::string dir;
 		{
 			bx::FilePath fp(filePath);
@@ -2881,17 +3602,6 @@ namespace bgfx
 			options.includeDirs.push_back(dir);
 		}
 
-		const char* defines = cmdLine.findOption("define");
-		while (NULL != defines
-		&&    '\0'  != *defines)
-		{
-			defines = bx::strLTrimSpace(defines).getPtr();
-			bx::StringView eol = bx::strFind(defines, ';');
-			std::string define(defines, eol.getPtr() );
-			options.defines.push_back(define.c_str() );
-			defines = ';' == *eol.getPtr() ? eol.getPtr()+1 : eol.getPtr();
-		}
-
 		std::string commandLineComment = "// shaderc command line:\n//";
 		for (int32_t ii = 0, num = cmdLine.getNum(); ii < num; ++ii)
 		{
@@ -2965,12 +3675,14 @@ namespace bgfx
 				return bx::kExitFailure;
 			}
 
-			compiled = compileShader(varying, commandLineComment.c_str(), data, size, options, writer);
+			compiled = compileVariants(varying, commandLineComment.c_str(), data, size, options, writer);
 
 			bx::close(writer);
 			delete writer;
 		}
 
+		printCacheStats(options);
+
 		if (compiled)
 		{
 			return bx::kExitSuccess;
@@ -116,6 +116,7 @@ namespace bgfx
 
 		std::string	inputFilePath;
 		std::string	outputFilePath;
+		std::string	cacheDir;
 
 		std::vector<std::string> includeDirs;
 		std::vector<std::string> defines;
@@ -147,6 +148,10 @@ namespace bgfx
 	int32_t writef(bx::WriterI* _writer, const char* _format, ...);
 	void writeFile(const char* _filePath, const void* _data, int32_t _size);
 
+	// Writes uniform name hash and predefined uniform enum after uniform table entry, so
+	// that runtime doesn't need to hash or compare uniform names (shader binary version 12).
+	void writeUniformReflection(bx::WriterI* _writer, const Uniform& _uniform);
+
 	bool compileGLSLShader(const Options& _options, uint32_t _version, const std::string& _code, bx::WriterI* _writer);
 	bool compileHLSLShader(const Options& _options, uint32_t _version, const std::string& _code, bx::WriterI* _writer);
 	bool compileMetalShader(const Options& _options, uint32_t _version, const std::string& _code, bx::WriterI* _writer);
@@ -155,6 +160,11 @@ namespace bgfx
 
 	const char* getPsslPreamble();
 
+	// While glslang process reference is held, built-in symbol tables are shared by all SPIR-V
+	// and Metal compiles instead of being rebuilt for each shader.
+	bool initGlslang();
+	void shutdownGlslang();
+
 } // namespace bgfx
 
 #endif // SHADERC_H_HEADER_GUARD
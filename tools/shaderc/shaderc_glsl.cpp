@@ -5,6 +5,7 @@
 
 #include "shaderc.h"
 #include "glsl_optimizer.h"
+#include <bx/mutex.h>
 
 namespace bgfx { namespace glsl
 {
@@ -347,6 +348,7 @@ namespace bgfx { namespace glsl
 			bx::write(_writer, un.texComponent);
 			bx::write(_writer, un.texDimension);
 			bx::write(_writer, un.texFormat);
+			writeUniformReflection(_writer, un);
 
 			BX_TRACE("%s, %s, %d, %d, %d"
 				, un.name.c_str()
@@ -375,10 +377,15 @@ namespace bgfx { namespace glsl
 		return true;
 	}
 
+	// glslopt_cleanup destroys glsl-optimizer global type tables, compiles can't overlap when
+	// shaders are compiled in parallel (manifest mode).
+	static bx::Mutex s_mutex;
+
 } // namespace glsl
 
 	bool compileGLSLShader(const Options& _options, uint32_t _version, const std::string& _code, bx::WriterI* _writer)
 	{
+		bx::MutexScope scope(glsl::s_mutex);
 		return glsl::compile(_options, _version, _code, _writer);
 	}
 
@@ -16,6 +16,7 @@
 #define COM_NO_WINDOWS_H
 #include <d3dcompiler.h>
 #include <d3d11shader.h>
+#include <bx/mutex.h>
 #include <bx/os.h>
 
 #ifndef D3D_SVF_USED
@@ -749,6 +750,7 @@ namespace bgfx { namespace hlsl
 				bx::write(_writer, un.texComponent);
 				bx::write(_writer, un.texDimension);
 				bx::write(_writer, un.texFormat);
+				writeUniformReflection(_writer, un);
 
 				BX_TRACE("%s, %s, %d, %d, %d"
 					, un.name.c_str()
@@ -824,10 +826,15 @@ namespace bgfx { namespace hlsl
 		return result;
 	}
 
+	// D3DCompiler entry points are loaded and unloaded by every compile, compiles can't overlap
+	// when shaders are compiled in parallel (manifest mode).
+	static bx::Mutex s_mutex;
+
 } // namespace hlsl
 
 	bool compileHLSLShader(const Options& _options, uint32_t _version, const std::string& _code, bx::WriterI* _writer)
 	{
+		bx::MutexScope scope(hlsl::s_mutex);
 		return hlsl::compile(_options, _version, _code, _writer, true);
 	}
 
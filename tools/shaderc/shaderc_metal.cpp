@@ -240,6 +240,7 @@ namespace bgfx { namespace metal
 			bx::write(_writer, un.texComponent);
 			bx::write(_writer, un.texDimension);
 			bx::write(_writer, un.texFormat);
+			writeUniformReflection(_writer, un);
 
 			BX_TRACE("%s, %s, %d, %d, %d"
 				, un.name.c_str()
@@ -361,6 +361,7 @@ namespace bgfx { namespace spirv
 			bx::write(_writer, un.texComponent);
 			bx::write(_writer, un.texDimension);
 			bx::write(_writer, un.texFormat);
+			writeUniformReflection(_writer, un);
 
 			const char* kind = "invalid";
 
@@ -995,4 +996,14 @@ namespace bgfx { namespace spirv
 		return spirv::compile(_options, _version, _code, _writer, true);
 	}
 
+	bool initGlslang()
+	{
+		return glslang::InitializeProcess();
+	}
+
+	void shutdownGlslang()
+	{
+		glslang::FinalizeProcess();
+	}
+
 } // namespace bgfx